@@ -0,0 +1,105 @@
+#include "../src/EventData.hh"
+
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+
+// Measures latency of time to index lookups in EventData against dataset size.
+// Compares the sparse time index lookup with a full binary search over the mapped event buffer.
+// Usage: event_index_benchmark [max_events]
+
+namespace
+{
+
+constexpr std::size_t NUM_LOOKUPS{1 << 16};
+constexpr int64_t EVENT_PERIOD{3}; // Microseconds between events
+
+/**
+ * @brief Times a lookup function over a set of timestamps.
+ * @param timestamps timestamps to look up.
+ * @param lookup callable taking a timestamp and returning an index.
+ * @return mean latency of one lookup in nanoseconds.
+ */
+template <typename Lookup> double time_lookups(const std::vector<int64_t> &timestamps, Lookup &&lookup)
+{
+    int64_t checksum{0}; // Keeps the compiler from discarding lookups
+    auto start = std::chrono::steady_clock::now();
+    for (int64_t timestamp : timestamps)
+    {
+        checksum += lookup(timestamp);
+    }
+    auto end = std::chrono::steady_clock::now();
+    if (checksum == -1)
+    {
+        std::cout << "unexpected checksum\n";
+    }
+    return std::chrono::duration<double, std::nano>(end - start).count() / static_cast<double>(timestamps.size());
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    std::size_t max_events{static_cast<std::size_t>(1) << 24};
+    if (argc > 1)
+    {
+        max_events = std::strtoull(argv[1], nullptr, 10);
+    }
+
+    std::cout << std::setw(12) << "events" << std::setw(20) << "indexed (ns)" << std::setw(20) << "full search (ns)"
+              << '\n'
+              << std::fixed << std::setprecision(1);
+
+    std::mt19937_64 rng{42};
+    for (std::size_t num_events{static_cast<std::size_t>(1) << 16}; num_events <= max_events; num_events <<= 2)
+    {
+        EventData event_data{};
+        for (std::size_t i{0}; i < num_events; ++i)
+        {
+            EventData::EventDatum evt_datum{.x = static_cast<int32_t>(i % 640),
+                                            .y = static_cast<int32_t>(i % 480),
+                                            .timestamp = static_cast<int64_t>(i) * EVENT_PERIOD,
+                                            .polarity = static_cast<uint8_t>(i % 2)};
+            event_data.write_evt_data(evt_datum);
+        }
+
+        std::uniform_int_distribution<int64_t> dist{0, static_cast<int64_t>(num_events) * EVENT_PERIOD};
+        std::vector<int64_t> timestamps(NUM_LOOKUPS);
+        for (int64_t &timestamp : timestamps)
+        {
+            timestamp = dist(rng);
+        }
+
+        double indexed_ns = time_lookups(timestamps, [&](int64_t timestamp) {
+            return event_data.get_event_index_from_relative_timestamp(timestamp);
+        });
+
+        // Baseline, binary search of all stored events by their exact time
+        event_data.lock_data_vectors();
+        double full_ns = time_lookups(timestamps, [&](int64_t timestamp) {
+            std::size_t first{0};
+            std::size_t count{event_data.get_evt_count()};
+            while (count > 0)
+            {
+                std::size_t step{count / 2};
+                if (event_data.get_evt_relative_time(first + step) < timestamp)
+                {
+                    first += step + 1;
+                    count -= step + 1;
+                }
+                else
+                {
+                    count = step;
+                }
+            }
+            return static_cast<int64_t>(first);
+        });
+        event_data.unlock_data_vectors();
+
+        std::cout << std::setw(12) << num_events << std::setw(20) << indexed_ns << std::setw(20) << full_ns << '\n';
+    }
+
+    return 0;
+}
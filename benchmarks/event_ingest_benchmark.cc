@@ -0,0 +1,84 @@
+#include "../src/EventData.hh"
+
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+// Measures event ingest throughput of EventData.
+// Compares writing one event per call (write_evt_data) with writing camera sized batches (write_evt_data_batch).
+// Usage: event_ingest_benchmark [num_events]
+
+namespace
+{
+
+constexpr std::size_t BATCH_SIZE{1 << 13}; // Roughly one DVXplorer packet
+constexpr int64_t EVENT_PERIOD{1};         // Microseconds between events
+
+/**
+ * @brief Times writing events into a fresh EventData object.
+ * @param events events to write.
+ * @param format storage format of the EventData object.
+ * @param batched true to write BATCH_SIZE events per call, false to write one event per call.
+ * @return throughput in millions of events per second.
+ */
+double time_ingest(const std::vector<EventData::EventDatum> &events, EventData::EventFormat format, bool batched)
+{
+    EventData event_data{};
+    event_data.set_evt_format(format);
+
+    auto start = std::chrono::steady_clock::now();
+    if (batched)
+    {
+        for (std::size_t first{0}; first < events.size(); first += BATCH_SIZE)
+        {
+            std::size_t count{std::min(BATCH_SIZE, events.size() - first)};
+            event_data.write_evt_data_batch(std::span<const EventData::EventDatum>{events.data() + first, count});
+        }
+    }
+    else
+    {
+        for (const EventData::EventDatum &evt_datum : events)
+        {
+            event_data.write_evt_data(evt_datum);
+        }
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    return static_cast<double>(events.size()) / std::chrono::duration<double, std::micro>(end - start).count();
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    std::size_t num_events{static_cast<std::size_t>(1) << 24};
+    if (argc > 1)
+    {
+        num_events = std::strtoull(argv[1], nullptr, 10);
+    }
+
+    std::vector<EventData::EventDatum> events(num_events);
+    for (std::size_t i{0}; i < num_events; ++i)
+    {
+        events[i] = EventData::EventDatum{.x = static_cast<int32_t>(i % 640),
+                                          .y = static_cast<int32_t>(i % 480),
+                                          .timestamp = static_cast<int64_t>(i) * EVENT_PERIOD,
+                                          .polarity = static_cast<uint8_t>(i % 2)};
+    }
+
+    std::cout << std::setw(10) << "format" << std::setw(20) << "per event (Mev/s)" << std::setw(20)
+              << "batched (Mev/s)" << '\n'
+              << std::fixed << std::setprecision(1);
+
+    for (EventData::EventFormat format : {EventData::EventFormat::VEC4, EventData::EventFormat::PACKED})
+    {
+        double per_event{time_ingest(events, format, false)};
+        double batched{time_ingest(events, format, true)};
+        std::cout << std::setw(10) << (format == EventData::EventFormat::PACKED ? "packed" : "vec4")
+                  << std::setw(20) << per_event << std::setw(20) << batched << '\n';
+    }
+
+    return 0;
+}
@@ -0,0 +1,128 @@
+#include "../src/EventData.hh"
+
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+// Measures query throughput of the event storage layouts on the same events.
+// Time search: mean latency of a timestamp to index lookup.
+// Polarity and ROI scans: events per second tested by for_each_matching_evt.
+// Gather: events per second copied to the upload layout by copy_evts.
+// Usage: event_layout_benchmark [num_events]
+
+namespace
+{
+
+constexpr std::size_t NUM_LOOKUPS{1 << 16};
+constexpr int32_t WIDTH{640};
+constexpr int32_t HEIGHT{480};
+
+/**
+ * @brief Times a function and returns how long it took.
+ * @param fn callable to time.
+ * @return duration of the call in seconds.
+ */
+template <typename Fn> double time_seconds(Fn &&fn)
+{
+    auto start = std::chrono::steady_clock::now();
+    fn();
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double>(end - start).count();
+}
+
+/**
+ * @brief Gets a printable name of a storage format.
+ * @param format storage format.
+ * @return name of the format.
+ */
+std::string format_name(EventData::EventFormat format)
+{
+    switch (format)
+    {
+    case EventData::EventFormat::PACKED:
+        return "packed";
+    case EventData::EventFormat::COLUMNAR:
+        return "columnar";
+    default:
+        return "vec4";
+    }
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    std::size_t num_events{static_cast<std::size_t>(1) << 24};
+    if (argc > 1)
+    {
+        num_events = std::strtoull(argv[1], nullptr, 10);
+    }
+
+    // Random positions and polarities at a steady rate, like a busy scene
+    std::mt19937_64 rng{42};
+    std::uniform_int_distribution<int32_t> x_dist{0, WIDTH - 1};
+    std::uniform_int_distribution<int32_t> y_dist{0, HEIGHT - 1};
+    std::vector<EventData::EventDatum> evts(num_events);
+    for (std::size_t i{0}; i < num_events; ++i)
+    {
+        evts[i] = EventData::EventDatum{.x = x_dist(rng),
+                                        .y = y_dist(rng),
+                                        .timestamp = static_cast<int64_t>(i / 4),
+                                        .polarity = static_cast<uint8_t>(rng() & 1)};
+    }
+    std::uniform_int_distribution<int64_t> time_dist{0, static_cast<int64_t>(num_events / 4)};
+    std::vector<int64_t> timestamps(NUM_LOOKUPS);
+    for (int64_t &timestamp : timestamps)
+    {
+        timestamp = time_dist(rng);
+    }
+
+    const EventData::EventFilter polarity_filter{.roi = {.x = 0, .y = 0, .width = WIDTH, .height = HEIGHT},
+                                                 .polarity = 1};
+    const EventData::EventFilter roi_filter{.roi = {.x = WIDTH / 4, .y = HEIGHT / 4, .width = 64, .height = 48},
+                                            .polarity = -1};
+
+    std::cout << std::setw(10) << "layout" << std::setw(18) << "search (ns)" << std::setw(22) << "polarity (Mevt/s)"
+              << std::setw(18) << "roi (Mevt/s)" << std::setw(20) << "gather (Mevt/s)" << '\n'
+              << std::fixed << std::setprecision(1);
+
+    for (EventData::EventFormat format :
+         {EventData::EventFormat::VEC4, EventData::EventFormat::PACKED, EventData::EventFormat::COLUMNAR})
+    {
+        EventData event_data{};
+        event_data.set_evt_format(format);
+        event_data.write_evt_data_batch(evts);
+
+        std::size_t checksum{0}; // Keeps the compiler from discarding queries
+        double search_s = time_seconds([&] {
+            for (int64_t timestamp : timestamps)
+            {
+                checksum += static_cast<std::size_t>(event_data.get_event_index_from_relative_timestamp(timestamp));
+            }
+        });
+        double polarity_s = time_seconds([&] {
+            event_data.for_each_matching_evt(polarity_filter, 0, num_events, [&](std::size_t) { ++checksum; });
+        });
+        double roi_s = time_seconds([&] {
+            event_data.for_each_matching_evt(roi_filter, 0, num_events, [&](std::size_t) { ++checksum; });
+        });
+        std::vector<std::byte> upload(num_events * event_data.get_evt_element_size());
+        double gather_s = time_seconds([&] { event_data.copy_evts(0, num_events, 0, upload.data()); });
+        checksum += static_cast<std::size_t>(upload.back());
+        if (checksum == 0)
+        {
+            std::cout << "unexpected checksum\n";
+        }
+
+        const double mega_events{static_cast<double>(num_events) / 1e6};
+        std::cout << std::setw(10) << format_name(format) << std::setw(18)
+                  << search_s * 1e9 / static_cast<double>(NUM_LOOKUPS) << std::setw(22) << mega_events / polarity_s
+                  << std::setw(18) << mega_events / roi_s << std::setw(20) << mega_events / gather_s << '\n';
+    }
+
+    return 0;
+}
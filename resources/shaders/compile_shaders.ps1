@@ -17,6 +17,12 @@ if ($shaderFiles.Count -eq 0) {
 
 Write-Host "Found $($shaderFiles.Count) shader files to compile..." -ForegroundColor Cyan
 
+# Compiled modules are checked with spirv-val when it is installed (it comes with the Vulkan SDK)
+$spirvVal = Get-Command spirv-val -ErrorAction SilentlyContinue
+if (-not $spirvVal) {
+    Write-Host "spirv-val not found, compiled shaders will not be validated" -ForegroundColor Yellow
+}
+
 foreach ($shaderFile in $shaderFiles) {
     # Generate header filename with extension (e.g., spinning_cube.vert -> spinning_cube_vert.h)
     $extension = $shaderFile.Extension.TrimStart('.')
@@ -38,6 +44,19 @@ foreach ($shaderFile in $shaderFiles) {
         
         if ($LASTEXITCODE -eq 0) {
             Write-Host "  ✓ Successfully compiled $($shaderFile.Name)" -ForegroundColor Green
+
+            if ($spirvVal) {
+                # Validate the module the header holds, compiled again as a binary
+                $binaryPath = [System.IO.Path]::GetTempFileName()
+                glslang --target-env vulkan1.0 -o $binaryPath $shaderFile.FullName | Out-Null
+                spirv-val --target-env vulkan1.0 $binaryPath
+                if ($LASTEXITCODE -eq 0) {
+                    Write-Host "  ✓ Validated $($shaderFile.Name)" -ForegroundColor Green
+                } else {
+                    Write-Host "  ✗ spirv-val rejected $($shaderFile.Name)" -ForegroundColor Red
+                }
+                Remove-Item $binaryPath
+            }
         } else {
             Write-Host "  ✗ Failed to compile $($shaderFile.Name)" -ForegroundColor Red
             Write-Host "  glslang exited with code: $LASTEXITCODE" -ForegroundColor Red
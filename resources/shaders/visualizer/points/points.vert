@@ -1,6 +1,11 @@
 #version 450
 
-layout(location = 0) in vec4 aPos;
+// Events are fetched by vertex index, each event is either a vec4 (x, y, time, polarity)
+// or a packed 8 byte event (x | y << 16, time | polarity << 31)
+layout(std430, set = 0, binding = 0) readonly buffer EventBuffer
+{
+    uint data[];
+} event_buffer;
 
 layout(location = 0) out vec4 vColor;
 
@@ -10,10 +15,24 @@ layout(set = 1, binding = 0) uniform Uniforms
     vec4 negative_color;
     vec4 positive_color;
     float point_size;
+    uint packed_events;
 } ubo;
 
+vec4 read_event(uint index)
+{
+    if (ubo.packed_events != 0u) {
+        uint xy = event_buffer.data[2u * index];
+        uint time_polarity = event_buffer.data[2u * index + 1u];
+        return vec4(float(xy & 0xFFFFu), float(xy >> 16), float(time_polarity & 0x7FFFFFFFu),
+                    float(time_polarity >> 31));
+    }
+    return uintBitsToFloat(uvec4(event_buffer.data[4u * index], event_buffer.data[4u * index + 1u],
+                                 event_buffer.data[4u * index + 2u], event_buffer.data[4u * index + 3u]));
+}
+
 void main()
 {
+    vec4 aPos = read_event(uint(gl_VertexIndex));
     gl_Position = ubo.mvp * vec4(aPos.xyz, 1.0);
     gl_PointSize = ubo.point_size;
     vColor = aPos.w > 0.0 ? ubo.positive_color : ubo.negative_color;
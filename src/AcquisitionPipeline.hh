@@ -0,0 +1,457 @@
+#pragma once
+#ifndef ACQUISITION_PIPELINE_HH
+#define ACQUISITION_PIPELINE_HH
+
+#include "DataWriter.hh"
+#include "EventData.hh"
+#include "SpscRing.hh"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <random>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Stages data read from a camera or file goes through on its way to EventData and the DataWriter, each on a
+ *        thread of its own and connected by bounded SpscRing buffers:
+ *        read (DataAcquisition::read_batch) -> convert (convert_step) -> ingest (ingest_step)
+ *                                                                     \-> write fan-out (writer_step).
+ *        Reading only copies batches off the reader, so a slow stage further down never holds up a camera. When
+ *        the rings are full, a camera's batch is dropped and counted, while a file simply waits to be read. Every
+ *        stage counts the batches and events it passes on, see get_stage_stats.
+ */
+class AcquisitionPipeline
+{
+    public:
+        // Batches held between two stages
+        static constexpr std::size_t kRingCapacity{64};
+
+        /**
+         * @brief Stages of the pipeline, in the order data goes through them.
+         */
+        enum class Stage : uint8_t
+        {
+            READ,
+            CONVERT,
+            INGEST,
+            WRITE,
+        };
+        static constexpr std::size_t kStageCount{4};
+
+        // Shortest time rates are measured over, in seconds
+        static constexpr double kRateInterval{0.5};
+
+        /**
+         * @brief Data of every stream read in one step of the reader, as the reader returned it. IMU samples and
+         *        triggers are few and converted right away.
+         */
+        struct RawBatch
+        {
+                uint64_t generation{0};
+                float discard_threshold{1.0f}; // Events are discarded at random above it, see convert_evts
+                std::optional<dv::EventStore> events{};
+                std::optional<dv::Frame> frame{};
+                std::vector<EventData::ImuDatum> imu{};
+                std::vector<EventData::TriggerDatum> triggers{};
+        };
+
+        /**
+         * @brief Throughput of a stage over the last rate interval, and how much waits for it.
+         */
+        struct StageStats
+        {
+                std::size_t queue_depth;    // Batches waiting for the stage
+                std::size_t queue_capacity; // 0 for the reader, nothing waits for it
+                double batch_rate;          // Batches per second passed on
+                double evt_rate;            // Events per second passed on
+                uint64_t dropped_batches;   // Batches dropped since the last reset, only the reader drops
+        };
+
+        /**
+         * @brief Constructor, the pipeline is empty.
+         */
+        AcquisitionPipeline()
+            : raw_ring{kRingCapacity}, ingest_ring{kRingCapacity}, writer_ring{kRingCapacity}, generation{0},
+              dropped_batches{0}, counters{}, rng{std::random_device{}()}, pending_ingest{}, pending_writer{},
+              last_report{std::chrono::steady_clock::now()}, last_counts{}, last_rates{}
+        {
+        }
+
+        /**
+         * @brief Makes batches of the previous source still in the pipeline be dropped instead of stored, and
+         *        clears the event data, atomically with respect to the ingest stage. Called by the reader when the
+         *        source changes.
+         * @param evt_data EventData object the pipeline stores into.
+         */
+        void invalidate(EventData &evt_data)
+        {
+            evt_data.lock_data_vectors();
+            generation.fetch_add(1, std::memory_order_relaxed);
+            evt_data.clear();
+            evt_data.unlock_data_vectors();
+            dropped_batches.store(0, std::memory_order_relaxed);
+        }
+
+        /**
+         * @brief Checks if the ring the reader pushes to is full. Reader only.
+         * @return true if a pushed batch would be dropped, false otherwise.
+         */
+        bool is_read_ring_full() const
+        {
+            return raw_ring.size() == raw_ring.capacity();
+        }
+
+        /**
+         * @brief Checks if everything read so far went through every stage. Reader only, only a snapshot while
+         *        the stages are running.
+         * @return true if no batch is in flight, false otherwise.
+         */
+        bool is_drained() const
+        {
+            return raw_ring.empty() && ingest_ring.empty() && writer_ring.empty() &&
+                   in_flight.load(std::memory_order_acquire) == 0;
+        }
+
+        /**
+         * @brief Hands a batch from the reader to the converter. Reader only.
+         * @param batch batch read, stamped with the current source generation.
+         * @return true if the batch was queued, false if the ring was full and the batch was dropped.
+         */
+        bool push_raw(RawBatch &&batch)
+        {
+            batch.generation = generation.load(std::memory_order_relaxed);
+            const uint64_t evts{batch.events.has_value() ? static_cast<uint64_t>(batch.events->size()) : 0};
+            in_flight.fetch_add(1, std::memory_order_acq_rel);
+            if (!raw_ring.try_push(std::move(batch)))
+            {
+                in_flight.fetch_sub(1, std::memory_order_acq_rel);
+                dropped_batches.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+            count(Stage::READ, evts);
+            return true;
+        }
+
+        /**
+         * @brief Converts the next batch from the reader to EventData's types, discarding events at random, and
+         *        hands it to the ingest stage and, when saving, to the write fan-out stage. A batch the next stages
+         *        have no room for is kept and handed on by a later call. Converter thread only.
+         * @param data_writer DataWriter object, decides what is saved.
+         * @return true if a batch was handed on, false if there was nothing to do or no room.
+         */
+        bool convert_step(DataWriter &data_writer)
+        {
+            if (!hand_on_pending())
+            {
+                return false;
+            }
+
+            RawBatch raw{};
+            if (!raw_ring.try_pop(raw))
+            {
+                return false;
+            }
+
+            IngestBatch batch{.generation = raw.generation, .evts = {}, .frame = {}, .imu = std::move(raw.imu),
+                              .triggers = std::move(raw.triggers)};
+            WriterBatch saved{.generation = raw.generation};
+            if (raw.events.has_value())
+            {
+                // Saved events are copied only when saving, and only the events kept
+                const bool save_evts{data_writer.get_writing_event_data()};
+                convert_evts(raw.events.value(), raw.discard_threshold, rng, batch.evts,
+                             save_evts ? &saved.events.emplace() : nullptr);
+            }
+            if (raw.frame.has_value())
+            {
+                batch.frame = convert_frame(raw.frame.value());
+                if (data_writer.get_writing_frame_data())
+                {
+                    saved.frame = std::move(raw.frame);
+                }
+            }
+
+            const uint64_t evts{batch.evts.size()};
+            pending_ingest = std::move(batch);
+            if (saved.events.has_value() || saved.frame.has_value())
+            {
+                in_flight.fetch_add(1, std::memory_order_acq_rel); // The batch now goes two ways
+                pending_writer = std::move(saved);
+            }
+            hand_on_pending();
+            count(Stage::CONVERT, evts);
+            return true;
+        }
+
+        /**
+         * @brief Stores the next converted batch in event data, unless it was read from a previous source, see
+         *        invalidate. Ingest thread only.
+         * @param evt_data EventData object to store into.
+         * @return true if a batch was taken, false if there was none.
+         */
+        bool ingest_step(EventData &evt_data)
+        {
+            IngestBatch batch{};
+            if (!ingest_ring.try_pop(batch))
+            {
+                return false;
+            }
+
+            evt_data.lock_data_vectors(); // Checking and storing are one step with respect to invalidate
+            if (batch.generation == generation.load(std::memory_order_relaxed))
+            {
+                // Whole batch under one lock
+                evt_data.write_evt_data_batch(batch.evts);
+                if (batch.frame.has_value())
+                {
+                    evt_data.write_frame_data(std::move(batch.frame.value()));
+                }
+                evt_data.write_imu_data_batch(batch.imu);
+                evt_data.write_trigger_data_batch(batch.triggers);
+            }
+            evt_data.unlock_data_vectors();
+
+            count(Stage::INGEST, batch.evts.size());
+            in_flight.fetch_sub(1, std::memory_order_acq_rel);
+            return true;
+        }
+
+        /**
+         * @brief Queues the next batch to save with the DataWriter, which writes it on its own thread, unless it was
+         *        read from a previous source. Writer thread only.
+         * @param data_writer DataWriter object to queue to.
+         * @return true if a batch was taken, false if there was none.
+         */
+        bool writer_step(DataWriter &data_writer)
+        {
+            WriterBatch batch{};
+            if (!writer_ring.try_pop(batch))
+            {
+                return false;
+            }
+
+            const uint64_t evts{batch.events.has_value() ? static_cast<uint64_t>(batch.events->size()) : 0};
+            const bool current{batch.generation == generation.load(std::memory_order_relaxed)};
+            if (current && batch.events.has_value())
+            {
+                data_writer.add_event_store(std::move(batch.events.value()));
+            }
+            if (current && batch.frame.has_value())
+            {
+                data_writer.add_frame_data(std::move(batch.frame.value()));
+            }
+
+            count(Stage::WRITE, evts);
+            in_flight.fetch_sub(1, std::memory_order_acq_rel);
+            return true;
+        }
+
+        /**
+         * @brief Gets the throughput of every stage and the queue depths now. Rates are measured again once every
+         *        rate interval, calls in between get the last rates. Meant to be called by one thread.
+         * @return stats of every stage, by Stage.
+         */
+        std::array<StageStats, kStageCount> get_stage_stats()
+        {
+            const auto now = std::chrono::steady_clock::now();
+            const double seconds{std::chrono::duration<double>(now - last_report).count()};
+            if (seconds >= kRateInterval)
+            {
+                last_report = now;
+                for (std::size_t stage{0}; stage < kStageCount; ++stage)
+                {
+                    std::pair<uint64_t, uint64_t> counts{counters[stage].batches.load(std::memory_order_relaxed),
+                                                         counters[stage].evts.load(std::memory_order_relaxed)};
+                    last_rates[stage] = {static_cast<double>(counts.first - last_counts[stage].first) / seconds,
+                                         static_cast<double>(counts.second - last_counts[stage].second) / seconds};
+                    last_counts[stage] = counts;
+                }
+            }
+
+            const std::array<std::size_t, kStageCount> depths{0, raw_ring.size(), ingest_ring.size(),
+                                                              writer_ring.size()};
+            const std::array<std::size_t, kStageCount> capacities{0, raw_ring.capacity(), ingest_ring.capacity(),
+                                                                  writer_ring.capacity()};
+            std::array<StageStats, kStageCount> stats{};
+            for (std::size_t stage{0}; stage < kStageCount; ++stage)
+            {
+                stats[stage] = StageStats{
+                    .queue_depth = depths[stage],
+                    .queue_capacity = capacities[stage],
+                    .batch_rate = last_rates[stage].first,
+                    .evt_rate = last_rates[stage].second,
+                    .dropped_batches = stage == 0 ? dropped_batches.load(std::memory_order_relaxed) : 0};
+            }
+            return stats;
+        }
+
+        /**
+         * @brief Converts events read to EventData's type. Events are kept when a uniform random number in [0, 1]
+         *        is at most the threshold, a threshold of 1 or more keeps every event without drawing numbers.
+         * @param events events read.
+         * @param threshold odds of keeping an event.
+         * @param rng random number generator to draw from.
+         * @param out set to the kept events.
+         * @param saved if not null, set to a copy of the kept events to save.
+         */
+        static void convert_evts(const dv::EventStore &events, float threshold, std::minstd_rand &rng,
+                                 std::vector<EventData::EventDatum> &out, dv::EventStore *saved)
+        {
+            std::uniform_real_distribution<float> uniform{0.0f, 1.0f};
+            out.clear();
+            out.reserve(events.size());
+            for (const auto &evt : events)
+            {
+                if (threshold < 1.0f && uniform(rng) > threshold) // Random discard
+                {
+                    continue;
+                }
+                out.push_back(EventData::EventDatum{
+                    .x = evt.x(), .y = evt.y(), .timestamp = evt.timestamp(), .polarity = evt.polarity()});
+
+                // In case of persistent storage
+                // https://dv-processing.inivation.com/master/event_store.html
+                if (saved)
+                {
+                    saved->emplace_back(evt.timestamp(), evt.x(), evt.y(), evt.polarity());
+                }
+            }
+        }
+
+        /**
+         * @brief Converts a frame read to EventData's type, compressed as the frame store keeps it so storing it
+         *        does not compress it while holding the EventData lock.
+         * @param frame frame read, in BGR.
+         * @return frame in RGB with tightly packed bytes.
+         */
+        static EventData::FrameDatum convert_frame(const dv::Frame &frame)
+        {
+            cv::Mat out;
+            // Convert frame data from BGR to RGB
+            cv::cvtColor(frame.image, out, cv::COLOR_BGR2RGB);
+
+            // Clone to ensure tightly packed frame bytes
+            EventData::FrameDatum frame_datum{.frameData = out.clone(), .timestamp = frame.timestamp};
+            frame_datum.encoded = EventData::FrameStore::encode(frame_datum.frameData);
+            return frame_datum;
+        }
+
+        /**
+         * @brief Converts IMU samples read to EventData's type.
+         * @param imu_data IMU samples read.
+         * @param out set to the samples.
+         */
+        template <typename Samples>
+        static void convert_imu(const Samples &imu_data, std::vector<EventData::ImuDatum> &out)
+        {
+            out.clear();
+            out.reserve(imu_data.size());
+            for (const auto &imu : imu_data)
+            {
+                out.push_back(EventData::ImuDatum{
+                    .timestamp = imu.timestamp,
+                    .sample = {.accelerometer = glm::vec3{imu.accelerometerX, imu.accelerometerY, imu.accelerometerZ},
+                               .gyroscope = glm::vec3{imu.gyroscopeX, imu.gyroscopeY, imu.gyroscopeZ},
+                               .temperature = imu.temperature}});
+            }
+        }
+
+        /**
+         * @brief Converts triggers read to EventData's type.
+         * @param trigger_data triggers read.
+         * @param out set to the triggers.
+         */
+        template <typename Triggers>
+        static void convert_triggers(const Triggers &trigger_data, std::vector<EventData::TriggerDatum> &out)
+        {
+            out.clear();
+            out.reserve(trigger_data.size());
+            for (const auto &trigger : trigger_data)
+            {
+                out.push_back(EventData::TriggerDatum{.timestamp = trigger.timestamp,
+                                                      .type = static_cast<uint8_t>(trigger.type)});
+            }
+        }
+
+    private:
+        // Batch ready to be stored
+        struct IngestBatch
+        {
+                uint64_t generation{0};
+                std::vector<EventData::EventDatum> evts{};
+                std::optional<EventData::FrameDatum> frame{};
+                std::vector<EventData::ImuDatum> imu{};
+                std::vector<EventData::TriggerDatum> triggers{};
+        };
+
+        // Batch ready to be saved, only holds what is being saved
+        struct WriterBatch
+        {
+                uint64_t generation{0};
+                std::optional<dv::EventStore> events{};
+                std::optional<dv::Frame> frame{};
+        };
+
+        // Batches and events a stage passed on
+        struct StageCounter
+        {
+                std::atomic<uint64_t> batches{0};
+                std::atomic<uint64_t> evts{0};
+        };
+
+        SpscRing<RawBatch> raw_ring;        // Reader to converter
+        SpscRing<IngestBatch> ingest_ring;  // Converter to ingest
+        SpscRing<WriterBatch> writer_ring;  // Converter to write fan-out
+
+        // Source generation, batches stamped with an older one are dropped by the ingest stage
+        std::atomic<uint64_t> generation;
+        std::atomic<uint64_t> dropped_batches;
+        // Batches pushed by the reader or converter and not yet taken by the ingest or write fan-out stage
+        std::atomic<uint64_t> in_flight{0};
+        std::array<StageCounter, kStageCount> counters;
+
+        // Converter thread only
+        std::minstd_rand rng;
+        std::optional<IngestBatch> pending_ingest;
+        std::optional<WriterBatch> pending_writer;
+
+        // Thread calling get_stage_stats only
+        std::chrono::steady_clock::time_point last_report;
+        std::array<std::pair<uint64_t, uint64_t>, kStageCount> last_counts;
+        std::array<std::pair<double, double>, kStageCount> last_rates;
+
+        /**
+         * @brief Counts a batch a stage passed on.
+         * @param stage stage that passed the batch on.
+         * @param evts events in the batch.
+         */
+        void count(Stage stage, uint64_t evts)
+        {
+            StageCounter &counter{counters[static_cast<std::size_t>(stage)]};
+            counter.batches.fetch_add(1, std::memory_order_relaxed);
+            counter.evts.fetch_add(evts, std::memory_order_relaxed);
+        }
+
+        /**
+         * @brief Hands on the converted batches the next stages had no room for. Converter thread only.
+         * @return true if nothing is pending anymore, false otherwise.
+         */
+        bool hand_on_pending()
+        {
+            if (pending_ingest.has_value() && ingest_ring.try_push(std::move(pending_ingest.value())))
+            {
+                pending_ingest.reset();
+            }
+            if (pending_writer.has_value() && writer_ring.try_push(std::move(pending_writer.value())))
+            {
+                pending_writer.reset();
+            }
+            return !pending_ingest.has_value() && !pending_writer.has_value();
+        }
+};
+
+#endif // ACQUISITION_PIPELINE_HH
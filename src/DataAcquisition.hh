@@ -2,12 +2,16 @@
 #ifndef DATA_ACQUISITION_HH
 #define DATA_ACQUISITION_HH
 
+#include "AcquisitionPipeline.hh"
 #include "DataWriter.hh"
 #include "EventData.hh"
 #include "ParameterStore.hh"
+#include "RecordingSession.hh"
 #include <dv-processing/io/camera/discovery.hpp>
 #include <dv-processing/io/camera/usb_device.hpp>
 #include <dv-processing/io/mono_camera_recording.hpp>
+#include <deque>
+#include <tuple>
 #include <vector>
 
 /**
@@ -26,6 +30,9 @@ class DataAcquisition
         // Can get camera and file data.
         std::unique_ptr<dv::io::InputBase> data_reader_ptr;
 
+        // Files of the session being read, decoded a chunk at a time as they are looked at
+        RecordingSession session;
+
         int32_t camera_event_width;
         int32_t camera_event_height;
 
@@ -34,24 +41,23 @@ class DataAcquisition
 
         std::mutex acq_lock; // For thread safety
 
-        /**
-         * @brief From old NOVA source code
-         *        to get random float from 0.0 to 1.0
-         * @return random float from 0.0 to 1.0
-         */
+        // Chunk of the session whose batches are in the pipeline, NO_CHUNK if none
+        std::size_t session_chunk;
 
-        float randFloat()
-        {
-            return static_cast<float>(rand()) / RAND_MAX;
-        };
+        // Batches of session_chunk not yet handed to the pipeline, handed on as it has room for them
+        std::deque<AcquisitionPipeline::RawBatch> session_batches;
+
+        // True while a camera is read, its batches are read even when the pipeline has no room for them
+        bool reading_camera;
 
     public:
         /**
          * @brief Constructor, zero initializes all variables
          */
         DataAcquisition()
-            : data_reader_ptr{}, camera_event_width{}, camera_event_height{}, camera_frame_width{},
-              camera_frame_height{}, acq_lock{}
+            : data_reader_ptr{}, session{}, camera_event_width{}, camera_event_height{}, camera_frame_width{},
+              camera_frame_height{}, acq_lock{},
+              session_chunk{RecordingSession::NO_CHUNK}, session_batches{}, reading_camera{false}
         {
         }
 
@@ -61,6 +67,10 @@ class DataAcquisition
         void clear_reader()
         {
             data_reader_ptr.reset();
+            session.close();
+            session_chunk = RecordingSession::NO_CHUNK;
+            session_batches.clear();
+            reading_camera = false;
 
             camera_event_width = 0;
             camera_event_height = 0;
@@ -130,6 +140,7 @@ class DataAcquisition
             {
                 data_reader_ptr = std::move(
                     dv::io::camera::open(scanned_cameras[camera_index])); // Specify move semantics for unique pointer
+                reading_camera = true;
             }
             catch (...)
             {
@@ -184,6 +195,7 @@ class DataAcquisition
             try
             {
                 data_reader_ptr = std::make_unique<dv::io::MonoCameraRecording>(file_name);
+                reading_camera = false;
             }
             catch (...)
             {
@@ -215,149 +227,267 @@ class DataAcquisition
         }
 
         /**
-         * @brief Gives event camera resolution to event data.
-         * @param evt_data EventData object to give camera resolution to.
+         * @brief Opens files to read as one session decoded on demand, see RecordingSession. Only the packet table of
+         *        every file is read here, chunks are decoded by decode_session_chunk as they are looked at.
+         * @param paths files and directories holding files.
+         * @param param_store ParameterStore necessary for storing error messages in cases of failure.
+         * @return false if no file could be read, true otherwise.
          */
-        void get_camera_event_resolution(EventData &evt_data)
+        bool init_session_reader(const std::vector<std::string> &paths, ParameterStore &param_store)
         {
-            evt_data.set_camera_event_resolution(camera_event_width, camera_event_height);
+            std::unique_lock<std::mutex> acq_lock_ul{acq_lock};
+            data_reader_ptr.reset();
+            if (!session.open(paths))
+            {
+                std::string pop_up_err_str{"No .aedat4 file of the session could be read!"};
+                param_store.add("pop_up_err_str", pop_up_err_str);
+                acq_lock_ul.unlock();
+                return false;
+            }
+
+            std::tie(camera_event_width, camera_event_height) = session.get_event_resolution();
+            std::tie(camera_frame_width, camera_frame_height) = session.get_frame_resolution();
+            acq_lock_ul.unlock();
+            return true;
         }
 
         /**
-         * @brief Gives frame camera resolution to event data.
-         * @param evt_data EventData object to give camera resolution to.
+         * @brief Checks if a session is being read.
+         * @return true if a session is open, false otherwise.
          */
-        void get_camera_frame_resolution(EventData &evt_data)
+        bool is_session_open()
         {
-            evt_data.set_camera_frame_resolution(camera_frame_width, camera_frame_height);
+            std::unique_lock<std::mutex> acq_lock_ul{acq_lock};
+            bool open{session.is_open()};
+            acq_lock_ul.unlock();
+            return open;
         }
 
         /**
-         * @brief For dynamic loading (streaming), gets a batch of event data.
-         * @param evt_data EventData object to populate with event/frame data
-         * @param param_store ParameterStore object with data from GUI.
-         * @return true if data was read, false otherwise.
+         * @brief Gets the length of the session being read, see RecordingSession::get_duration.
+         * @return length of the session in microseconds, -1 if no session is open.
+         */
+        int64_t get_session_duration()
+        {
+            std::unique_lock<std::mutex> acq_lock_ul{acq_lock};
+            int64_t duration{session.is_open() ? session.get_duration() : -1};
+            acq_lock_ul.unlock();
+            return duration;
+        }
+
+        /**
+         * @brief Decodes the next chunk of the session a window of the session needs, see
+         *        RecordingSession::next_chunk, and hands it to the pipeline like read_batch does. Events, frames, IMU
+         *        samples and triggers of the chunk are read by seeking to its packets, frames one batch each. The
+         *        batches are handed on by this and later calls as the pipeline has room for them, and the chunk is
+         *        marked decoded once the pipeline stored all of it, only then is the next chunk picked.
+         * @param pipeline AcquisitionPipeline object to hand the chunk to.
+         * @param evt_data EventData object the session is decoded into.
+         * @param param_store ParameterStore necessary for storing error messages in cases of failure.
+         * @param start_time start of window relative to the session start in microseconds.
+         * @param end_time end of window relative to the session start in microseconds.
+         * @param event_discard_odds odds of discarding an event.
+         * @return true if a chunk was read, handed on or finished, false otherwise.
          */
-        bool get_batch_evt_data(EventData &evt_data, ParameterStore &param_store, DataWriter &data_writer,
-                                float event_discard_odds)
+        bool decode_session_chunk(AcquisitionPipeline &pipeline, EventData &evt_data, ParameterStore &param_store,
+                                  int64_t start_time, int64_t end_time, float event_discard_odds)
         {
             std::unique_lock<std::mutex> acq_lock_ul{acq_lock};
-            // If reader is not properly initialized, return immediately
-            if (!data_reader_ptr)
+            if (!session.is_open() || event_discard_odds < 0.00001)
             {
                 acq_lock_ul.unlock();
                 return false;
             }
-            bool data_read = false;
 
-            if (event_discard_odds < 0.00001)
+            // Chunk still going through the pipeline, the window may only move on once it is stored
+            if (session_chunk != RecordingSession::NO_CHUNK)
             {
-                std::string pop_up_err_str{"Event Discard Odds are too low!"};
-                param_store.add("pop_up_err_str", pop_up_err_str);
+                bool progress{false};
+                while (!session_batches.empty() && !pipeline.is_read_ring_full())
+                {
+                    pipeline.push_raw(std::move(session_batches.front()));
+                    session_batches.pop_front();
+                    progress = true;
+                }
+                if (session_batches.empty() && pipeline.is_drained())
+                {
+                    session.finish_chunk(evt_data, session_chunk);
+                    session_chunk = RecordingSession::NO_CHUNK;
+                    progress = true;
+                }
                 acq_lock_ul.unlock();
-                return false;
+                return progress;
             }
 
-            // Discard threshold
-            float threshold{1.0f / event_discard_odds};
+            // Nothing is in flight, so the chunk picked may clear or evict event data
+            std::size_t chunk{session.next_chunk(evt_data, start_time, end_time)};
+            if (chunk == RecordingSession::NO_CHUNK)
+            {
+                acq_lock_ul.unlock();
+                return false;
+            }
 
-            // https://dv-processing.inivation.com/rel_1_7/reading_data.html#read-events-from-a-file
+            // Discard threshold, events are discarded by the converter
+            const float discard_threshold{1.0f / event_discard_odds};
+            AcquisitionPipeline::RawBatch batch{.discard_threshold = discard_threshold};
 
+            // https://dv-processing.inivation.com/rel_1_7/reading_data.html
+            const RecordingSession::Chunk &range{session.get_chunks()[chunk]};
             try
             {
-                if (data_reader_ptr->isEventStreamAvailable() && data_reader_ptr->isRunning("events"))
+                dv::io::MonoCameraRecording &recording{session.get_recording(chunk)};
+                if (recording.isEventStreamAvailable())
+                {
+                    batch.events = recording.getEventsTimeRange(range.start_time, range.end_time);
+                }
+                if (recording.isImuStreamAvailable())
                 {
-                    if (const auto events = data_reader_ptr->getNextEventBatch(); events.has_value())
+                    if (const auto imu_data = recording.getImuTimeRange(range.start_time, range.end_time);
+                        imu_data.has_value())
                     {
-                        // In case of persistent storage
-                        // https://dv-processing.inivation.com/master/event_store.html
-                        dv::EventStore event_store{};
-                        for (auto &evt : events.value())
-                        {
-                            if (randFloat() > threshold) // Random discard
-                            {
-                                continue; // Discard
-                            }
-                            EventData::EventDatum evt_datum{
-                                .x = evt.x(), .y = evt.y(), .timestamp = evt.timestamp(), .polarity = evt.polarity()};
-
-                            evt_data.write_evt_data(evt_datum);
-                            data_read = true;
-
-                            event_store.emplace_back(evt.timestamp(), evt.x(), evt.y(), evt.polarity());
-                        }
+                        AcquisitionPipeline::convert_imu(imu_data.value(), batch.imu);
+                    }
+                }
+                if (recording.isTriggerStreamAvailable())
+                {
+                    if (const auto trigger_data = recording.getTriggersTimeRange(range.start_time, range.end_time);
+                        trigger_data.has_value())
+                    {
+                        AcquisitionPipeline::convert_triggers(trigger_data.value(), batch.triggers);
+                    }
+                }
+                session_batches.push_back(std::move(batch));
 
-                        // Add to queue for persistent storage in case of persistent storage
-                        if (data_writer.get_writing_event_data())
+                if (recording.isFrameStreamAvailable())
+                {
+                    if (auto frames = recording.getFramesTimeRange(range.start_time, range.end_time);
+                        frames.has_value())
+                    {
+                        for (dv::Frame &frame : frames.value())
                         {
-                            data_writer.add_event_store(event_store);
+                            session_batches.push_back(AcquisitionPipeline::RawBatch{
+                                .discard_threshold = discard_threshold, .frame = std::move(frame)});
                         }
                     }
                 }
             }
             catch (...)
             {
-                std::string pop_up_err_str{"Something went wrong with reading event data!"};
+                std::string pop_up_err_str{"Something went wrong while decoding part of the session!"};
                 param_store.add("pop_up_err_str", pop_up_err_str);
+                session.close();
+                session_batches.clear();
                 acq_lock_ul.unlock();
                 return false;
             }
+
+            session_chunk = chunk;
             acq_lock_ul.unlock();
-            return data_read;
+            return true;
+        }
+
+        /**
+         * @brief Checks if the reader has been fully read, i.e. a file reader reached the end of the file.
+         * @return true if there is a reader and it has no more data, false otherwise.
+         */
+        bool is_reader_finished()
+        {
+            std::unique_lock<std::mutex> acq_lock_ul{acq_lock};
+            bool finished{data_reader_ptr && !data_reader_ptr->isRunning()};
+            acq_lock_ul.unlock();
+            return finished;
+        }
+
+        /**
+         * @brief Gives event camera resolution to event data.
+         * @param evt_data EventData object to give camera resolution to.
+         */
+        void get_camera_event_resolution(EventData &evt_data)
+        {
+            evt_data.set_camera_event_resolution(camera_event_width, camera_event_height);
+        }
+
+        /**
+         * @brief Gives frame camera resolution to event data.
+         * @param evt_data EventData object to give camera resolution to.
+         */
+        void get_camera_frame_resolution(EventData &evt_data)
+        {
+            evt_data.set_camera_frame_resolution(camera_frame_width, camera_frame_height);
         }
 
         /**
-         * @brief For dynamic loading (streaming), gets a batch of frame data.
-         * @param evt_data EventData object to populate with event/frame data
+         * @brief For dynamic loading (streaming), reads the next batch of every stream the reader provides and hands
+         *        it to the pipeline, which converts and stores it on its own threads. A file is only read when the
+         *        pipeline has room for the batch. A camera is always read, so its buffers never fill up while later
+         *        stages catch up, and the batch is dropped when the pipeline has no room for it.
+         * @param pipeline AcquisitionPipeline object to hand the batch to.
          * @param param_store ParameterStore object with data from GUI.
+         * @param event_discard_odds odds of discarding an event.
          * @return true if data was read, false otherwise.
          */
-        bool get_batch_frame_data(EventData &evt_data, ParameterStore &param_store, DataWriter &data_writer)
+        bool read_batch(AcquisitionPipeline &pipeline, ParameterStore &param_store, float event_discard_odds)
         {
             std::unique_lock<std::mutex> acq_lock_ul{acq_lock};
-            // If reader is not initialized, return immediately
-            if (!data_reader_ptr)
+            // If reader is not properly initialized, or a file would only be read to be dropped, return immediately
+            if (!data_reader_ptr || (!reading_camera && pipeline.is_read_ring_full()))
             {
                 acq_lock_ul.unlock();
                 return false;
             }
-            bool data_read = false;
 
-            // https://dv-processing.inivation.com/rel_1_7/reading_data.html#read-frames-from-a-file
+            if (event_discard_odds < 0.00001)
+            {
+                std::string pop_up_err_str{"Event Discard Odds are too low!"};
+                param_store.add("pop_up_err_str", pop_up_err_str);
+                acq_lock_ul.unlock();
+                return false;
+            }
+
+            // Discard threshold, events are discarded by the converter
+            AcquisitionPipeline::RawBatch batch{.discard_threshold = 1.0f / event_discard_odds};
 
+            // https://dv-processing.inivation.com/rel_1_7/reading_data.html
             try
             {
+                if (data_reader_ptr->isEventStreamAvailable() && data_reader_ptr->isRunning("events"))
+                {
+                    batch.events = data_reader_ptr->getNextEventBatch();
+                }
                 if (data_reader_ptr->isFrameStreamAvailable() && data_reader_ptr->isRunning("frames"))
                 {
-                    if (const auto frame_data = data_reader_ptr->getNextFrame(); frame_data.has_value())
+                    batch.frame = data_reader_ptr->getNextFrame();
+                }
+                if (data_reader_ptr->isImuStreamAvailable() && data_reader_ptr->isRunning("imu"))
+                {
+                    if (const auto imu_data = data_reader_ptr->getNextImuBatch(); imu_data.has_value())
                     {
-                        cv::Mat out;
-                        // Convert frame data from BGR to RGB
-                        cv::cvtColor(frame_data->image, out, cv::COLOR_BGR2RGB);
-
-                        // CLone to ensure tightly packed frame bytes
-                        EventData::FrameDatum frame_datum{.frameData = out.clone(), .timestamp = frame_data->timestamp};
-
-                        evt_data.write_frame_data(frame_datum);
-                        data_read = true;
-
-                        // If saving stream, add to queue to write
-                        if (data_writer.get_writing_frame_data())
-                        {
-                            dv::Frame frame_datum(frame_data->timestamp, frame_data->image);
-                            data_writer.add_frame_data(frame_datum);
-                        }
+                        AcquisitionPipeline::convert_imu(imu_data.value(), batch.imu);
+                    }
+                }
+                if (data_reader_ptr->isTriggerStreamAvailable() && data_reader_ptr->isRunning("triggers"))
+                {
+                    if (const auto trigger_data = data_reader_ptr->getNextTriggerBatch(); trigger_data.has_value())
+                    {
+                        AcquisitionPipeline::convert_triggers(trigger_data.value(), batch.triggers);
                     }
                 }
             }
             catch (...)
             {
-                std::string pop_up_err_str{"Something went wrong with reading frame data!"};
+                std::string pop_up_err_str{"Something went wrong with reading data!"};
                 param_store.add("pop_up_err_str", pop_up_err_str);
                 acq_lock_ul.unlock();
                 return false;
             }
             acq_lock_ul.unlock();
+
+            bool data_read{batch.events.has_value() || batch.frame.has_value() || !batch.imu.empty() ||
+                           !batch.triggers.empty()};
+            if (data_read)
+            {
+                pipeline.push_raw(std::move(batch));
+            }
             return data_read;
         }
 
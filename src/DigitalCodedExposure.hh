@@ -26,7 +26,7 @@ struct PassData
         glm::vec4 negCol;     // Negative color
         glm::vec4 floatFlags; // x: color option, y: scale, z: activation function (0 for linear 1 for sigmoid), w: time
                               // center
-        glm::vec4 flags;      // x: posOnly, y: morlet
+        glm::vec4 flags;      // x: posOnly, y: morlet, z: packed events
         glm::vec4 morletParams; // x: frequency, y: width (h), z: time center
 };
 
@@ -194,10 +194,8 @@ class DigitalCodedExposure
          */
         void cpu_update()
         {
-            event_data.lock_data_vectors();
-            if (event_data.get_evt_vector_ref().empty())
+            if (event_data.get_evt_count() == 0) // Does not lock
             {
-                event_data.unlock_data_vectors();
                 // Delete old texture
                 if (render_targets["DigitalCodedExposure"].texture)
                 {
@@ -207,7 +205,6 @@ class DigitalCodedExposure
 
                 return;
             }
-            event_data.unlock_data_vectors();
 
             // Only generate textures when a new file has been loaded with new resolution
             if (parameter_store->exists("resolution_initialized") &&
@@ -257,14 +254,11 @@ class DigitalCodedExposure
          */
         void compute_pass(SDL_GPUCommandBuffer *command_buffer)
         {
-            // Ensure there is data
-            event_data.lock_data_vectors();
-            if (event_data.get_evt_vector_ref().empty())
+            // Ensure there is data, does not lock
+            if (event_data.get_evt_count() == 0)
             {
-                event_data.unlock_data_vectors();
                 return;
             }
-            event_data.unlock_data_vectors();
             // Sanity check resolution
             if (width == 0.0f || height == 0.0f || width > 1920.0f || height > 1200.0f)
             {
@@ -396,19 +390,9 @@ class DigitalCodedExposure
             }
             bool shutter_is_morlet{parameter_store->get<bool>("shutter_is_morlet")};
 
-            if (!parameter_store->exists("scrubber.current_time"))
-            {
-                parameter_store->add("scrubber.current_time", 0.0f);
-            }
-            float current_time{parameter_store->get<float>("scrubber.current_time")};
-
-            if (!parameter_store->exists("scrubber.lower_time"))
-            {
-                parameter_store->add("scrubber.lower_time", 0.0f);
-            }
-            float lower_time{parameter_store->get<float>("scrubber.lower_time")};
-
-            float time_center = (current_time + lower_time) / 2000.0f;
+            // Uploaded event times are offsets from the scrubber's points time base, center the shutter on the
+            // scrubber window in the same frame of reference (in milliseconds like the shader)
+            float time_center = (scrubber->get_lower_depth() + scrubber->get_upper_depth()) / 2000.0f;
 
             if (!parameter_store->exists("morlet_frequency"))
             {
@@ -425,8 +409,8 @@ class DigitalCodedExposure
             glm::vec4 floatFlags = glm::vec4(static_cast<float>(dce_color), event_contrib_weight,
                                              static_cast<float>(activation_function), 0.0f);
 
-            glm::vec4 flags =
-                glm::vec4((shutter_is_positive_only ? 1.0f : 0.0f), (shutter_is_morlet ? 1.0f : 0.0f), 0.0f, 0.0f);
+            glm::vec4 flags = glm::vec4((shutter_is_positive_only ? 1.0f : 0.0f), (shutter_is_morlet ? 1.0f : 0.0f),
+                                        (scrubber->get_points_packed() ? 1.0f : 0.0f), 0.0f);
 
             glm::vec4 morletParams =
                 glm::vec4(morlet_frequency, morlet_width, time_center, 0.0f); // frequency, width (h), time center
@@ -4,25 +4,40 @@
 #define EVENTDATA_HH
 
 #include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
 #include <cstdint>
 #include <cstring>
+#include <deque>
 #include <filesystem>
 #include <fstream>
 #include <functional>
 #include <glm/glm.hpp>
 #include <iomanip>
 #include <iterator>
+#include <limits>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <optional>
 #include <opencv2/highgui.hpp>
+#include <opencv2/imgcodecs.hpp>
 #include <opencv2/imgproc.hpp>
+#include <span>
 #include <sstream>
 #include <stdexcept>
 #include <system_error>
 #include <thread>
+#include <type_traits>
+#include <unordered_map>
 #include <vector>
 
 #include <boost/iostreams/device/mapped_file.hpp>
 #include <set>
 
+#include "VirtualMemory.hh"
+
 /**
  * @brief From previous NOVA source code
  *        Used for timestamp comparisons of event data
@@ -35,18 +50,6 @@ inline bool event_less_vec4_t(const glm::vec4 &a, const glm::vec4 &b)
     return a.z < b.z;
 }
 
-/**
- * @brief From previous NOVA source code
- *        Used for timestamp comparisons of frame data
- * @param a Left frame data operand
- * @param b Right frame data operand
- * @return result of a.second < b.second (timestamp comparisons)
- */
-inline bool frame_less_vec4_t(const std::pair<cv::Mat, float> &a, const std::pair<cv::Mat, float> &b)
-{
-    return a.second < b.second;
-}
-
 /**
  * @brief EventData is responsible for intaking event and frame data from DataAcquisition and
  *        presenting it to the drawing code in a convenient format.
@@ -54,41 +57,511 @@ inline bool frame_less_vec4_t(const std::pair<cv::Mat, float> &a, const std::pai
 class EventData
 {
     public:
+        /**
+         * @brief Storage format of event data.
+         *        VEC4 stores each event as 16 bytes of floats (x, y, relative time, polarity).
+         *        PACKED stores each event as 8 bytes (see PackedEvent).
+         *        COLUMNAR stores events as 9 bytes in separate time, x, y and polarity columns (see
+         *        ColumnarEventBuffer), scans testing only some fields read only those, uploads are gathered to PACKED.
+         */
+        enum class EventFormat : std::uint8_t
+        {
+            VEC4,
+            PACKED,
+            COLUMNAR,
+        };
+
+        /**
+         * @brief Compact 8 byte event. Layout matches what the points and DCE shaders decode:
+         *        first 32 bit word holds x (low 16 bits) and y (high 16 bits),
+         *        second 32 bit word holds the time offset in microseconds (low 31 bits) and polarity (high bit).
+         */
+        struct PackedEvent
+        {
+                uint16_t x;
+                uint16_t y;
+                uint32_t time_polarity;
+        };
+        static_assert(sizeof(PackedEvent) == 8, "PackedEvent must stay 8 bytes, shaders depend on it.");
+
+        static constexpr uint32_t kPackedTimeMask{0x7FFFFFFFu};
+        static constexpr uint32_t kPackedPolarityBit{0x80000000u};
+
+        // Largest time offset (in microseconds) from a segment base each format stores exactly.
+        // Floats represent every integer up to 2^24 exactly, packed events have 31 bits of time.
+        static constexpr int64_t kVec4MaxTimeOffset{int64_t{1} << 24};
+        static constexpr int64_t kPackedMaxTimeOffset{kPackedTimeMask};
+
+        // Number of events between entries of the sparse time index. 256 vec4 events fill exactly one 4 KB page,
+        // so a lookup narrowed to one block touches at most one page of the mapped storage.
+        static constexpr std::size_t kTimeIndexStride{256};
+
+        // Event counts indexed by polarity
+        using PolarityCounts = std::array<uint64_t, 2>;
+
+        /**
+         * @brief How much event data is retained while streaming.
+         *        UNBOUNDED keeps everything (up to the backing size limit),
+         *        EVENTS keeps at least the latest limit events,
+         *        DURATION keeps at least the events of the latest limit microseconds.
+         *        Older data is evicted a whole storage chunk at a time, so memory and disk use stay constant.
+         */
+        enum class RetentionMode : std::uint8_t
+        {
+            UNBOUNDED,
+            EVENTS,
+            DURATION,
+        };
+
+        /**
+         * @brief Hint about how soon a range of stored data is read, see MappedEventBuffer::advise.
+         *        WILL_NEED starts reading the range into memory in the background.
+         *        DONT_NEED lets the range be dropped from memory first, it is read back from disk when next used.
+         */
+        enum class AccessAdvice : std::uint8_t
+        {
+            WILL_NEED,
+            DONT_NEED,
+        };
+
+        /**
+         * @brief What backs the chunks of event storage, see StorageConfig.
+         *        MAPPED_FILE maps files in a scratch directory, cold pages are written back to them, so storage can
+         *        grow beyond RAM.
+         *        ANONYMOUS uses anonymous memory, nothing touches the file system but storage is limited by RAM and
+         *        swap.
+         *        HYBRID uses anonymous memory until all buffers together hold memory_limit bytes, then files.
+         */
+        enum class StorageBackend : std::uint8_t
+        {
+            MAPPED_FILE,
+            ANONYMOUS,
+            HYBRID,
+        };
+
+        /**
+         * @brief Page size of anonymous storage. Larger pages mean fewer TLB misses and page faults over large
+         *        windows.
+         *        NONE uses regular pages.
+         *        TRANSPARENT_HUGE_PAGES asks the OS to back the memory with huge pages when it can (Linux only).
+         *        EXPLICIT_HUGE_PAGES maps reserved huge pages (hugetlbfs on Linux, large pages on Windows, which needs
+         *        the lock pages in memory privilege) and falls back to TRANSPARENT_HUGE_PAGES if none are available.
+         *        The names avoid TRANSPARENT, a macro of wingdi.h.
+         */
+        enum class HugePageMode : std::uint8_t
+        {
+            NONE,
+            TRANSPARENT_HUGE_PAGES,
+            EXPLICIT_HUGE_PAGES,
+        };
+
+        /**
+         * @brief Storage settings of the buffers of an EventData object, see EventData::set_storage_config.
+         */
+        struct StorageConfig
+        {
+                StorageBackend backend{StorageBackend::MAPPED_FILE};
+                // Directory backing files are created in, the current directory if empty
+                std::filesystem::path scratch_directory{};
+                // Bytes of anonymous memory all buffers together use before HYBRID spills to files
+                std::size_t memory_limit{0};
+                // Anonymous memory only
+                HugePageMode huge_pages{HugePageMode::NONE};
+                // Anonymous memory only, maps every page of a chunk up front instead of on first touch
+                bool populate{false};
+
+                /**
+                 * @brief Gets the directory backing files are created in.
+                 * @return scratch_directory, or the current directory if it is empty.
+                 */
+                std::filesystem::path directory() const
+                {
+                    return scratch_directory.empty() ? std::filesystem::current_path() : scratch_directory;
+                }
+
+                bool operator==(const StorageConfig &) const = default;
+        };
+
+        /**
+         * @brief Start of a run of stored events whose times are offsets from a common base time.
+         *        Stored event times are offsets from the base of the segment they belong to, a new segment is
+         *        started whenever the offset of a new event would no longer be stored exactly. The exact relative
+         *        timestamp of an event is base_time + stored offset.
+         */
+        struct TimeSegment
+        {
+                std::size_t first_index;
+                int64_t base_time;
+        };
+
+        /**
+         * @brief Start of a run of events recorded between two camera resets, see EventData::set_evt_epoch_limit.
+         *        Each epoch continues the relative timeline 1 microsecond after the last event of the one before it,
+         *        so relative timestamps never decrease across epochs. The camera timestamp of an event is its relative
+         *        timestamp + time_origin of its epoch.
+         */
+        struct Epoch
+        {
+                std::size_t first_index;
+                int64_t start_time;  // Relative timestamp of the first event
+                int64_t time_origin; // Camera timestamp of relative timestamp 0
+        };
+
+        /**
+         * @brief Retained events of an epoch, see EventData::get_evt_epochs.
+         */
+        struct EpochRange
+        {
+                std::size_t id; // Epochs are numbered from 0 since the last clear
+                std::size_t first_index;
+                std::size_t last_index; // One past the last event
+                int64_t time_origin;
+        };
+
+        /**
+         * @brief Packs an event into the compact format.
+         * @param x x coordinate of event.
+         * @param y y coordinate of event.
+         * @param relative_time time offset in microseconds, must fit in 31 bits.
+         * @param polarity polarity of event.
+         * @return packed event.
+         */
+        static PackedEvent pack_event(int32_t x, int32_t y, uint32_t relative_time, uint8_t polarity)
+        {
+            return PackedEvent{static_cast<uint16_t>(x), static_cast<uint16_t>(y),
+                               (relative_time & kPackedTimeMask) | (polarity ? kPackedPolarityBit : 0u)};
+        }
+
+        /**
+         * @brief Unpacks a compact event into the float format used by the drawing code.
+         * @param packed packed event.
+         * @return event as glm::vec4 (x, y, time offset, polarity).
+         */
+        static glm::vec4 unpack_event(const PackedEvent &packed)
+        {
+            return glm::vec4{static_cast<float>(packed.x), static_cast<float>(packed.y),
+                             static_cast<float>(packed.time_polarity & kPackedTimeMask),
+                             (packed.time_polarity & kPackedPolarityBit) ? 1.0f : 0.0f};
+        }
+
+        /**
+         * @brief Identity overload, lets code templated on the stored event type unpack either type.
+         * @param evt event in the float format.
+         * @return the same event.
+         */
+        static glm::vec4 unpack_event(const glm::vec4 &evt)
+        {
+            return evt;
+        }
+
         /**
          * @brief Secondary storage mapped event buffer.
          *        Stores event data in second storage and provides
          *        access to it like a standard random access std::vector object.
+         *        Storage is split into fixed-size chunks, each backed by its own mapped file. Growing the
+         *        container maps one more chunk and never touches the existing ones, so element addresses stay
+         *        stable for the lifetime of the container and growth does not stall on a remap.
+         *        Indices are logical and only ever grow: pop_front_chunk evicts the oldest chunk in O(1) and keeps
+         *        its mapping for reuse, so a container used as a ring keeps a constant memory and disk footprint
+         *        while the indices of retained elements stay the same. Retained elements are
+         *        [begin_index(), end_index()). A Snapshot keeps the chunks it reads from being reused until its last
+         *        copy is destroyed.
+         *        One writer appends while any number of readers read without locking: the writer fills elements
+         *        first and then publishes the new end index with one atomic store, so a reader that loads
+         *        end_index() sees fully written elements below it.
+         * @tparam T Element type stored, glm::vec4 for full float events or PackedEvent for compact events, or any
+         *           trivially copyable type such as the time index of EventData.
          */
-        class MappedEventBuffer
+        template <typename T = glm::vec4> class MappedEventBuffer
         {
             public:
-                using value_type = glm::vec4;
-                using iterator = value_type *;
-                using const_iterator = const value_type *;
+                using value_type = T;
+
+                // Chunks are a power of two in size so index to chunk conversion is a shift and a mask.
+                static constexpr std::size_t kChunkShift{20};
+                static constexpr std::size_t kChunkCapacity{static_cast<std::size_t>(1) << kChunkShift};
+                static constexpr std::size_t kChunkMask{kChunkCapacity - 1};
+
+                /**
+                 * @brief Random access iterator over the chunks of the container.
+                 *        Iterating crosses chunk boundaries transparently.
+                 */
+                template <bool Const> class basic_iterator
+                {
+                    public:
+                        using iterator_category = std::random_access_iterator_tag;
+                        using value_type = T;
+                        using difference_type = std::ptrdiff_t;
+                        using pointer = std::conditional_t<Const, const value_type *, value_type *>;
+                        using reference = std::conditional_t<Const, const value_type &, value_type &>;
+                        using container_pointer =
+                            std::conditional_t<Const, const MappedEventBuffer *, MappedEventBuffer *>;
+
+                        basic_iterator() = default;
+
+                        basic_iterator(container_pointer container, std::size_t index)
+                            : container_(container), index_(index)
+                        {
+                        }
+
+                        /**
+                         * @brief Returns the index in the container the iterator points at.
+                         * @return index in the container.
+                         */
+                        std::size_t index() const
+                        {
+                            return index_;
+                        }
+
+                        /**
+                         * @brief Allows iterator to const_iterator conversion.
+                         */
+                        operator basic_iterator<true>() const
+                        {
+                            return basic_iterator<true>{container_, index_};
+                        }
+
+                        reference operator*() const
+                        {
+                            return (*container_)[index_];
+                        }
+
+                        pointer operator->() const
+                        {
+                            return &(*container_)[index_];
+                        }
+
+                        reference operator[](difference_type offset) const
+                        {
+                            return (*container_)[index_ + offset];
+                        }
+
+                        basic_iterator &operator++()
+                        {
+                            ++index_;
+                            return *this;
+                        }
+
+                        basic_iterator operator++(int)
+                        {
+                            basic_iterator copy{*this};
+                            ++index_;
+                            return copy;
+                        }
+
+                        basic_iterator &operator--()
+                        {
+                            --index_;
+                            return *this;
+                        }
+
+                        basic_iterator operator--(int)
+                        {
+                            basic_iterator copy{*this};
+                            --index_;
+                            return copy;
+                        }
+
+                        basic_iterator &operator+=(difference_type offset)
+                        {
+                            index_ += offset;
+                            return *this;
+                        }
+
+                        basic_iterator &operator-=(difference_type offset)
+                        {
+                            index_ -= offset;
+                            return *this;
+                        }
+
+                        friend basic_iterator operator+(basic_iterator it, difference_type offset)
+                        {
+                            return it += offset;
+                        }
+
+                        friend basic_iterator operator+(difference_type offset, basic_iterator it)
+                        {
+                            return it += offset;
+                        }
+
+                        friend basic_iterator operator-(basic_iterator it, difference_type offset)
+                        {
+                            return it -= offset;
+                        }
+
+                        friend difference_type operator-(const basic_iterator &a, const basic_iterator &b)
+                        {
+                            return static_cast<difference_type>(a.index_) - static_cast<difference_type>(b.index_);
+                        }
+
+                        friend bool operator==(const basic_iterator &a, const basic_iterator &b)
+                        {
+                            return a.index_ == b.index_;
+                        }
+
+                        friend auto operator<=>(const basic_iterator &a, const basic_iterator &b)
+                        {
+                            return a.index_ <=> b.index_;
+                        }
+
+                    private:
+                        container_pointer container_{nullptr};
+                        std::size_t index_{0};
+                };
+
+                using iterator = basic_iterator<false>;
+                using const_iterator = basic_iterator<true>;
+
+                /**
+                 * @brief Immutable view of the elements published when it was taken, see snapshot. The container
+                 *        does not reuse the chunks a snapshot reads while any copy of it exists: chunks evicted or
+                 *        cleared meanwhile are held back and only reused once the last copy is destroyed, so the
+                 *        view stays valid and unchanged however long it is read. Copies are cheap and any thread may
+                 *        read or destroy them.
+                 */
+                class Snapshot
+                {
+                    public:
+                        /**
+                         * @brief Default constructor, holds no elements.
+                         */
+                        Snapshot() = default;
+
+                        /**
+                         * @brief Returns index of the first element of the snapshot.
+                         * @return index of the first element.
+                         */
+                        [[nodiscard]] std::size_t begin_index() const
+                        {
+                            return begin_index_;
+                        }
+
+                        /**
+                         * @brief Returns index one past the last element of the snapshot.
+                         * @return index one past the last element.
+                         */
+                        [[nodiscard]] std::size_t end_index() const
+                        {
+                            return end_index_;
+                        }
+
+                        /**
+                         * @brief Returns number of elements in the snapshot.
+                         * @return number of elements.
+                         */
+                        [[nodiscard]] std::size_t size() const
+                        {
+                            return end_index_ - begin_index_;
+                        }
+
+                        /**
+                         * @brief Returns if the snapshot holds no elements.
+                         * @return true if the snapshot is empty, false otherwise.
+                         */
+                        [[nodiscard]] bool empty() const
+                        {
+                            return size() == 0;
+                        }
+
+                        /**
+                         * @brief Provides indexing access to the snapshot.
+                         * @param index index in [begin_index(), end_index()).
+                         * @return const element at index.
+                         */
+                        const value_type &operator[](std::size_t index) const
+                        {
+                            return chunks_.get()[(index >> kChunkShift) - (begin_index_ >> kChunkShift)]
+                                                [index & kChunkMask];
+                        }
+
+                        /**
+                         * @brief Visits the elements in [first, last) as contiguous spans, one per chunk touched.
+                         * @param first index of first element to visit, clamped to begin_index().
+                         * @param last index one past the last element to visit, clamped to end_index().
+                         * @param fn callable taking a std::span<const value_type>.
+                         */
+                        template <typename Fn> void for_each_span(std::size_t first, std::size_t last, Fn &&fn) const
+                        {
+                            first = std::max(first, begin_index_);
+                            last = std::min(last, end_index_);
+                            while (first < last)
+                            {
+                                std::size_t count{std::min(kChunkCapacity - (first & kChunkMask), last - first)};
+                                fn(std::span<const value_type>{&(*this)[first], count});
+                                first += count;
+                            }
+                        }
+
+                        /**
+                         * @brief Writes the elements to directory in the layout MappedEventBuffer::save writes, so
+                         *        MappedEventBuffer::load can map them back. Needs no lock, the elements do not change.
+                         * @param directory directory to write to, must exist.
+                         * @param name name the files start with.
+                         */
+                        void save(const std::filesystem::path &directory, const std::string &name) const
+                        {
+                            save_chunks(directory, name, begin_index_, end_index_,
+                                        [this](std::size_t chunk) { return chunks_.get()[chunk]; });
+                        }
+
+                    private:
+                        friend class MappedEventBuffer;
+
+                        /**
+                         * @brief Constructor, see MappedEventBuffer::snapshot.
+                         * @param chunks data of every chunk holding elements, from the chunk of begin onwards.
+                         * @param begin index of the first element.
+                         * @param end index one past the last element.
+                         */
+                        Snapshot(std::shared_ptr<const value_type *const> chunks, std::size_t begin, std::size_t end)
+                            : chunks_{std::move(chunks)}, begin_index_{begin}, end_index_{end}
+                        {
+                        }
+
+                        // Shares ownership of the lease keeping the chunks from being reused
+                        std::shared_ptr<const value_type *const> chunks_;
+                        std::size_t begin_index_{0};
+                        std::size_t end_index_{0};
+                };
 
                 /**
-                 * @brief Constructor. Generates file with name nova_evt_buffer_(some number) as backing store of event
-                 *        data container.
+                 * @brief Constructor. Picks directory nova_evt_buffer_(some number) to hold the chunk files backing
+                 *        the event data container, chunks are mapped as elements are added. Every chunk slot points
+                 *        at mapped memory from then on, an untouched anonymous chunk until a chunk is added, so
+                 *        readers racing with the writer never touch unmapped memory.
                  */
                 MappedEventBuffer()
+                    : slots_{std::make_unique<std::atomic<value_type *>[]>(kMaxChunks)},
+                      sentinel_{virtual_memory::map_anonymous(kChunkBytes, false, false, false),
+                                AnonymousDeleter{kChunkBytes, false}}
                 {
                     std::ostringstream oss;
                     oss << "nova_evt_buffer_" << std::hex << std::hash<std::thread::id>{}(std::this_thread::get_id())
-                        << "_" << reinterpret_cast<std::uintptr_t>(this) << ".bin";
-                    file_path_ = std::filesystem::current_path() / oss.str();
-                    remap(kInitialCapacity);
+                        << "_" << reinterpret_cast<std::uintptr_t>(this);
+                    directory_path_ = storage_.directory() / oss.str();
+
+                    for (std::size_t slot{0}; slot < kMaxChunks; ++slot)
+                    {
+                        slots_[slot].store(reinterpret_cast<value_type *>(sentinel_.get()), std::memory_order_relaxed);
+                    }
                 }
 
                 /**
-                 * @brief Destructor. Should delete backing file should it exist.
+                 * @brief Destructor. Should delete backing files should they exist.
                  */
                 ~MappedEventBuffer()
                 {
-                    mapped_file_.close();
-                    if (!file_path_.empty())
+                    while (!chunks_.empty())
                     {
-                        std::error_code ec;
-                        std::filesystem::remove(file_path_, ec);
+                        retire_chunk(std::move(chunks_.front())); // Snapshots may outlive the container
+                        chunks_.pop_front();
+                    }
+                    spare_chunks_.clear(); // Unmap before removing files
+                    std::error_code ec;
+                    std::filesystem::remove_all(directory_path_, ec);
+                    for (const std::filesystem::path &directory_path : stale_directory_paths_)
+                    {
+                        std::filesystem::remove_all(directory_path, ec);
                     }
                 }
 
@@ -98,14 +571,55 @@ class EventData
                 MappedEventBuffer &operator=(MappedEventBuffer &&) noexcept = delete;
 
                 /**
-                 * @brief Appends event data to container
-                 * @param value Event data represented as glm::vec4 (x, y, time, polarity)
+                 * @brief Appends event data to container and publishes it to readers.
+                 * @param value Event data, either glm::vec4 (x, y, time, polarity) or PackedEvent
                  */
                 void push_back(const value_type &value)
                 {
-                    ensure_capacity(size_ + 1);
-                    ptr()[size_] = value;
-                    ++size_;
+                    stage(value);
+                    publish();
+                }
+
+                /**
+                 * @brief Appends event data to container without publishing it, readers keep seeing the old end
+                 *        index until publish is called. Writer only.
+                 * @param value Event data, either glm::vec4 (x, y, time, polarity) or PackedEvent
+                 */
+                void stage(const value_type &value)
+                {
+                    ensure_capacity(staged_end_index_ + 1);
+                    (*this)[staged_end_index_] = value;
+                    ++staged_end_index_;
+                }
+
+                /**
+                 * @brief Appends count elements without publishing them and returns them to be filled in place, see
+                 *        stage. The elements must all fall in one chunk. Writer only.
+                 * @param count number of elements to append.
+                 * @return span over the appended elements.
+                 */
+                std::span<value_type> stage_contiguous(std::size_t count)
+                {
+                    if (count == 0)
+                    {
+                        return {};
+                    }
+                    if ((staged_end_index_ >> kChunkShift) != ((staged_end_index_ + count - 1) >> kChunkShift))
+                    {
+                        throw std::runtime_error("Contiguous elements would straddle EventData buffer chunks.");
+                    }
+                    ensure_capacity(staged_end_index_ + count);
+                    std::span<value_type> span{&(*this)[staged_end_index_], count};
+                    staged_end_index_ += count;
+                    return span;
+                }
+
+                /**
+                 * @brief Publishes all staged elements to readers with a single atomic store. Writer only.
+                 */
+                void publish()
+                {
+                    end_index_.store(staged_end_index_, std::memory_order_release);
                 }
 
                 /**
@@ -114,25 +628,64 @@ class EventData
                  */
                 [[nodiscard]] bool empty() const
                 {
-                    return size_ == 0;
+                    return size() == 0;
                 }
 
                 /**
-                 * @brief Returns number of event data elements in container.
-                 * @return number of event data elements in container.
+                 * @brief Returns number of retained published event data elements in container.
+                 * @return number of retained published event data elements in container.
                  */
                 [[nodiscard]] std::size_t size() const
                 {
-                    return size_;
+                    std::size_t begin{begin_index()};
+                    std::size_t end{end_index()};
+                    return end > begin ? end - begin : 0; // Both move while clearing, never report a negative size
+                }
+
+                /**
+                 * @brief Returns index of the first retained element, 0 unless chunks were evicted.
+                 * @return index of the first retained element.
+                 */
+                [[nodiscard]] std::size_t begin_index() const
+                {
+                    return begin_index_.load(std::memory_order_acquire);
+                }
+
+                /**
+                 * @brief Returns index one past the last published element.
+                 * @return index one past the last published element.
+                 */
+                [[nodiscard]] std::size_t end_index() const
+                {
+                    return end_index_.load(std::memory_order_acquire);
+                }
+
+                /**
+                 * @brief Returns index one past the last staged element, equal to end_index() after publish.
+                 *        Writer only.
+                 * @return index one past the last staged element.
+                 */
+                [[nodiscard]] std::size_t staged_end_index() const
+                {
+                    return staged_end_index_;
                 }
 
                 /**
-                 * @brief Returns the total number of elements that can be added to the backing store.
-                 * @return total number of elements that can be added to the backing store.
+                 * @brief Returns the number of elements the mapped chunks can hold without mapping more.
+                 * @return number of elements the mapped chunks can hold.
                  */
                 [[nodiscard]] std::size_t capacity() const
                 {
-                    return capacity_;
+                    return (chunks_.size() + spare_chunks_.size()) * kChunkCapacity;
+                }
+
+                /**
+                 * @brief Maps chunks up front so that new_capacity elements can be retained without mapping more.
+                 * @param new_capacity number of elements to hold.
+                 */
+                void reserve(std::size_t new_capacity)
+                {
+                    ensure_capacity(begin_index_.load(std::memory_order_relaxed) + new_capacity);
                 }
 
                 /**
@@ -141,62 +694,154 @@ class EventData
                  */
                 [[nodiscard]] std::size_t max_size() const
                 {
-                    return capacity_;
+                    return capacity();
+                }
+
+                /**
+                 * @brief Sets what backs chunks mapped from now on. Chunks already mapped keep their backing and are
+                 *        reused as they are, since lock free readers may still hold their addresses, so storage
+                 *        should be set before elements are added. Writer only.
+                 * @param storage storage settings.
+                 */
+                void set_storage(const StorageConfig &storage)
+                {
+                    std::filesystem::path directory_path{storage.directory() / directory_path_.filename()};
+                    if (directory_path != directory_path_ && chunk_files_ > 0)
+                    {
+                        stale_directory_paths_.push_back(directory_path_); // Still backs mapped chunks
+                    }
+                    directory_path_ = std::move(directory_path);
+                    storage_ = storage;
                 }
 
                 /**
-                 * @brief Clears container.
+                 * @brief Clears container, indices start over at 0. Mapped chunks are kept around to be reused,
+                 *        those snapshots still read once the snapshots are destroyed. Readers racing with a clear may
+                 *        read stale but mapped data and should detect the clear through a generation counter of their
+                 *        own.
                  */
                 void clear()
                 {
-                    size_ = 0;
+                    staged_end_index_ = 0;
+                    end_index_.store(0, std::memory_order_release);
+                    begin_index_.store(0, std::memory_order_release);
+                    if (pins_)
+                    {
+                        // Chunks snapshots read are held back, the others are reused in place
+                        std::deque<Chunk> retained{};
+                        for (Chunk &chunk : chunks_)
+                        {
+                            if (is_pinned(chunk))
+                            {
+                                retire_chunk(std::move(chunk));
+                            }
+                            else
+                            {
+                                retained.push_back(std::move(chunk));
+                            }
+                        }
+                        chunks_ = std::move(retained);
+                    }
+                    for (std::size_t chunk{0}; chunk < chunks_.size(); ++chunk)
+                    {
+                        slots_[chunk].store(chunks_[chunk].data, std::memory_order_relaxed);
+                    }
+                }
+
+                /**
+                 * @brief Evicts the oldest chunk of elements in O(1). Its mapping is kept to be reused by later
+                 *        growth, once no snapshot reads it anymore. Indices of the remaining elements do not change.
+                 *        The chunk currently written to is never evicted. Writer only.
+                 * @return true if a chunk was evicted, false if fewer than two chunks hold data.
+                 */
+                bool pop_front_chunk()
+                {
+                    if (chunk_count() < 2)
+                    {
+                        return false;
+                    }
+                    retire_chunk(std::move(chunks_.front()));
+                    chunks_.pop_front();
+                    begin_index_.store(begin_index_.load(std::memory_order_relaxed) + kChunkCapacity,
+                                       std::memory_order_release);
+                    return true;
+                }
+
+                /**
+                 * @brief Takes a snapshot of the retained published elements, see Snapshot. Writer only.
+                 * @return snapshot of [begin_index(), end_index()).
+                 */
+                Snapshot snapshot()
+                {
+                    if (!pins_)
+                    {
+                        pins_ = std::make_shared<SnapshotPins>();
+                    }
+                    const std::size_t begin{begin_index()};
+                    const std::size_t end{std::max(begin, end_index())};
+                    auto lease = std::make_shared<SnapshotLease>();
+                    lease->pins = pins_;
+                    lease->chunks.reserve(chunk_count());
+
+                    std::lock_guard<std::mutex> pins_lock{pins_->mutex};
+                    for (std::size_t chunk{0}; chunk < chunk_count(); ++chunk)
+                    {
+                        lease->chunks.push_back(chunks_[chunk].data);
+                        ++pins_->readers[chunks_[chunk].data];
+                    }
+                    const value_type *const *chunks{lease->chunks.data()};
+                    return Snapshot{std::shared_ptr<const value_type *const>{std::move(lease), chunks}, begin, end};
                 }
 
                 /**
-                 * @brief Provides indexing access to container.
+                 * @brief Provides indexing access to container. Any index is safe to read, only indices in
+                 *        [begin_index(), end_index()) hold retained data.
                  * @param index index to get event data at.
                  * @return event data at index.
                  */
                 value_type &operator[](std::size_t index)
                 {
-                    return ptr()[index];
+                    return slots_[(index >> kChunkShift) & kSlotMask].load(std::memory_order_relaxed)[index &
+                                                                                                       kChunkMask];
                 }
 
                 /**
-                 * @brief Provides const indexing access to container.
+                 * @brief Provides const indexing access to container. Any index is safe to read, only indices in
+                 *        [begin_index(), end_index()) hold retained data.
                  * @param index index to get event data at.
                  * @return const event data at index.
                  */
                 const value_type &operator[](std::size_t index) const
                 {
-                    return ptr()[index];
+                    return slots_[(index >> kChunkShift) & kSlotMask].load(std::memory_order_relaxed)[index &
+                                                                                                       kChunkMask];
                 }
 
                 /**
-                 * @brief Gets last event data in container.
+                 * @brief Gets last published event data in container.
                  * @return last event data in container.
                  */
                 value_type &back()
                 {
-                    return ptr()[size_ - 1];
+                    return (*this)[end_index() - 1];
                 }
 
                 /**
-                 * @brief Gets last event data in container in const manner.
+                 * @brief Gets last published event data in container in const manner.
                  * @return last const event data in container.
                  */
                 const value_type &back() const
                 {
-                    return ptr()[size_ - 1];
+                    return (*this)[end_index() - 1];
                 }
 
                 /**
-                 * @brief Returns iterator to beginning of container.
-                 * @return iterator to beginning of container.
+                 * @brief Returns iterator to first retained element of container.
+                 * @return iterator to first retained element of container.
                  */
                 iterator begin()
                 {
-                    return ptr();
+                    return iterator{this, begin_index()};
                 }
 
                 /**
@@ -205,16 +850,16 @@ class EventData
                  */
                 iterator end()
                 {
-                    return ptr() + size_;
+                    return iterator{this, end_index()};
                 }
 
                 /**
-                 * @brief Returns const iterator to beginning of container.
-                 * @return const iterator to beginning of container.
+                 * @brief Returns const iterator to first retained element of container.
+                 * @return const iterator to first retained element of container.
                  */
                 const_iterator begin() const
                 {
-                    return ptr();
+                    return const_iterator{this, begin_index()};
                 }
 
                 /**
@@ -223,7 +868,7 @@ class EventData
                  */
                 const_iterator end() const
                 {
-                    return ptr() + size_;
+                    return const_iterator{this, end_index()};
                 }
 
                 /**
@@ -232,7 +877,7 @@ class EventData
                  */
                 const_iterator cbegin() const
                 {
-                    return ptr();
+                    return begin();
                 }
 
                 /**
@@ -241,439 +886,4795 @@ class EventData
                  */
                 const_iterator cend() const
                 {
-                    return ptr() + size_;
+                    return end();
                 }
 
                 /**
-                 * @brief Returns pointer to internal container.
-                 * @return pointer to internal container.
+                 * @brief Returns number of retained chunks currently holding published event data.
+                 * @return number of retained chunks currently holding published event data.
                  */
-                value_type *data()
+                [[nodiscard]] std::size_t chunk_count() const
                 {
-                    return ptr();
+                    std::size_t begin{begin_index()};
+                    std::size_t end{std::max(begin, end_index())};
+                    return ((end + kChunkMask) >> kChunkShift) - (begin >> kChunkShift);
                 }
 
                 /**
-                 * @brief Returns pointer to const to internal container.
-                 * @return pointer to const to internal container.
+                 * @brief Returns the contiguous span of event data stored in a retained chunk.
+                 * @param chunk position of chunk among retained chunks, must be less than chunk_count().
+                 * @return span over the filled part of the chunk.
                  */
-                const value_type *data() const
+                std::span<const value_type> chunk_span(std::size_t chunk) const
                 {
-                    return ptr();
+                    std::size_t first{begin_index() + (chunk << kChunkShift)};
+                    return {&(*this)[first], std::min(kChunkCapacity, end_index() - first)};
                 }
 
-            private:
-                static constexpr std::size_t kInitialCapacity{4096};
-
-                boost::iostreams::mapped_file mapped_file_;
-                std::filesystem::path file_path_;
-                std::size_t size_{0};
-                std::size_t capacity_{0};
-
                 /**
-                 * @brief Like vector. Doubles backing store capacity.
-                 * @param min_capacity Minimum capacity of backing store needed.
+                 * @brief Visits the elements in [first, last) as a sequence of contiguous spans, one per chunk touched.
+                 * @param first index of first element to visit, clamped to begin_index().
+                 * @param last index one past the last element to visit, clamped to end_index().
+                 * @param fn callable taking a std::span<const value_type>.
                  */
-                void ensure_capacity(std::size_t min_capacity)
+                template <typename Fn> void for_each_span(std::size_t first, std::size_t last, Fn &&fn) const
                 {
-                    if (min_capacity <= capacity_)
+                    first = std::max(first, begin_index());
+                    last = std::min(last, end_index());
+                    while (first < last)
                     {
-                        return;
+                        std::size_t offset{first & kChunkMask};
+                        std::size_t count{std::min(kChunkCapacity - offset, last - first)};
+                        fn(std::span<const value_type>{&(*this)[first], count});
+                        first += count;
                     }
+                }
 
-                    std::size_t new_capacity = capacity_ == 0 ? kInitialCapacity : capacity_;
-                    while (new_capacity < min_capacity)
+                /**
+                 * @brief Tells the OS how soon the retained elements in [first, last) are read, so pages are read
+                 *        from disk ahead of use or dropped from memory before hotter ones. Only a hint, contents
+                 *        never change. Writer only, chunks must not be evicted meanwhile.
+                 * @param first index of first element, clamped to begin_index().
+                 * @param last index one past the last element, clamped to end_index().
+                 * @param advice how soon the elements are read.
+                 */
+                void advise(std::size_t first, std::size_t last, AccessAdvice advice) const
+                {
+                    const std::size_t begin{begin_index()};
+                    first = std::max(first, begin);
+                    last = std::min(last, end_index());
+                    const std::size_t page{virtual_memory::page_size()};
+                    while (first < last)
+                    {
+                        const Chunk &chunk{chunks_[(first - begin) >> kChunkShift]};
+                        const std::size_t offset{first & kChunkMask};
+                        const std::size_t count{std::min(kChunkCapacity - offset, last - first)};
+
+                        // Chunks are mapped page aligned. Prefetch every page the range touches, but only drop
+                        // pages that lie completely inside it.
+                        std::size_t byte_first{offset * sizeof(value_type)};
+                        std::size_t byte_last{(offset + count) * sizeof(value_type)};
+                        if (advice == AccessAdvice::WILL_NEED)
+                        {
+                            byte_first = byte_first / page * page;
+                            byte_last = std::min((byte_last + page - 1) / page * page,
+                                                 kChunkCapacity * sizeof(value_type));
+                        }
+                        else
+                        {
+                            byte_first = (byte_first + page - 1) / page * page;
+                            byte_last = byte_last / page * page;
+                        }
+                        if (byte_first < byte_last)
+                        {
+                            std::byte *address{reinterpret_cast<std::byte *>(chunk.data) + byte_first};
+                            if (advice == AccessAdvice::WILL_NEED)
+                            {
+                                virtual_memory::prefetch_pages(address, byte_last - byte_first);
+                            }
+                            else
+                            {
+                                virtual_memory::release_pages(address, byte_last - byte_first, chunk.private_mapping);
+                            }
+                        }
+                        first += count;
+                    }
+                }
+
+                /**
+                 * @brief Writes the retained published elements to directory, one file per chunk named
+                 *        name_(chunk).bin plus name.range holding the begin and end index, so load can map them back.
+                 * @param directory directory to write to, must exist.
+                 * @param name name the files start with.
+                 */
+                void save(const std::filesystem::path &directory, const std::string &name) const
+                {
+                    const std::size_t begin{begin_index()};
+                    save_chunks(directory, name, begin, std::max(begin, end_index()),
+                                [this](std::size_t chunk) -> const value_type * { return chunks_[chunk].data; });
+                }
+
+                /**
+                 * @brief Replaces the contents with elements written by save. Saved chunks are mapped copy on write,
+                 *        so loading costs no copying and later writes never change the saved files. Writer only,
+                 *        readers should detect the change through a generation counter of their own.
+                 * @param directory directory save wrote to.
+                 * @param name name save was given.
+                 */
+                void load(const std::filesystem::path &directory, const std::string &name)
+                {
+                    std::ifstream range_file{directory / (name + ".range"), std::ios::binary};
+                    uint64_t range[2]{};
+                    range_file.read(reinterpret_cast<char *>(range), sizeof(range));
+                    if (!range_file || range[0] % kChunkCapacity != 0 || range[1] < range[0])
+                    {
+                        throw std::runtime_error("Failed to load EventData buffer range.");
+                    }
+
+                    std::deque<Chunk> loaded{};
+                    const std::size_t chunks{((range[1] + kChunkMask) >> kChunkShift) - (range[0] >> kChunkShift)};
+                    for (std::size_t chunk{0}; chunk < chunks; ++chunk)
+                    {
+                        boost::iostreams::mapped_file_params params;
+                        params.path = (directory / saved_chunk_name(name, chunk)).string();
+                        params.flags = boost::iostreams::mapped_file::priv;
+                        Chunk mapped{.private_mapping = true};
+                        mapped.file.open(params);
+                        if (!mapped.file.is_open() || mapped.file.size() != kChunkCapacity * sizeof(value_type))
+                        {
+                            throw std::runtime_error("Failed to load EventData buffer chunk.");
+                        }
+                        mapped.data = reinterpret_cast<value_type *>(mapped.file.data());
+                        loaded.push_back(std::move(mapped));
+                    }
+
+                    while (!chunks_.empty())
+                    {
+                        retire_chunk(std::move(chunks_.front()));
+                        chunks_.pop_front();
+                    }
+                    chunks_ = std::move(loaded);
+                    for (std::size_t chunk{0}; chunk < chunks_.size(); ++chunk)
                     {
-                        new_capacity *= 2;
+                        slots_[((range[0] >> kChunkShift) + chunk) & kSlotMask].store(chunks_[chunk].data,
+                                                                                       std::memory_order_relaxed);
                     }
+                    staged_end_index_ = range[1];
+                    begin_index_.store(range[0], std::memory_order_release);
+                    end_index_.store(range[1], std::memory_order_release);
+                }
+
+            private:
+                // Most chunks a container holds at once, 100 GB of the smallest events fit
+                static constexpr std::size_t kMaxChunks{static_cast<std::size_t>(1) << 14};
+                static constexpr std::size_t kSlotMask{kMaxChunks - 1};
+                static constexpr std::size_t kChunkBytes{kChunkCapacity * sizeof(value_type)};
+
+                // Unmaps anonymous memory, and takes it off the total of anonymous storage if it was counted
+                struct AnonymousDeleter
+                {
+                        std::size_t size;
+                        bool counted;
+
+                        void operator()(std::byte *address) const
+                        {
+                            virtual_memory::unmap_anonymous(address, size);
+                            if (counted)
+                            {
+                                anonymous_storage_bytes.fetch_sub(size, std::memory_order_relaxed);
+                            }
+                        }
+                };
+                using AnonymousMemory = std::unique_ptr<std::byte, AnonymousDeleter>;
+
+                // Backing file or anonymous memory and mapped address of one chunk
+                struct Chunk
+                {
+                        boost::iostreams::mapped_file file;
+                        AnonymousMemory memory;
+                        value_type *data{nullptr};
+                        // Anonymous or mapped copy on write, written pages only live in memory
+                        bool private_mapping{false};
+                };
+
+                // Chunks snapshots read, shared with the snapshots so chunks held back outlive the container
+                struct SnapshotPins
+                {
+                        std::mutex mutex;
+                        std::unordered_map<const value_type *, std::size_t> readers; // Leases reading each chunk
+                        std::vector<Chunk> held;     // Chunks let go of while snapshots still read them
+                        std::vector<Chunk> released; // Held chunks no snapshot reads anymore, reused by the writer
+                };
+
+                // Chunks the copies of one snapshot read, they are let go of when the last copy is destroyed
+                struct SnapshotLease
+                {
+                        std::shared_ptr<SnapshotPins> pins;
+                        std::vector<const value_type *> chunks;
+
+                        ~SnapshotLease()
+                        {
+                            std::lock_guard<std::mutex> pins_lock{pins->mutex};
+                            for (const value_type *data : chunks)
+                            {
+                                auto reader = pins->readers.find(data);
+                                if (--reader->second > 0)
+                                {
+                                    continue;
+                                }
+                                pins->readers.erase(reader);
+                                auto held = std::find_if(pins->held.begin(), pins->held.end(),
+                                                         [data](const Chunk &chunk) { return chunk.data == data; });
+                                if (held != pins->held.end())
+                                {
+                                    pins->released.push_back(std::move(*held));
+                                    pins->held.erase(held);
+                                }
+                            }
+                        }
+                };
+
+                // Reader side: chunk slots indexed by logical chunk number modulo kMaxChunks, never null
+                std::unique_ptr<std::atomic<value_type *>[]> slots_;
+                AnonymousMemory sentinel_; // Slots of chunks never added point here, never written
+                std::atomic<std::size_t> begin_index_{0}; // Always a multiple of kChunkCapacity
+                std::atomic<std::size_t> end_index_{0};   // Published end
 
-                    remap(new_capacity);
+                // Writer side
+                std::deque<Chunk> chunks_;        // Retained chunks, chunks_[0] holds begin_index_
+                std::vector<Chunk> spare_chunks_; // Evicted chunks kept mapped for reuse
+                StorageConfig storage_{};
+                std::filesystem::path directory_path_;
+                std::vector<std::filesystem::path> stale_directory_paths_; // Earlier directories of chunk files
+                std::size_t staged_end_index_{0};
+                std::size_t chunk_files_{0}; // Number of chunk files created, names new files
+                std::shared_ptr<SnapshotPins> pins_; // Created by the first snapshot
+
+                /**
+                 * @brief Adds chunks until the container can hold elements up to index min_end_index. Existing chunks
+                 *        are left untouched.
+                 * @param min_end_index Minimum end index the retained chunks need to hold.
+                 */
+                void ensure_capacity(std::size_t min_end_index)
+                {
+                    while (begin_index_.load(std::memory_order_relaxed) + chunks_.size() * kChunkCapacity <
+                           min_end_index)
+                    {
+                        add_chunk();
+                    }
                 }
 
                 /**
-                 * @brief Remaps internal backing store to a new capacity (changes file size to store capacity
-                 * elements).
-                 * @param new_capacity new capacity of internal backing store.
+                 * @brief Checks whether a snapshot reads a chunk. Writer only.
+                 * @param chunk chunk to check.
+                 * @return true if a snapshot reads the chunk, false otherwise.
                  */
-                void remap(std::size_t new_capacity)
+                bool is_pinned(const Chunk &chunk) const
                 {
-                    const std::size_t bytes = new_capacity * sizeof(value_type);
+                    if (!pins_)
+                    {
+                        return false;
+                    }
+                    std::lock_guard<std::mutex> pins_lock{pins_->mutex};
+                    return pins_->readers.contains(chunk.data);
+                }
 
-                    mapped_file_.close();
+                /**
+                 * @brief Lets go of a chunk no longer retained. It is kept for reuse, or held back until the
+                 *        snapshots reading it are destroyed. Writer only.
+                 * @param chunk chunk to let go of.
+                 */
+                void retire_chunk(Chunk &&chunk)
+                {
+                    if (pins_)
+                    {
+                        std::lock_guard<std::mutex> pins_lock{pins_->mutex};
+                        if (pins_->readers.contains(chunk.data))
+                        {
+                            pins_->held.push_back(std::move(chunk));
+                            return;
+                        }
+                    }
+                    spare_chunks_.push_back(std::move(chunk));
+                }
 
-                    if (bytes == 0)
+                /**
+                 * @brief Takes back held chunks no snapshot reads anymore for reuse. Writer only.
+                 */
+                void reclaim_released_chunks()
+                {
+                    if (!pins_)
                     {
-                        capacity_ = 0;
                         return;
                     }
+                    std::lock_guard<std::mutex> pins_lock{pins_->mutex};
+                    for (Chunk &chunk : pins_->released)
+                    {
+                        spare_chunks_.push_back(std::move(chunk));
+                    }
+                    pins_->released.clear();
+                }
+
+                /**
+                 * @brief Appends a chunk, reusing an evicted one if available and otherwise mapping a new one. Its
+                 *        slot is set before any element of it is published.
+                 */
+                void add_chunk()
+                {
+                    if (chunks_.size() >= kMaxChunks)
+                    {
+                        throw std::runtime_error("Too many chunks in EventData buffer.");
+                    }
+
+                    if (spare_chunks_.empty())
+                    {
+                        reclaim_released_chunks();
+                    }
+                    if (!spare_chunks_.empty())
+                    {
+                        chunks_.push_back(std::move(spare_chunks_.back()));
+                        spare_chunks_.pop_back();
+                    }
+                    else
+                    {
+                        chunks_.push_back(map_chunk());
+                    }
+
+                    std::size_t chunk{(begin_index_.load(std::memory_order_relaxed) >> kChunkShift) +
+                                      chunks_.size() - 1};
+                    slots_[chunk & kSlotMask].store(chunks_.back().data, std::memory_order_relaxed);
+                }
 
+                /**
+                 * @brief Returns file name of a chunk written by save.
+                 * @param name name the files start with.
+                 * @param chunk position of chunk among retained chunks.
+                 * @return file name of chunk.
+                 */
+                static std::string saved_chunk_name(const std::string &name, std::size_t chunk)
+                {
+                    std::ostringstream oss;
+                    oss << name << "_" << chunk << ".bin";
+                    return oss.str();
+                }
+
+                /**
+                 * @brief Writes elements [begin, end) to directory, one file per chunk plus the range, see save.
+                 * @param directory directory to write to, must exist.
+                 * @param name name the files start with.
+                 * @param begin index of the first element, a multiple of kChunkCapacity.
+                 * @param end index one past the last element.
+                 * @param chunk_data callable taking the position of a chunk among the written chunks and returning
+                 *                   its data.
+                 */
+                template <typename ChunkData>
+                static void save_chunks(const std::filesystem::path &directory, const std::string &name,
+                                        std::size_t begin, std::size_t end, ChunkData &&chunk_data)
+                {
+                    const std::size_t chunks{((end + kChunkMask) >> kChunkShift) - (begin >> kChunkShift)};
+                    for (std::size_t chunk{0}; chunk < chunks; ++chunk)
                     {
-                        std::fstream file(file_path_, std::ios::binary | std::ios::in | std::ios::out);
-                        if (!file)
+                        const std::filesystem::path chunk_path{directory / saved_chunk_name(name, chunk)};
+                        std::ofstream chunk_file{chunk_path, std::ios::binary | std::ios::trunc};
+                        const std::size_t filled{std::min(kChunkCapacity, end - begin - (chunk << kChunkShift))};
+                        chunk_file.write(reinterpret_cast<const char *>(chunk_data(chunk)),
+                                         static_cast<std::streamsize>(filled * sizeof(value_type)));
+                        chunk_file.close();
+                        if (!chunk_file)
                         {
-                            std::ofstream create(file_path_, std::ios::binary | std::ios::out | std::ios::trunc);
-                            create.close();
-                            file.open(file_path_, std::ios::binary | std::ios::in | std::ios::out);
+                            throw std::runtime_error("Failed to save EventData buffer chunk.");
                         }
+                        std::filesystem::resize_file(chunk_path, kChunkCapacity * sizeof(value_type));
+                    }
+
+                    std::ofstream range_file{directory / (name + ".range"), std::ios::binary | std::ios::trunc};
+                    uint64_t range[2]{begin, end};
+                    range_file.write(reinterpret_cast<const char *>(range), sizeof(range));
+                    if (!range_file)
+                    {
+                        throw std::runtime_error("Failed to save EventData buffer range.");
+                    }
+                }
 
-                        file.seekp(static_cast<std::streamoff>(bytes) - 1, std::ios::beg);
-                        char zero = 0;
-                        file.write(&zero, 1);
+                /**
+                 * @brief Maps a new chunk, backed as the storage settings ask.
+                 * @return mapped chunk.
+                 */
+                Chunk map_chunk()
+                {
+                    if (storage_.backend != StorageBackend::MAPPED_FILE)
+                    {
+                        // Claim the memory first, several buffers may be growing at once
+                        std::size_t used{anonymous_storage_bytes.fetch_add(kChunkBytes, std::memory_order_relaxed)};
+                        if (storage_.backend == StorageBackend::ANONYMOUS ||
+                            used + kChunkBytes <= storage_.memory_limit)
+                        {
+                            Chunk chunk{.private_mapping = true};
+                            try
+                            {
+                                chunk.memory = AnonymousMemory{
+                                    virtual_memory::map_anonymous(
+                                        kChunkBytes, storage_.huge_pages == HugePageMode::TRANSPARENT_HUGE_PAGES,
+                                        storage_.huge_pages == HugePageMode::EXPLICIT_HUGE_PAGES, storage_.populate),
+                                    AnonymousDeleter{kChunkBytes, true}};
+                            }
+                            catch (...)
+                            {
+                                anonymous_storage_bytes.fetch_sub(kChunkBytes, std::memory_order_relaxed);
+                                throw;
+                            }
+                            chunk.data = reinterpret_cast<value_type *>(chunk.memory.get());
+                            return chunk;
+                        }
+                        anonymous_storage_bytes.fetch_sub(kChunkBytes, std::memory_order_relaxed);
                     }
 
+                    std::filesystem::create_directories(directory_path_);
+
+                    std::ostringstream oss;
+                    oss << "chunk_" << chunk_files_++ << ".bin";
+
                     boost::iostreams::mapped_file_params params;
-                    params.path = file_path_.string();
-                    params.mode = std::ios_base::in | std::ios_base::out;
-                    params.length = bytes;
-                    mapped_file_.open(params);
-                    if (!mapped_file_.is_open())
+                    params.path = (directory_path_ / oss.str()).string();
+                    params.flags = boost::iostreams::mapped_file::readwrite;
+                    params.new_file_size = static_cast<boost::iostreams::stream_offset>(kChunkCapacity *
+                                                                                         sizeof(value_type));
+
+                    Chunk chunk{};
+                    chunk.file.open(params);
+                    if (!chunk.file.is_open())
                     {
                         throw std::runtime_error("Failed to open mapped file for EventData buffer.");
                     }
-                    capacity_ = new_capacity;
+                    chunk.data = reinterpret_cast<value_type *>(chunk.file.data());
+                    return chunk;
+                }
+        };
+
+        /**
+         * @brief Event storage in columns: the time offsets, x, y and polarities of events are each kept in a
+         *        MappedEventBuffer of their own, 9 bytes per event. Scans that test only some fields, e.g. a binary
+         *        search over times or a region of interest filter over coordinates, read only those columns instead
+         *        of pulling whole events through the cache. Events are written and read as PackedEvent like a
+         *        MappedEventBuffer<PackedEvent>, and gathered to that layout for upload. Columns share indices and
+         *        chunk boundaries, the time column is published last and its indices are the ones readers go by, so
+         *        the same single writer, lock-free reader rules apply.
+         */
+        class ColumnarEventBuffer
+        {
+            public:
+                using value_type = PackedEvent;
+
+                static constexpr std::size_t kChunkShift{MappedEventBuffer<uint32_t>::kChunkShift};
+                static constexpr std::size_t kChunkCapacity{MappedEventBuffer<uint32_t>::kChunkCapacity};
+                static constexpr std::size_t kChunkMask{MappedEventBuffer<uint32_t>::kChunkMask};
+
+                /**
+                 * @brief Columns of a run of consecutive events within one storage chunk.
+                 */
+                struct ColumnSpan
+                {
+                        std::size_t first_index;
+                        std::size_t count;
+                        const uint32_t *time_offsets;
+                        const uint16_t *xs;
+                        const uint16_t *ys;
+                        const uint8_t *polarities;
+                };
+
+                /**
+                 * @brief Immutable view of the events published when it was taken, one snapshot per column, see
+                 *        MappedEventBuffer::Snapshot. The time column's indices are the ones to go by.
+                 */
+                struct Snapshot
+                {
+                        MappedEventBuffer<uint32_t>::Snapshot time_offsets;
+                        MappedEventBuffer<uint16_t>::Snapshot xs;
+                        MappedEventBuffer<uint16_t>::Snapshot ys;
+                        MappedEventBuffer<uint8_t>::Snapshot polarities;
+
+                        /**
+                         * @brief Gathers the event at index.
+                         * @param index index in [begin_index(), end_index()).
+                         * @return event in packed layout.
+                         */
+                        PackedEvent operator[](std::size_t index) const
+                        {
+                            return pack_event(xs[index], ys[index], time_offsets[index], polarities[index]);
+                        }
+
+                        [[nodiscard]] std::size_t begin_index() const
+                        {
+                            return time_offsets.begin_index();
+                        }
+
+                        [[nodiscard]] std::size_t end_index() const
+                        {
+                            return time_offsets.end_index();
+                        }
+
+                        /**
+                         * @brief Writes every column to a directory, see ColumnarEventBuffer::save.
+                         * @param directory directory to write to, must exist.
+                         * @param name name the column files start with.
+                         */
+                        void save(const std::filesystem::path &directory, const std::string &name) const
+                        {
+                            time_offsets.save(directory, name + "_time");
+                            xs.save(directory, name + "_x");
+                            ys.save(directory, name + "_y");
+                            polarities.save(directory, name + "_polarity");
+                        }
+                };
+
+                /**
+                 * @brief Appends an event without publishing it, see MappedEventBuffer::stage. Writer only.
+                 * @param evt event to append.
+                 */
+                void stage(const PackedEvent &evt)
+                {
+                    time_offsets_.stage(evt.time_polarity & kPackedTimeMask);
+                    xs_.stage(evt.x);
+                    ys_.stage(evt.y);
+                    polarities_.stage((evt.time_polarity & kPackedPolarityBit) ? 1 : 0);
+                }
+
+                /**
+                 * @brief Publishes all staged events to readers, the time column last. Writer only.
+                 */
+                void publish()
+                {
+                    xs_.publish();
+                    ys_.publish();
+                    polarities_.publish();
+                    time_offsets_.publish();
+                }
+
+                /**
+                 * @brief Maps storage for events up to new_capacity in every column. Writer only.
+                 * @param new_capacity number of events to map storage for.
+                 */
+                void reserve(std::size_t new_capacity)
+                {
+                    time_offsets_.reserve(new_capacity);
+                    xs_.reserve(new_capacity);
+                    ys_.reserve(new_capacity);
+                    polarities_.reserve(new_capacity);
+                }
+
+                /**
+                 * @brief Sets what backs column storage mapped from now on, see MappedEventBuffer::set_storage.
+                 * @param storage storage settings.
+                 */
+                void set_storage(const StorageConfig &storage)
+                {
+                    time_offsets_.set_storage(storage);
+                    xs_.set_storage(storage);
+                    ys_.set_storage(storage);
+                    polarities_.set_storage(storage);
+                }
+
+                /**
+                 * @brief Removes every event, indices start over at 0. Storage stays mapped.
+                 */
+                void clear()
+                {
+                    time_offsets_.clear();
+                    xs_.clear();
+                    ys_.clear();
+                    polarities_.clear();
+                }
+
+                /**
+                 * @brief Evicts the oldest chunk of events of every column, see MappedEventBuffer::pop_front_chunk.
+                 *        Writer only.
+                 * @return true if a chunk was evicted, false if fewer than two chunks hold data.
+                 */
+                bool pop_front_chunk()
+                {
+                    if (!time_offsets_.pop_front_chunk())
+                    {
+                        return false;
+                    }
+                    xs_.pop_front_chunk();
+                    ys_.pop_front_chunk();
+                    polarities_.pop_front_chunk();
+                    return true;
+                }
+
+                /**
+                 * @brief Takes a snapshot of every column, see MappedEventBuffer::snapshot. Writer only.
+                 * @return snapshot of the retained published events.
+                 */
+                Snapshot snapshot()
+                {
+                    return Snapshot{.time_offsets = time_offsets_.snapshot(),
+                                    .xs = xs_.snapshot(),
+                                    .ys = ys_.snapshot(),
+                                    .polarities = polarities_.snapshot()};
+                }
+
+                /**
+                 * @brief Gathers the event at index, see MappedEventBuffer::operator[].
+                 * @param index index of event.
+                 * @return event in packed layout.
+                 */
+                PackedEvent operator[](std::size_t index) const
+                {
+                    return pack_event(xs_[index], ys_[index], time_offsets_[index], polarities_[index]);
+                }
+
+                /**
+                 * @brief Gets the time offset of the event at index from its time segment, reads only the time column.
+                 * @param index index of event.
+                 * @return time offset in microseconds.
+                 */
+                uint32_t time_offset(std::size_t index) const
+                {
+                    return time_offsets_[index];
+                }
+
+                /**
+                 * @brief Gets the position of the event at index, reads only the coordinate columns.
+                 * @param index index of event.
+                 * @return pair of x and y coordinates.
+                 */
+                std::pair<int32_t, int32_t> position(std::size_t index) const
+                {
+                    return {xs_[index], ys_[index]};
+                }
+
+                /**
+                 * @brief Gets the polarity of the event at index, reads only the polarity column.
+                 * @param index index of event.
+                 * @return polarity, 0 or 1.
+                 */
+                uint8_t polarity(std::size_t index) const
+                {
+                    return polarities_[index];
+                }
+
+                /**
+                 * @brief Gets the time column, e.g. for binary searches.
+                 * @return const reference to the time offsets of all events.
+                 */
+                const MappedEventBuffer<uint32_t> &time_offsets() const
+                {
+                    return time_offsets_;
+                }
+
+                [[nodiscard]] std::size_t size() const
+                {
+                    return time_offsets_.size();
+                }
+
+                [[nodiscard]] bool empty() const
+                {
+                    return time_offsets_.empty();
+                }
+
+                [[nodiscard]] std::size_t begin_index() const
+                {
+                    return time_offsets_.begin_index();
+                }
+
+                [[nodiscard]] std::size_t end_index() const
+                {
+                    return time_offsets_.end_index();
+                }
+
+                [[nodiscard]] std::size_t staged_end_index() const
+                {
+                    return time_offsets_.staged_end_index();
+                }
+
+                [[nodiscard]] std::size_t chunk_count() const
+                {
+                    return time_offsets_.chunk_count();
+                }
+
+                /**
+                 * @brief Visits the events in [first, last) as runs of columns, one run per chunk touched.
+                 * @param first index of first event to visit, clamped to begin_index().
+                 * @param last index one past the last event to visit, clamped to end_index().
+                 * @param fn callable taking a const ColumnSpan &.
+                 */
+                template <typename Fn> void for_each_column_span(std::size_t first, std::size_t last, Fn &&fn) const
+                {
+                    first = std::max(first, begin_index());
+                    last = std::min(last, end_index());
+                    while (first < last)
+                    {
+                        std::size_t count{std::min(kChunkCapacity - (first & kChunkMask), last - first)};
+                        fn(ColumnSpan{.first_index = first,
+                                      .count = count,
+                                      .time_offsets = &time_offsets_[first],
+                                      .xs = &xs_[first],
+                                      .ys = &ys_[first],
+                                      .polarities = &polarities_[first]});
+                        first += count;
+                    }
+                }
+
+                /**
+                 * @brief Visits the events in [first, last) gathered to packed layout, in blocks converted into a
+                 *        temporary buffer, see MappedEventBuffer::for_each_span. Spans are only valid during the
+                 *        call to fn.
+                 * @param first index of first event to visit, clamped to begin_index().
+                 * @param last index one past the last event to visit, clamped to end_index().
+                 * @param fn callable taking a std::span<const PackedEvent>.
+                 */
+                template <typename Fn> void for_each_span(std::size_t first, std::size_t last, Fn &&fn) const
+                {
+                    constexpr std::size_t GATHER_SIZE{static_cast<std::size_t>(1) << 14}; // Events gathered at a time
+                    std::vector<PackedEvent> gathered(GATHER_SIZE);
+                    for_each_column_span(first, last, [&](const ColumnSpan &span) {
+                        for (std::size_t offset{0}; offset < span.count; offset += GATHER_SIZE)
+                        {
+                            std::size_t count{std::min(GATHER_SIZE, span.count - offset)};
+                            gather(span, offset, count, gathered.data());
+                            fn(std::span<const PackedEvent>{gathered.data(), count});
+                        }
+                    });
                 }
 
                 /**
-                 * @brief Erases count elements from front.
-                 * @param count number of elements to erase from front of container.
+                 * @brief Gathers events of a run of columns to packed layout, e.g. straight into upload memory.
+                 * @param span run of columns.
+                 * @param offset offset of first event to gather in the run.
+                 * @param count number of events to gather.
+                 * @param out receives count events.
                  */
-                void erase_front(std::size_t count)
+                static void gather(const ColumnSpan &span, std::size_t offset, std::size_t count, PackedEvent *out)
                 {
-                    if (count == 0 || count > size_)
+                    for (std::size_t i{offset}; i < offset + count; ++i)
                     {
-                        return;
+                        *out++ = PackedEvent{span.xs[i], span.ys[i],
+                                             span.time_offsets[i] | (static_cast<uint32_t>(span.polarities[i]) << 31)};
                     }
+                }
+
+                /**
+                 * @brief Advises the storage of every column, see MappedEventBuffer::advise.
+                 * @param first index of first event.
+                 * @param last index one past the last event.
+                 * @param advice how soon the events are read.
+                 */
+                void advise(std::size_t first, std::size_t last, AccessAdvice advice) const
+                {
+                    time_offsets_.advise(first, last, advice);
+                    xs_.advise(first, last, advice);
+                    ys_.advise(first, last, advice);
+                    polarities_.advise(first, last, advice);
+                }
 
-                    value_type *base_ptr = ptr();
-                    std::memmove(base_ptr, base_ptr + count, (size_ - count) * sizeof(value_type));
-                    size_ -= count;
+                /**
+                 * @brief Writes every column to a directory, see MappedEventBuffer::save.
+                 * @param directory directory to write to, must exist.
+                 * @param name name the column files start with.
+                 */
+                void save(const std::filesystem::path &directory, const std::string &name) const
+                {
+                    time_offsets_.save(directory, name + "_time");
+                    xs_.save(directory, name + "_x");
+                    ys_.save(directory, name + "_y");
+                    polarities_.save(directory, name + "_polarity");
                 }
 
                 /**
-                 * @brief Returns pointer to internal data.
-                 * @return pointer to internal data.
+                 * @brief Maps every column written by save, see MappedEventBuffer::load.
+                 * @param directory directory to read from.
+                 * @param name name the column files start with.
                  */
-                value_type *ptr()
+                void load(const std::filesystem::path &directory, const std::string &name)
+                {
+                    xs_.load(directory, name + "_x");
+                    ys_.load(directory, name + "_y");
+                    polarities_.load(directory, name + "_polarity");
+                    time_offsets_.load(directory, name + "_time");
+                }
+
+            private:
+                MappedEventBuffer<uint32_t> time_offsets_;
+                MappedEventBuffer<uint16_t> xs_;
+                MappedEventBuffer<uint16_t> ys_;
+                MappedEventBuffer<uint8_t> polarities_; // 0 or 1
+        };
+
+        /**
+         * @brief IMU sample as stored, accelerations in g, angular velocities in degrees per second.
+         */
+        struct ImuSample
+        {
+                glm::vec3 accelerometer;
+                glm::vec3 gyroscope;
+                float temperature; // Degrees Celsius
+        };
+
+        /**
+         * @brief Time indexed store of a stream recorded next to the events, such as IMU samples or triggers,
+         *        aligned to the event timeline. Columnar like ColumnarEventBuffer: relative timestamps are one column
+         *        and sample values another, so time range queries binary search only the time column. One writer
+         *        appends samples in time order and any number of readers read without locking, the time column is
+         *        published last and its indices are the ones readers go by.
+         * @tparam T sample value type, trivially copyable.
+         */
+        template <typename T> class SampleStore
+        {
+            public:
+                using value_type = T;
+
+                /**
+                 * @brief Appends a sample without publishing it, see MappedEventBuffer::stage. Writer only.
+                 * @param relative_time relative timestamp of the sample, not less than latest_time().
+                 * @param value sample value.
+                 */
+                void stage(int64_t relative_time, const value_type &value)
+                {
+                    values_.stage(value);
+                    times_.stage(relative_time);
+                }
+
+                /**
+                 * @brief Publishes all staged samples to readers, the time column last. Writer only.
+                 */
+                void publish()
+                {
+                    values_.publish();
+                    times_.publish();
+                }
+
+                /**
+                 * @brief Gets the relative timestamp of the newest sample, staged or published. Writer only.
+                 * @return relative timestamp of the newest sample, the lowest int64_t if there are none.
+                 */
+                int64_t latest_time() const
+                {
+                    return times_.staged_end_index() > times_.begin_index() ? times_[times_.staged_end_index() - 1]
+                                                                            : std::numeric_limits<int64_t>::min();
+                }
+
+                /**
+                 * @brief Sets what backs both columns, see MappedEventBuffer::set_storage.
+                 * @param storage storage settings.
+                 */
+                void set_storage(const StorageConfig &storage)
+                {
+                    times_.set_storage(storage);
+                    values_.set_storage(storage);
+                }
+
+                /**
+                 * @brief Removes every sample, indices start over at 0. Storage stays mapped.
+                 */
+                void clear()
+                {
+                    times_.clear();
+                    values_.clear();
+                }
+
+                /**
+                 * @brief Evicts the oldest chunks while all of their samples are older than relative_time. The time
+                 *        column goes first so readers never go by evicted values. Writer only.
+                 * @param relative_time relative timestamp of the oldest sample still needed.
+                 */
+                void evict_before(int64_t relative_time)
+                {
+                    constexpr std::size_t CHUNK{MappedEventBuffer<int64_t>::kChunkCapacity};
+                    while (times_.chunk_count() > 1 && times_[times_.begin_index() + CHUNK] <= relative_time &&
+                           times_.pop_front_chunk())
+                    {
+                        values_.pop_front_chunk();
+                    }
+                }
+
+                /**
+                 * @brief Gets the relative timestamp of the sample at index.
+                 * @param index index of sample.
+                 * @return relative timestamp in microseconds.
+                 */
+                int64_t time(std::size_t index) const
+                {
+                    return times_[index];
+                }
+
+                /**
+                 * @brief Gets the value of the sample at index.
+                 * @param index index of sample.
+                 * @return sample value.
+                 */
+                const value_type &operator[](std::size_t index) const
+                {
+                    return values_[index];
+                }
+
+                [[nodiscard]] std::size_t size() const
+                {
+                    return times_.size();
+                }
+
+                [[nodiscard]] bool empty() const
+                {
+                    return times_.empty();
+                }
+
+                [[nodiscard]] std::size_t begin_index() const
+                {
+                    return times_.begin_index();
+                }
+
+                [[nodiscard]] std::size_t end_index() const
+                {
+                    return times_.end_index();
+                }
+
+                /**
+                 * @brief Finds index of first sample with relative timestamp equal or greater than relative_time.
+                 * @param relative_time relative timestamp in microseconds.
+                 * @return index of sample, end_index() if every sample is earlier.
+                 */
+                std::size_t lower_bound(int64_t relative_time) const
+                {
+                    const std::size_t begin{times_.begin_index()};
+                    auto first = times_.begin();
+                    auto last = first + static_cast<std::ptrdiff_t>(std::max(begin, times_.end_index()) - begin);
+                    return begin + static_cast<std::size_t>(std::lower_bound(first, last, relative_time) - first);
+                }
+
+                /**
+                 * @brief Gets the samples with relative timestamps in [start_time, end_time).
+                 * @param start_time start of time range in microseconds (inclusive).
+                 * @param end_time end of time range in microseconds (exclusive).
+                 * @return pair of index of first sample and index one past the last sample.
+                 */
+                std::pair<std::size_t, std::size_t> index_range(int64_t start_time, int64_t end_time) const
+                {
+                    std::size_t first{lower_bound(start_time)};
+                    return {first, std::max(first, lower_bound(end_time))};
+                }
+
+                /**
+                 * @brief Writes both columns to a directory, see MappedEventBuffer::save.
+                 * @param directory directory to write to, must exist.
+                 * @param name name the column files start with.
+                 */
+                void save(const std::filesystem::path &directory, const std::string &name) const
+                {
+                    times_.save(directory, name + "_time");
+                    values_.save(directory, name + "_values");
+                }
+
+                /**
+                 * @brief Maps both columns written by save, see MappedEventBuffer::load.
+                 * @param directory directory to read from.
+                 * @param name name the column files start with.
+                 */
+                void load(const std::filesystem::path &directory, const std::string &name)
+                {
+                    values_.load(directory, name + "_values");
+                    times_.load(directory, name + "_time");
+                }
+
+            private:
+                MappedEventBuffer<int64_t> times_; // Relative timestamps
+                MappedEventBuffer<value_type> values_;
+        };
+
+        /**
+         * @brief Disk backed store of APS frames. Frames are compressed (PNG, lossless) and appended to backing files
+         *        of kFramesPerFile frames each, a timestamp index of fixed size records is kept in a
+         *        MappedEventBuffer. Decoded frames are kept in a small LRU cache, so RAM use stays bounded no matter
+         *        how many frames are stored. Frames are addressed by logical index, indices only grow until clear,
+         *        [begin_index(), end_index()) are retained. Not thread safe, EventData guards it with evt_lock.
+         */
+        class FrameStore
+        {
+            public:
+                // Frames per backing file, files are deleted whole once all of their frames are evicted
+                static constexpr std::size_t kFramesPerFile{256};
+
+                // Decoded frames cached by default, enough for the frames bracketing the scrubber and some history
+                static constexpr std::size_t kDefaultCacheCapacity{32};
+
+                // Location and format of one stored frame
+                struct FrameRecord
+                {
+                        int64_t timestamp;
+                        uint64_t offset; // Byte offset in the backing file of the frame
+                        uint32_t size;   // Stored size in bytes
+                        int32_t rows;
+                        int32_t cols;
+                        int32_t type;
+                        bool compressed; // PNG if true, raw pixels otherwise
+                };
+
+                // Frame taken from the store by fetch, decoded by decode without the lock guarding the store
+                struct FetchedFrame
+                {
+                        std::size_t index;
+                        uint64_t generation; // Of the store when fetched
+                        FrameRecord record;
+                        bool cached{false};
+                        cv::Mat decoded{};          // If cached
+                        std::vector<uchar> bytes{}; // Stored bytes otherwise
+                };
+
+                /**
+                 * @brief Constructor. Picks directory nova_frame_store_(some number) to hold the backing files.
+                 */
+                FrameStore() : index_{}, cache_capacity_{kDefaultCacheCapacity}
+                {
+                    std::ostringstream oss;
+                    oss << "nova_frame_store_" << std::hex << std::hash<std::thread::id>{}(std::this_thread::get_id())
+                        << "_" << reinterpret_cast<std::uintptr_t>(this);
+                    directory_path_ = std::filesystem::current_path() / oss.str();
+                }
+
+                /**
+                 * @brief Destructor. Should delete backing files should they exist.
+                 */
+                ~FrameStore()
+                {
+                    writer_.close();
+                    reader_.close();
+                    std::error_code ec;
+                    std::filesystem::remove_all(directory_path_, ec);
+                }
+
+                FrameStore(const FrameStore &) = delete;
+                FrameStore &operator=(const FrameStore &) = delete;
+                FrameStore(FrameStore &&) noexcept = delete;
+                FrameStore &operator=(FrameStore &&) noexcept = delete;
+
+                /**
+                 * @brief Compresses a frame the way push_back stores it. Needs no lock, so callers can compress
+                 *        frames before taking the lock guarding the store.
+                 * @param frame frame to compress.
+                 * @return PNG bytes of the frame, empty if the frame is stored uncompressed.
+                 */
+                static std::vector<uchar> encode(const cv::Mat &frame)
+                {
+                    std::vector<uchar> encoded{};
+                    if (is_compressible(frame))
+                    {
+                        cv::imencode(".png", frame, encoded, {cv::IMWRITE_PNG_COMPRESSION, 1});
+                    }
+                    return encoded;
+                }
+
+                /**
+                 * @brief Appends a frame, compressed unless already compressed by encode. Timestamps are expected
+                 *        not to decrease.
+                 * @param frame frame to store, may be empty.
+                 * @param timestamp relative timestamp of the frame.
+                 * @param encoded bytes encode returned for the frame, empty to compress it here.
+                 */
+                void push_back(const cv::Mat &frame, int64_t timestamp, std::span<const uchar> encoded = {})
+                {
+                    std::size_t index{index_.end_index()};
+                    std::size_t file{index / kFramesPerFile};
+                    if (file != writer_file_ || !writer_.is_open())
+                    {
+                        writer_.close();
+                        std::filesystem::create_directories(directory_path_);
+                        // Files start out empty, a loaded store may continue a partly filled one
+                        writer_.open(file_path(file), std::ios::binary | (index % kFramesPerFile == 0
+                                                                              ? std::ios::trunc
+                                                                              : std::ios::app));
+                        if (!writer_.is_open())
+                        {
+                            throw std::runtime_error("Failed to open backing file for EventData frame store.");
+                        }
+                        writer_.seekp(0, std::ios::end);
+                        writer_file_ = file;
+                    }
+
+                    FrameRecord record{.timestamp = timestamp,
+                                       .offset = static_cast<uint64_t>(writer_.tellp()),
+                                       .size = 0,
+                                       .rows = frame.rows,
+                                       .cols = frame.cols,
+                                       .type = frame.type(),
+                                       .compressed = is_compressible(frame)};
+
+                    if (record.compressed)
+                    {
+                        std::vector<uchar> compressed{};
+                        if (encoded.empty())
+                        {
+                            compressed = encode(frame);
+                            encoded = compressed;
+                        }
+                        record.size = static_cast<uint32_t>(encoded.size());
+                        writer_.write(reinterpret_cast<const char *>(encoded.data()),
+                                      static_cast<std::streamsize>(encoded.size()));
+                    }
+                    else if (!frame.empty())
+                    {
+                        cv::Mat continuous{frame.isContinuous() ? frame : frame.clone()};
+                        record.size = static_cast<uint32_t>(continuous.total() * continuous.elemSize());
+                        writer_.write(reinterpret_cast<const char *>(continuous.data), record.size);
+                    }
+                    writer_.flush(); // Readers use a stream of their own
+
+                    index_.push_back(record);
+                }
+
+                /**
+                 * @brief Returns number of retained frames.
+                 * @return number of retained frames.
+                 */
+                [[nodiscard]] std::size_t size() const
+                {
+                    return end_index() - begin_index();
+                }
+
+                /**
+                 * @brief Returns if no frames are retained.
+                 * @return true if no frames are retained, false otherwise.
+                 */
+                [[nodiscard]] bool empty() const
+                {
+                    return size() == 0;
+                }
+
+                /**
+                 * @brief Returns index of the first retained frame, 0 unless frames were evicted.
+                 * @return index of the first retained frame.
+                 */
+                [[nodiscard]] std::size_t begin_index() const
+                {
+                    return begin_index_;
+                }
+
+                /**
+                 * @brief Returns index one past the last stored frame.
+                 * @return index one past the last stored frame.
+                 */
+                [[nodiscard]] std::size_t end_index() const
+                {
+                    return index_.end_index();
+                }
+
+                /**
+                 * @brief Gets the relative timestamp of a frame without decoding it.
+                 * @param index index of frame, in [begin_index(), end_index()).
+                 * @return relative timestamp of frame.
+                 */
+                [[nodiscard]] int64_t timestamp(std::size_t index) const
+                {
+                    return index_[index].timestamp;
+                }
+
+                /**
+                 * @brief Finds the first retained frame with a timestamp not before the given one in O(log n).
+                 * @param timestamp relative timestamp to search for.
+                 * @return index of that frame, end_index() if every frame is earlier.
+                 */
+                [[nodiscard]] std::size_t lower_bound(int64_t timestamp) const
+                {
+                    auto it = std::lower_bound(
+                        MappedEventBuffer<FrameRecord>::const_iterator{&index_, begin_index()}, index_.end(), timestamp,
+                        [](const FrameRecord &record, int64_t value) { return record.timestamp < value; });
+                    return it.index();
+                }
+
+                /**
+                 * @brief Gets a decoded frame, from the cache if it was used recently and from disk otherwise.
+                 *        The returned matrix shares data with the cache entry and must not be modified.
+                 * @param index index of frame, in [begin_index(), end_index()).
+                 * @return decoded frame.
+                 */
+                cv::Mat frame(std::size_t index)
+                {
+                    FetchedFrame fetched{fetch(index)};
+                    if (fetched.cached)
+                    {
+                        return fetched.decoded;
+                    }
+                    cv::Mat decoded{decode(fetched)};
+                    cache(fetched, decoded);
+                    return decoded;
+                }
+
+                /**
+                 * @brief Gets a frame like frame does, but leaves decoding to decode so it can be done without the
+                 *        lock guarding the store. A cached frame comes decoded, any other comes as stored.
+                 * @param index index of frame, in [begin_index(), end_index()).
+                 * @return frame as fetched.
+                 */
+                FetchedFrame fetch(std::size_t index)
+                {
+                    FetchedFrame fetched{.index = index, .generation = generation_, .record = index_[index]};
+                    auto cached = cache_map_.find(index);
+                    if (cached != cache_map_.end())
+                    {
+                        cache_lru_.splice(cache_lru_.begin(), cache_lru_, cached->second);
+                        fetched.cached = true;
+                        fetched.decoded = cached->second->second;
+                    }
+                    else
+                    {
+                        fetched.bytes = read(index);
+                    }
+                    return fetched;
+                }
+
+                /**
+                 * @brief Decodes a fetched frame. Needs no lock.
+                 * @param fetched frame returned by fetch.
+                 * @return decoded frame.
+                 */
+                static cv::Mat decode(const FetchedFrame &fetched)
+                {
+                    const FrameRecord &record{fetched.record};
+                    if (fetched.cached)
+                    {
+                        return fetched.decoded;
+                    }
+                    if (record.size == 0)
+                    {
+                        return cv::Mat(record.rows, record.cols, record.type);
+                    }
+                    if (record.compressed)
+                    {
+                        return cv::imdecode(fetched.bytes, cv::IMREAD_UNCHANGED);
+                    }
+                    cv::Mat raw(record.rows, record.cols, record.type);
+                    std::memcpy(raw.data, fetched.bytes.data(), fetched.bytes.size());
+                    return raw;
+                }
+
+                /**
+                 * @brief Caches a frame decoded by decode, unless the frame was evicted or the store cleared since
+                 *        it was fetched.
+                 * @param fetched frame returned by fetch.
+                 * @param decoded frame decode returned.
+                 */
+                void cache(const FetchedFrame &fetched, const cv::Mat &decoded)
+                {
+                    if (fetched.cached || cache_capacity_ == 0 || fetched.generation != generation_ ||
+                        fetched.index < begin_index_ || fetched.index >= end_index() ||
+                        cache_map_.contains(fetched.index))
+                    {
+                        return;
+                    }
+                    cache_lru_.emplace_front(fetched.index, decoded);
+                    cache_map_[fetched.index] = cache_lru_.begin();
+                    trim_cache();
+                }
+
+                /**
+                 * @brief Sets how many decoded frames are cached, evicting the least recently used ones if needed.
+                 * @param capacity number of decoded frames to cache.
+                 */
+                void set_cache_capacity(std::size_t capacity)
+                {
+                    cache_capacity_ = capacity;
+                    trim_cache();
+                }
+
+                /**
+                 * @brief Returns number of decoded frames currently cached.
+                 * @return number of decoded frames currently cached.
+                 */
+                [[nodiscard]] std::size_t cached_count() const
+                {
+                    return cache_lru_.size();
+                }
+
+                /**
+                 * @brief Evicts every frame with a timestamp before the given one. Backing files and index chunks are
+                 *        released once all of their frames are evicted.
+                 * @param timestamp relative timestamp of the earliest frame to keep.
+                 */
+                void evict_before(int64_t timestamp)
+                {
+                    std::size_t new_begin{lower_bound(timestamp)};
+                    if (new_begin == begin_index_)
+                    {
+                        return;
+                    }
+
+                    for (std::size_t file{begin_index_ / kFramesPerFile}; (file + 1) * kFramesPerFile <= new_begin;
+                         ++file)
+                    {
+                        std::error_code ec;
+                        std::filesystem::remove(file_path(file), ec);
+                    }
+                    if (reader_file_ < new_begin / kFramesPerFile)
+                    {
+                        reader_.close();
+                    }
+
+                    for (auto it = cache_lru_.begin(); it != cache_lru_.end();)
+                    {
+                        if (it->first < new_begin)
+                        {
+                            cache_map_.erase(it->first);
+                            it = cache_lru_.erase(it);
+                        }
+                        else
+                        {
+                            ++it;
+                        }
+                    }
+
+                    begin_index_ = new_begin;
+                    constexpr std::size_t INDEX_CHUNK{MappedEventBuffer<FrameRecord>::kChunkCapacity};
+                    while (index_.begin_index() + INDEX_CHUNK <= begin_index_ && index_.pop_front_chunk())
+                    {
+                    }
+                }
+
+                /**
+                 * @brief Removes every frame and sets where frames are stored from now on, frame files go to the
+                 *        scratch directory and the timestamp index is backed as the settings ask.
+                 * @param storage storage settings.
+                 */
+                void set_storage(const StorageConfig &storage)
+                {
+                    clear();
+                    std::error_code ec;
+                    std::filesystem::remove_all(directory_path_, ec);
+                    directory_path_ = storage.directory() / directory_path_.filename();
+                    index_.set_storage(storage);
+                }
+
+                /**
+                 * @brief Removes every frame and its backing files, indices start over at 0.
+                 */
+                void clear()
+                {
+                    ++generation_;
+                    writer_.close();
+                    reader_.close();
+                    if (index_.end_index() > 0)
+                    {
+                        for (std::size_t file{begin_index_ / kFramesPerFile};
+                             file <= (index_.end_index() - 1) / kFramesPerFile; ++file)
+                        {
+                            std::error_code ec;
+                            std::filesystem::remove(file_path(file), ec);
+                        }
+                    }
+                    index_.clear();
+                    begin_index_ = 0;
+                    cache_lru_.clear();
+                    cache_map_.clear();
+                }
+
+                /**
+                 * @brief Writes the retained frames to directory, see MappedEventBuffer::save. Only the index is
+                 *        written here, the backing files are opened and copied by the returned callable, which
+                 *        may run after the lock guarding the store is released: it copies the bytes of the frames
+                 *        stored so far from the files as opened, so frames stored, evicted or cleared meanwhile
+                 *        do not change what is copied.
+                 * @param directory directory to write to, must exist.
+                 * @param name name the files start with.
+                 * @return callable copying the backing files, throws on failure.
+                 */
+                std::function<void()> save(const std::filesystem::path &directory, const std::string &name) const
+                {
+                    index_.save(directory, name + "_index");
+                    std::ofstream begin_file{directory / (name + ".begin"), std::ios::binary | std::ios::trunc};
+                    uint64_t begin{begin_index_};
+                    begin_file.write(reinterpret_cast<const char *>(&begin), sizeof(begin));
+                    if (!begin_file)
+                    {
+                        throw std::runtime_error("Failed to save EventData frame store.");
+                    }
+
+                    // Bytes of each file up to the end of its last stored frame
+                    auto sources = std::make_shared<std::vector<std::pair<std::ifstream, uint64_t>>>();
+                    std::vector<std::filesystem::path> targets{};
+                    for (std::size_t file{begin_index_ / kFramesPerFile}; file * kFramesPerFile < end_index(); ++file)
+                    {
+                        const FrameRecord &last{index_[std::min((file + 1) * kFramesPerFile, end_index()) - 1]};
+                        sources->emplace_back(std::ifstream{file_path(file), std::ios::binary},
+                                              last.offset + last.size);
+                        targets.push_back(directory / saved_file_name(name, file));
+                    }
+                    return [sources, targets = std::move(targets)]() {
+                        std::vector<char> buffer(static_cast<std::size_t>(1) << 20);
+                        for (std::size_t file{0}; file < targets.size(); ++file)
+                        {
+                            auto &[source, size] = (*sources)[file];
+                            std::ofstream target{targets[file], std::ios::binary | std::ios::trunc};
+                            for (uint64_t copied{0}; copied < size && source && target;)
+                            {
+                                const std::size_t count{
+                                    static_cast<std::size_t>(std::min<uint64_t>(buffer.size(), size - copied))};
+                                source.read(buffer.data(), static_cast<std::streamsize>(count));
+                                target.write(buffer.data(), static_cast<std::streamsize>(count));
+                                copied += count;
+                            }
+                            target.close();
+                            if (!source || !target)
+                            {
+                                throw std::runtime_error("Failed to save EventData frame store.");
+                            }
+                        }
+                    };
+                }
+
+                /**
+                 * @brief Replaces the frames with frames written by save. The compressed frames are copied, the
+                 *        index is mapped copy on write.
+                 * @param directory directory save wrote to.
+                 * @param name name save was given.
+                 */
+                void load(const std::filesystem::path &directory, const std::string &name)
+                {
+                    clear();
+                    std::ifstream begin_file{directory / (name + ".begin"), std::ios::binary};
+                    uint64_t begin{0};
+                    begin_file.read(reinterpret_cast<char *>(&begin), sizeof(begin));
+                    if (!begin_file)
+                    {
+                        throw std::runtime_error("Failed to load EventData frame store.");
+                    }
+
+                    index_.load(directory, name + "_index");
+                    begin_index_ = std::max(static_cast<std::size_t>(begin), index_.begin_index());
+                    std::filesystem::create_directories(directory_path_);
+                    for (std::size_t file{begin_index_ / kFramesPerFile}; file * kFramesPerFile < end_index(); ++file)
+                    {
+                        std::filesystem::copy_file(directory / saved_file_name(name, file), file_path(file),
+                                                   std::filesystem::copy_options::overwrite_existing);
+                    }
+                }
+
+            private:
+                MappedEventBuffer<FrameRecord> index_;
+                std::size_t begin_index_{0};
+                uint64_t generation_{0}; // Counts clears, indices start over on a clear
+
+                std::filesystem::path directory_path_;
+                std::ofstream writer_;
+                std::size_t writer_file_{std::numeric_limits<std::size_t>::max()};
+                std::ifstream reader_;
+                std::size_t reader_file_{std::numeric_limits<std::size_t>::max()};
+
+                // Decoded frames, most recently used first
+                std::list<std::pair<std::size_t, cv::Mat>> cache_lru_;
+                std::unordered_map<std::size_t, std::list<std::pair<std::size_t, cv::Mat>>::iterator> cache_map_;
+                std::size_t cache_capacity_;
+
+                /**
+                 * @brief Returns if a frame can be stored losslessly as PNG.
+                 * @param frame frame to check.
+                 * @return true for 8 and 16 bit frames with 1, 3 or 4 channels.
+                 */
+                static bool is_compressible(const cv::Mat &frame)
+                {
+                    int channels{frame.channels()};
+                    return !frame.empty() && (frame.depth() == CV_8U || frame.depth() == CV_16U) &&
+                           (channels == 1 || channels == 3 || channels == 4);
+                }
+
+                /**
+                 * @brief Returns file name of a backing file written by save.
+                 * @param name name the files start with.
+                 * @param file number of backing file.
+                 * @return file name of backing file.
+                 */
+                static std::string saved_file_name(const std::string &name, std::size_t file)
+                {
+                    std::ostringstream oss;
+                    oss << name << "_" << file << ".bin";
+                    return oss.str();
+                }
+
+                /**
+                 * @brief Returns path of a backing file.
+                 * @param file number of backing file.
+                 * @return path of backing file.
+                 */
+                std::filesystem::path file_path(std::size_t file) const
+                {
+                    std::ostringstream oss;
+                    oss << "frames_" << file << ".bin";
+                    return directory_path_ / oss.str();
+                }
+
+                /**
+                 * @brief Reads the stored bytes of a frame from its backing file.
+                 * @param index index of frame.
+                 * @return stored bytes of frame, empty for an empty frame.
+                 */
+                std::vector<uchar> read(std::size_t index)
+                {
+                    const FrameRecord &record{index_[index]};
+                    if (record.size == 0)
+                    {
+                        return {};
+                    }
+
+                    std::size_t file{index / kFramesPerFile};
+                    if (file != reader_file_ || !reader_.is_open())
+                    {
+                        reader_.close();
+                        reader_.open(file_path(file), std::ios::binary);
+                        if (!reader_.is_open())
+                        {
+                            throw std::runtime_error("Failed to open backing file for EventData frame store.");
+                        }
+                        reader_file_ = file;
+                    }
+
+                    std::vector<uchar> bytes(record.size);
+                    reader_.clear(); // The file may have grown past an end of file seen before
+                    reader_.seekg(static_cast<std::streamoff>(record.offset));
+                    reader_.read(reinterpret_cast<char *>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+                    if (!reader_)
+                    {
+                        throw std::runtime_error("Failed to read frame from EventData frame store.");
+                    }
+                    return bytes;
+                }
+
+                /**
+                 * @brief Drops least recently used decoded frames until the cache fits its capacity.
+                 */
+                void trim_cache()
+                {
+                    while (cache_lru_.size() > cache_capacity_)
+                    {
+                        cache_map_.erase(cache_lru_.back().first);
+                        cache_lru_.pop_back();
+                    }
+                }
+        };
+
+        /**
+         * @brief Pixel rectangle [x, x + width) x [y, y + height) for region of interest queries.
+         */
+        struct RegionOfInterest
+        {
+                int32_t x;
+                int32_t y;
+                int32_t width;
+                int32_t height;
+        };
+
+        /**
+         * @brief Predicate of event scans, see EventData::for_each_matching_evt. An event matches if it lies inside
+         *        roi and, unless polarity is negative, has that polarity.
+         */
+        struct EventFilter
+        {
+                RegionOfInterest roi;
+                int32_t polarity; // 0 or 1, -1 matches both
+        };
+
+        /**
+         * @brief Spatio-temporal secondary index of events. Events are grouped in blocks of kBlockEvents consecutive
+         *        events, for every finished block the offsets of its events are stored sorted by the spatial tile
+         *        (of a kTileGridSize x kTileGridSize grid over the sensor) they fall in, together with where each
+         *        tile's run starts. Queries visit only the runs of the tiles covering a region, so their cost follows
+         *        the number of events near the region instead of the number of events in the time range. Event
+         *        indices match the event buffers. Finished blocks are published like the events, the tile run
+         *        starts before the entries, so queries read them without locking while one writer adds events. The
+         *        block being filled is not visible to queries, see for_each_candidate.
+         */
+        class EventTileIndex
+        {
+            public:
+                static constexpr std::size_t kBlockShift{16};
+                static constexpr std::size_t kBlockEvents{static_cast<std::size_t>(1) << kBlockShift};
+                static constexpr int32_t kTileGridSize{32};
+                static constexpr std::size_t kTiles{static_cast<std::size_t>(kTileGridSize * kTileGridSize)};
+
+                /**
+                 * @brief Sets the sensor resolution tiles are laid out over, should not change until clear. Events
+                 *        outside the resolution belong to the edge tiles, with no resolution set every event belongs
+                 *        to tile 0.
+                 * @param width sensor width in pixels.
+                 * @param height sensor height in pixels.
+                 */
+                void set_resolution(int32_t width, int32_t height)
+                {
+                    tile_scale_x_ = width > 0 ? (static_cast<uint64_t>(kTileGridSize) << 32) / width : 0;
+                    tile_scale_y_ = height > 0 ? (static_cast<uint64_t>(kTileGridSize) << 32) / height : 0;
+                }
+
+                /**
+                 * @brief Indexes the next event, its index is the number of events added since clear.
+                 * @param x x coordinate of the event.
+                 * @param y y coordinate of the event.
+                 */
+                void add(int32_t x, int32_t y)
+                {
+                    if (open_tiles_.empty())
+                    {
+                        open_tiles_.reserve(kBlockEvents);
+                    }
+                    open_tiles_.push_back(static_cast<uint16_t>(tile_y(y) * kTileGridSize + tile_x(x)));
+                    if (open_tiles_.size() == kBlockEvents)
+                    {
+                        seal_block();
+                    }
+                }
+
+                /**
+                 * @brief Visits indices in [first, last) of events of finished blocks in tiles overlapping a region
+                 *        in increasing order. Events near but outside the region may be visited, callers filter by
+                 *        exact position. Events from the returned index on are not indexed yet, callers scan them.
+                 *        Does not lock, the published blocks are read like the events, see EventData::get_evt_view.
+                 * @param roi region of interest.
+                 * @param first index of first event to consider.
+                 * @param last index one past the last event to consider.
+                 * @param fn callable taking the index (std::size_t) of a candidate event.
+                 * @return index of the first event in [first, last) not visited because its block is not finished.
+                 */
+                template <typename Fn>
+                std::size_t for_each_candidate(const RegionOfInterest &roi, std::size_t first, std::size_t last,
+                                               Fn &&fn) const
+                {
+                    // Entries are published after the tile run starts, so blocks with entries have their starts
+                    const std::size_t open_first{entries_.end_index()};
+                    if (roi.width <= 0 || roi.height <= 0)
+                    {
+                        return last;
+                    }
+                    const std::size_t tile_x0{tile_x(roi.x)};
+                    const std::size_t tile_x1{tile_x(roi.x + roi.width - 1)};
+                    const std::size_t tile_y0{tile_y(roi.y)};
+                    const std::size_t tile_y1{tile_y(roi.y + roi.height - 1)};
+
+                    // Finished blocks, gather the runs of covered tiles and restore event order. Runs read while
+                    // evicted storage is reused may be torn, they are clamped to their block.
+                    first = std::max(first, entries_.begin_index());
+                    std::vector<std::size_t> candidates{};
+                    for (std::size_t block{first >> kBlockShift}; block << kBlockShift < std::min(last, open_first);
+                         ++block)
+                    {
+                        const std::size_t block_first{block << kBlockShift};
+                        candidates.clear();
+                        for (std::size_t ty{tile_y0}; ty <= tile_y1; ++ty)
+                        {
+                            for (std::size_t tx{tile_x0}; tx <= tile_x1; ++tx)
+                            {
+                                const std::size_t tile{ty * kTileGridSize + tx};
+                                const std::size_t run_last{
+                                    tile + 1 < kTiles ? std::min<std::size_t>(tile_starts_[block * kTiles + tile + 1],
+                                                                              kBlockEvents)
+                                                      : kBlockEvents};
+                                const std::size_t run_first{
+                                    std::min<std::size_t>(tile_starts_[block * kTiles + tile], run_last)};
+                                for (std::size_t entry{run_first}; entry < run_last; ++entry)
+                                {
+                                    std::size_t index{block_first + entries_[block_first + entry]};
+                                    if (index >= first && index < last)
+                                    {
+                                        candidates.push_back(index);
+                                    }
+                                }
+                            }
+                        }
+                        std::sort(candidates.begin(), candidates.end());
+                        for (std::size_t index : candidates)
+                        {
+                            fn(index);
+                        }
+                    }
+                    return std::clamp(open_first, first, std::max(first, last));
+                }
+
+                /**
+                 * @brief Releases storage of blocks whose events were all evicted, a storage chunk at a time.
+                 * @param begin_index index of the first retained event.
+                 */
+                void evict_before(std::size_t begin_index)
+                {
+                    constexpr std::size_t ENTRIES_CHUNK{MappedEventBuffer<uint16_t>::kChunkCapacity};
+                    constexpr std::size_t STARTS_CHUNK{MappedEventBuffer<uint32_t>::kChunkCapacity};
+                    while (entries_.begin_index() + ENTRIES_CHUNK <= begin_index && entries_.pop_front_chunk())
+                    {
+                    }
+                    while ((tile_starts_.begin_index() + STARTS_CHUNK) / kTiles * kBlockEvents <= begin_index &&
+                           tile_starts_.pop_front_chunk())
+                    {
+                    }
+                }
+
+                /**
+                 * @brief Sets what backs index storage mapped from now on, see MappedEventBuffer::set_storage.
+                 * @param storage storage settings.
+                 */
+                void set_storage(const StorageConfig &storage)
+                {
+                    entries_.set_storage(storage);
+                    tile_starts_.set_storage(storage);
+                }
+
+                /**
+                 * @brief Removes every event, indices start over at 0.
+                 */
+                void clear()
+                {
+                    entries_.clear();
+                    tile_starts_.clear();
+                    open_tiles_.clear();
+                }
+
+                /**
+                 * @brief Writes the index to directory, see MappedEventBuffer::save. The entries, which grow with
+                 *        the events, are snapshotted here and written by the returned callable, which may run after
+                 *        the lock guarding the index is released.
+                 * @param directory directory to write to, must exist.
+                 * @param name name the files start with.
+                 * @return callable writing the entries, throws on failure.
+                 */
+                std::function<void()> save(const std::filesystem::path &directory, const std::string &name)
+                {
+                    tile_starts_.save(directory, name + "_starts");
+                    std::ofstream open_file{directory / (name + "_open.bin"), std::ios::binary | std::ios::trunc};
+                    open_file.write(reinterpret_cast<const char *>(open_tiles_.data()),
+                                    static_cast<std::streamsize>(open_tiles_.size() * sizeof(uint16_t)));
+                    if (!open_file)
+                    {
+                        throw std::runtime_error("Failed to save EventData tile index.");
+                    }
+                    return [entries = entries_.snapshot(), directory, name]() {
+                        entries.save(directory, name + "_entries");
+                    };
+                }
+
+                /**
+                 * @brief Replaces the index with an index written by save.
+                 * @param directory directory save wrote to.
+                 * @param name name save was given.
+                 */
+                void load(const std::filesystem::path &directory, const std::string &name)
+                {
+                    clear();
+                    entries_.load(directory, name + "_entries");
+                    tile_starts_.load(directory, name + "_starts");
+
+                    const std::filesystem::path open_path{directory / (name + "_open.bin")};
+                    std::ifstream open_file{open_path, std::ios::binary};
+                    open_tiles_.resize(std::filesystem::file_size(open_path) / sizeof(uint16_t));
+                    open_file.read(reinterpret_cast<char *>(open_tiles_.data()),
+                                   static_cast<std::streamsize>(open_tiles_.size() * sizeof(uint16_t)));
+                    if (!open_file || open_tiles_.size() >= kBlockEvents)
+                    {
+                        throw std::runtime_error("Failed to load EventData tile index.");
+                    }
+                }
+
+            private:
+                static_assert(kTiles <= (static_cast<std::size_t>(1) << 16), "Tiles of open events are 16 bit.");
+                static_assert(MappedEventBuffer<uint32_t>::kChunkCapacity % kTiles == 0,
+                              "Tile starts of a block must fit in one chunk.");
+
+                // Offsets within their block of the events of finished blocks, grouped by tile, kBlockEvents per block
+                MappedEventBuffer<uint16_t> entries_;
+                // Offset in entries_ within its block where each tile's run starts, kTiles per finished block
+                MappedEventBuffer<uint32_t> tile_starts_;
+                // Tile of each event of the block being filled
+                std::vector<uint16_t> open_tiles_;
+
+                std::vector<uint16_t> sorted_; // Scratch for sealing blocks
+
+                // Fixed point (32 fractional bits) tiles per pixel
+                uint64_t tile_scale_x_{0};
+                uint64_t tile_scale_y_{0};
+
+                /**
+                 * @brief Returns the tile column of a pixel column.
+                 * @param x x coordinate.
+                 * @return tile column, clamped to the grid.
+                 */
+                std::size_t tile_x(int32_t x) const
+                {
+                    uint64_t tile{(static_cast<uint64_t>(std::max(x, 0)) * tile_scale_x_) >> 32};
+                    return static_cast<std::size_t>(std::min(tile, static_cast<uint64_t>(kTileGridSize - 1)));
+                }
+
+                /**
+                 * @brief Returns the tile row of a pixel row.
+                 * @param y y coordinate.
+                 * @return tile row, clamped to the grid.
+                 */
+                std::size_t tile_y(int32_t y) const
+                {
+                    uint64_t tile{(static_cast<uint64_t>(std::max(y, 0)) * tile_scale_y_) >> 32};
+                    return static_cast<std::size_t>(std::min(tile, static_cast<uint64_t>(kTileGridSize - 1)));
+                }
+
+                /**
+                 * @brief Sorts the offsets of the filled open block by tile (counting sort, stable so runs stay in
+                 *        event order) and appends them with the tile run starts, written in place in the mapped
+                 *        storage.
+                 */
+                void seal_block()
+                {
+                    std::array<uint32_t, kTiles> starts{};
+                    for (uint16_t tile : open_tiles_)
+                    {
+                        ++starts[tile];
+                    }
+                    std::span<uint32_t> tile_starts{tile_starts_.stage_contiguous(kTiles)};
+                    uint32_t start{0};
+                    for (std::size_t tile{0}; tile < kTiles; ++tile)
+                    {
+                        uint32_t count{starts[tile]};
+                        starts[tile] = start;
+                        tile_starts[tile] = start;
+                        start += count;
+                    }
+                    tile_starts_.publish();
+
+                    // Scatter in cache, then copy to the mapped storage sequentially
+                    sorted_.resize(kBlockEvents);
+                    for (std::size_t offset{0}; offset < kBlockEvents; ++offset)
+                    {
+                        sorted_[starts[open_tiles_[offset]]++] = static_cast<uint16_t>(offset);
+                    }
+                    std::span<uint16_t> entries{entries_.stage_contiguous(kBlockEvents)};
+                    std::copy(sorted_.begin(), sorted_.end(), entries.begin());
+                    entries_.publish();
+                    open_tiles_.clear();
+                }
+        };
+
+        // Internal structs
+        // Represents single event datum
+        struct EventDatum
+        {
+                int32_t x;
+                int32_t y;
+                int64_t timestamp;
+                uint8_t polarity;
+        };
+
+        // Represents single IMU sample
+        struct ImuDatum
+        {
+                int64_t timestamp;
+                ImuSample sample;
+        };
+
+        // Represents single trigger, type is the dv::TriggerType of the camera
+        struct TriggerDatum
+        {
+                int64_t timestamp;
+                uint8_t type;
+        };
+
+        /**
+         * @brief Compressed copies of full storage chunks of events, for scrubbing recordings larger than RAM. Events
+         *        are sealed in blocks of kBlockEvents consecutive events. A block holds the time deltas between its
+         *        events, the x and y coordinates and a polarity bitmap, each bit packed with the fewest bits the
+         *        block needs, so a block is a few bits per event instead of 8 or 16 bytes. Every stream of a block
+         *        is a whole number of words and a block never straddles storage chunks, so a block decodes from one
+         *        pointer with fixed width loops. Event indices match the event buffers, block i holds events
+         *        [i * kBlockEvents, (i + 1) * kBlockEvents). Written by one writer holding evt_lock and read without
+         *        locking like the event buffers, see get_evt_view.
+         */
+        class SealedEventStore
+        {
+            public:
+                static constexpr std::size_t kBlockShift{12};
+                static constexpr std::size_t kBlockEvents{static_cast<std::size_t>(1) << kBlockShift};
+                // Words per bit of event, every stream of a block holds kBlockEvents values of a fixed width
+                static constexpr std::size_t kBlockWords{kBlockEvents / 64};
+
+                /**
+                 * @brief Gets the index one past the last sealed event.
+                 * @return end index of sealed events.
+                 */
+                std::size_t end_index() const
+                {
+                    return blocks_.end_index() << kBlockShift;
+                }
+
+                /**
+                 * @brief Gets the memory used by sealed events.
+                 * @return bytes of compressed event data and block headers.
+                 */
+                std::size_t compressed_bytes() const
+                {
+                    return (words_.end_index() - words_.begin_index()) * sizeof(uint64_t) +
+                           (blocks_.end_index() - blocks_.begin_index()) * sizeof(Block);
+                }
+
+                /**
+                 * @brief Seals the next block of events. Writer only.
+                 * @param evts kBlockEvents events with relative timestamps in increasing order.
+                 */
+                void seal(std::span<const EventDatum> evts)
+                {
+                    uint64_t max_delta{0};
+                    uint32_t max_x{0};
+                    uint32_t max_y{0};
+                    for (std::size_t i{0}; i < kBlockEvents; ++i)
+                    {
+                        int64_t delta{i == 0 ? 0 : evts[i].timestamp - evts[i - 1].timestamp};
+                        max_delta = std::max(max_delta, static_cast<uint64_t>(delta));
+                        max_x = std::max(max_x, static_cast<uint32_t>(evts[i].x));
+                        max_y = std::max(max_y, static_cast<uint32_t>(evts[i].y));
+                    }
+
+                    Block block{.word_offset = 0,
+                                .base_time = evts[0].timestamp,
+                                .time_bits = static_cast<uint8_t>(std::bit_width(max_delta)),
+                                .x_bits = static_cast<uint8_t>(std::bit_width(max_x)),
+                                .y_bits = static_cast<uint8_t>(std::bit_width(max_y))};
+                    const std::size_t coord_bits{static_cast<std::size_t>(block.x_bits) + block.y_bits};
+                    const std::size_t word_count{(block.time_bits + coord_bits + 1) * kBlockWords};
+
+                    // Pad to the next chunk rather than straddle chunks
+                    constexpr std::size_t WORDS_CHUNK{MappedEventBuffer<uint64_t>::kChunkCapacity};
+                    std::size_t chunk_used{words_.staged_end_index() & (WORDS_CHUNK - 1)};
+                    if (chunk_used + word_count > WORDS_CHUNK)
+                    {
+                        std::ranges::fill(words_.stage_contiguous(WORDS_CHUNK - chunk_used), 0);
+                    }
+                    block.word_offset = words_.staged_end_index();
+                    std::span<uint64_t> words{words_.stage_contiguous(word_count)};
+                    std::ranges::fill(words, 0);
+
+                    uint64_t *time_words{words.data()};
+                    uint64_t *coord_words{time_words + block.time_bits * kBlockWords};
+                    uint64_t *polarity_words{coord_words + coord_bits * kBlockWords};
+                    for (std::size_t i{0}; i < kBlockEvents; ++i)
+                    {
+                        uint64_t delta{i == 0 ? 0 : static_cast<uint64_t>(evts[i].timestamp - evts[i - 1].timestamp)};
+                        uint64_t coord{static_cast<uint64_t>(static_cast<uint32_t>(evts[i].x)) |
+                                       static_cast<uint64_t>(static_cast<uint32_t>(evts[i].y)) << block.x_bits};
+                        put_bits(time_words, i * block.time_bits, block.time_bits, delta);
+                        put_bits(coord_words, i * coord_bits, coord_bits, coord);
+                        polarity_words[i / 64] |= static_cast<uint64_t>(evts[i].polarity != 0) << (i % 64);
+                    }
+                    words_.publish();
+                    blocks_.push_back(block); // Published after its words
+                }
+
+                /**
+                 * @brief Decodes sealed events into their storage format with times rebased to an offset from
+                 *        time_base, the same as EventData::for_each_evt_span passes them. Does not lock.
+                 * @param first index of first event, at least the first retained event.
+                 * @param last index one past the last event, at most end_index().
+                 * @param time_base relative time in microseconds event times are rebased to.
+                 * @param out receives last - first events.
+                 */
+                template <typename T>
+                void decode(std::size_t first, std::size_t last, int64_t time_base, T *out) const
+                {
+                    while (first < last)
+                    {
+                        const std::size_t block_first{first & ~(kBlockEvents - 1)};
+                        const std::size_t from{first - block_first};
+                        const std::size_t to{std::min(last - block_first, kBlockEvents)};
+                        const Block block{blocks_[first >> kBlockShift]};
+                        const std::size_t time_bits{block.time_bits};
+                        const std::size_t coord_bits{static_cast<std::size_t>(block.x_bits) + block.y_bits};
+                        const uint64_t x_mask{(static_cast<uint64_t>(1) << block.x_bits) - 1};
+                        const uint64_t *time_words{&words_[block.word_offset]};
+                        const uint64_t *coord_words{time_words + time_bits * kBlockWords};
+                        const uint64_t *polarity_words{coord_words + coord_bits * kBlockWords};
+
+                        // Deltas before the range only advance the time, the delta of the first event is 0
+                        int64_t time{block.base_time - time_base};
+                        for (std::size_t i{0}; i < from; ++i)
+                        {
+                            time += static_cast<int64_t>(read_bits(time_words, (i + 1) * time_bits, time_bits));
+                        }
+                        for (std::size_t i{from}; i < to; ++i)
+                        {
+                            uint64_t coord{read_bits(coord_words, i * coord_bits, coord_bits)};
+                            EventDatum evt{.x = static_cast<int32_t>(coord & x_mask),
+                                           .y = static_cast<int32_t>(coord >> block.x_bits),
+                                           .timestamp = 0,
+                                           .polarity = static_cast<uint8_t>((polarity_words[i / 64] >> (i % 64)) & 1)};
+                            make_evt(evt, time, *out++);
+                            time += static_cast<int64_t>(read_bits(time_words, (i + 1) * time_bits, time_bits));
+                        }
+                        first = block_first + to;
+                    }
+                }
+
+                /**
+                 * @brief Evicts whole chunks of blocks and words that only hold events before begin_index. Writer
+                 *        only.
+                 * @param begin_index index of first retained event.
+                 */
+                void evict_before(std::size_t begin_index)
+                {
+                    std::size_t first_block{begin_index >> kBlockShift};
+                    if (first_block >= blocks_.end_index())
+                    {
+                        return;
+                    }
+                    constexpr std::size_t WORDS_CHUNK{MappedEventBuffer<uint64_t>::kChunkCapacity};
+                    constexpr std::size_t BLOCKS_CHUNK{MappedEventBuffer<Block>::kChunkCapacity};
+                    while (words_.begin_index() + WORDS_CHUNK <= blocks_[first_block].word_offset &&
+                           words_.pop_front_chunk())
+                    {
+                    }
+                    while (blocks_.begin_index() + BLOCKS_CHUNK <= first_block && blocks_.pop_front_chunk())
+                    {
+                    }
+                }
+
+                /**
+                 * @brief Sets what backs sealed storage mapped from now on, see MappedEventBuffer::set_storage.
+                 * @param storage storage settings.
+                 */
+                void set_storage(const StorageConfig &storage)
+                {
+                    blocks_.set_storage(storage);
+                    words_.set_storage(storage);
+                }
+
+                /**
+                 * @brief Removes every sealed event, indices start over at 0.
+                 */
+                void clear()
+                {
+                    blocks_.clear();
+                    words_.clear();
+                }
+
+            private:
+                // Where a block's streams start and how wide their values are
+                struct Block
+                {
+                        std::size_t word_offset; // Index in words_ of the time stream, followed by coords and polarity
+                        int64_t base_time;       // Relative time of the first event
+                        uint8_t time_bits;
+                        uint8_t x_bits;
+                        uint8_t y_bits;
+                };
+
+                MappedEventBuffer<Block> blocks_;
+                MappedEventBuffer<uint64_t> words_;
+
+                /**
+                 * @brief Writes a value into a zeroed bit stream.
+                 * @param words bit stream.
+                 * @param bit_offset offset of the value in bits.
+                 * @param bits width of the value in bits, at most 64.
+                 * @param value value to write, fits in bits.
+                 */
+                static void put_bits(uint64_t *words, std::size_t bit_offset, std::size_t bits, uint64_t value)
+                {
+                    if (bits == 0)
+                    {
+                        return;
+                    }
+                    std::size_t shift{bit_offset % 64};
+                    words[bit_offset / 64] |= value << shift;
+                    if (shift + bits > 64)
+                    {
+                        words[bit_offset / 64 + 1] |= value >> (64 - shift);
+                    }
+                }
+
+                /**
+                 * @brief Reads a value from a bit stream without branching. The stream must be followed by at least
+                 *        one more word, the word after a value is read even if the value does not reach into it.
+                 * @param words bit stream.
+                 * @param bit_offset offset of the value in bits.
+                 * @param bits width of the value in bits, at most 63.
+                 * @return value read.
+                 */
+                static uint64_t read_bits(const uint64_t *words, std::size_t bit_offset, std::size_t bits)
+                {
+                    std::size_t shift{bit_offset % 64};
+                    const uint64_t *word{words + bit_offset / 64};
+                    // Two shifts so a shift of 0 does not shift the next word by 64
+                    uint64_t value{(word[0] >> shift) | ((word[1] << 1) << (63 - shift))};
+                    return value & ((static_cast<uint64_t>(1) << bits) - 1);
+                }
+        };
+
+        // Represents a single frame datum
+        struct FrameDatum
+        {
+                cv::Mat frameData;
+                int64_t timestamp;
+                std::vector<uchar> encoded{}; // frameData compressed by FrameStore::encode, empty if not yet
+        };
+
+        /**
+         * @brief Consistent view of the published events, see get_evt_view. Events in [begin_index, end_index) can
+         *        be read without locking, is_evt_view_current tells afterwards whether they were overwritten while
+         *        being read.
+         */
+        struct EventView
+        {
+                uint64_t generation;
+                std::size_t begin_index;
+                std::size_t end_index;
+        };
+
+        /**
+         * @brief Immutable handle over the events published when it was taken, see get_evt_snapshot. Unlike an
+         *        EventView it stays valid across eviction, clears and camera resets: the storage chunks it reads,
+         *        sealed or not, are held back from reuse until its last copy is destroyed, so a background job can
+         *        read it for as long as it likes while events keep being appended. Copies share the held storage and
+         *        may be read and destroyed on any thread.
+         */
+        class EventSnapshot
+        {
+            private:
+                friend class EventData;
+
+                EventFormat format_{EventFormat::VEC4};
+                // Only the snapshot of the format stored when it was taken holds events
+                MappedEventBuffer<glm::vec4>::Snapshot vec4_evts_;
+                MappedEventBuffer<PackedEvent>::Snapshot packed_evts_;
+                ColumnarEventBuffer::Snapshot columnar_evts_;
+                MappedEventBuffer<TimeSegment>::Snapshot time_segments_;
+                int64_t earliest_timestamp_{-1};
+                std::size_t begin_index_{0};
+                std::size_t end_index_{0};
+
+                /**
+                 * @brief Calls fn with the event snapshot of the stored format.
+                 * @param fn callable taking a snapshot of a MappedEventBuffer or ColumnarEventBuffer.
+                 * @return what fn returns.
+                 */
+                template <typename Fn> decltype(auto) visit_evts(Fn &&fn) const
+                {
+                    switch (format_)
+                    {
+                    case EventFormat::PACKED:
+                        return fn(packed_evts_);
+                    case EventFormat::COLUMNAR:
+                        return fn(columnar_evts_);
+                    default:
+                        return fn(vec4_evts_);
+                    }
+                }
+
+                /**
+                 * @brief Finds the time segment holding the event at index.
+                 * @param index index of event.
+                 * @return index of time segment.
+                 */
+                std::size_t segment_of(std::size_t index) const
+                {
+                    std::size_t first{time_segments_.begin_index()};
+                    std::size_t count{time_segments_.size()};
+                    while (count > 0)
+                    {
+                        std::size_t step{count / 2};
+                        if (time_segments_[first + step].first_index <= index)
+                        {
+                            first += step + 1;
+                            count -= step + 1;
+                        }
+                        else
+                        {
+                            count = step;
+                        }
+                    }
+                    return std::max(first, time_segments_.begin_index() + 1) - 1;
+                }
+
+                /**
+                 * @brief Stored time offset of an event from its time segment base.
+                 * @param evt stored event.
+                 * @return time offset in microseconds.
+                 */
+                static int64_t time_offset(const glm::vec4 &evt)
+                {
+                    return static_cast<int64_t>(evt.z);
+                }
+
+                /**
+                 * @brief Stored time offset of an event from its time segment base.
+                 * @param evt stored event.
+                 * @return time offset in microseconds.
+                 */
+                static int64_t time_offset(const PackedEvent &evt)
+                {
+                    return static_cast<int64_t>(evt.time_polarity & kPackedTimeMask);
+                }
+
+            public:
+                /**
+                 * @brief Default constructor, holds no events.
+                 */
+                EventSnapshot() = default;
+
+                /**
+                 * @brief Gets index of the first event of the snapshot.
+                 * @return index of the first event.
+                 */
+                std::size_t get_begin_index() const
+                {
+                    return begin_index_;
+                }
+
+                /**
+                 * @brief Gets index one past the last event of the snapshot.
+                 * @return index one past the last event.
+                 */
+                std::size_t get_end_index() const
+                {
+                    return end_index_;
+                }
+
+                /**
+                 * @brief Gets number of events in the snapshot.
+                 * @return number of events.
+                 */
+                std::size_t get_evt_count() const
+                {
+                    return end_index_ - begin_index_;
+                }
+
+                /**
+                 * @brief Gets the earliest event timestamp when the snapshot was taken, see
+                 *        EventData::get_earliest_evt_timestamp.
+                 * @return earliest event timestamp, -1 if there were no events.
+                 */
+                int64_t get_earliest_evt_timestamp() const
+                {
+                    return earliest_timestamp_;
+                }
+
+                /**
+                 * @brief Gets event at index decoded as glm::vec4 (x, y, relative time, polarity), see
+                 *        EventData::get_evt.
+                 * @param index index of event in [get_begin_index(), get_end_index()).
+                 * @return decoded event.
+                 */
+                glm::vec4 get_evt(std::size_t index) const
+                {
+                    glm::vec4 evt{visit_evts([index](const auto &evts) { return unpack_event(evts[index]); })};
+                    evt.z = static_cast<float>(get_evt_relative_time(index));
+                    return evt;
+                }
+
+                /**
+                 * @brief Gets exact relative timestamp of event at index.
+                 * @param index index of event in [get_begin_index(), get_end_index()).
+                 * @return relative timestamp of event in microseconds.
+                 */
+                int64_t get_evt_relative_time(std::size_t index) const
+                {
+                    return time_segments_[segment_of(index)].base_time +
+                           visit_evts([index](const auto &evts) { return time_offset(evts[index]); });
+                }
+
+                /**
+                 * @brief Finds index of first event with relative timestamp equal or greater than timestamp.
+                 * @param timestamp relative timestamp in microseconds.
+                 * @return index of event, get_end_index() if every event is earlier.
+                 */
+                std::size_t get_event_index_from_relative_timestamp(int64_t timestamp) const
+                {
+                    std::size_t first{begin_index_};
+                    std::size_t count{end_index_ - begin_index_};
+                    while (count > 0)
+                    {
+                        std::size_t step{count / 2};
+                        if (get_evt_relative_time(first + step) < timestamp)
+                        {
+                            first += step + 1;
+                            count -= step + 1;
+                        }
+                        else
+                        {
+                            count = step;
+                        }
+                    }
+                    return first;
+                }
+
+                /**
+                 * @brief Visits the events in [first, last) in order as EventDatum with relative timestamps.
+                 * @param first index of first event, clamped to get_begin_index().
+                 * @param last index one past the last event, clamped to get_end_index().
+                 * @param fn callable taking the index of an event and a const EventDatum &.
+                 */
+                template <typename Fn> void for_each_evt(std::size_t first, std::size_t last, Fn &&fn) const
+                {
+                    first = std::max(first, begin_index_);
+                    last = std::min(last, end_index_);
+                    if (first >= last)
+                    {
+                        return;
+                    }
+                    visit_evts([&](const auto &evts) {
+                        std::size_t segment{segment_of(first)};
+                        for (std::size_t index{first}; index < last; ++index)
+                        {
+                            while (segment + 1 < time_segments_.end_index() &&
+                                   time_segments_[segment + 1].first_index <= index)
+                            {
+                                ++segment;
+                            }
+                            const auto evt = evts[index];
+                            const glm::vec4 unpacked{unpack_event(evt)};
+                            fn(index, EventDatum{.x = static_cast<int32_t>(unpacked.x),
+                                                 .y = static_cast<int32_t>(unpacked.y),
+                                                 .timestamp = time_segments_[segment].base_time + time_offset(evt),
+                                                 .polarity = static_cast<uint8_t>(unpacked.w)});
+                        }
+                    });
+                }
+        };
+
+        /**
+         * @brief Statistics of timestamp disorder seen by the reorder stage, see get_reorder_stats.
+         */
+        struct ReorderStats
+        {
+                uint64_t reordered_evts; // Events that arrived before an event with a later timestamp
+                uint64_t dropped_evts;   // Events that arrived after later events were already stored
+                uint64_t dropped_frames; // Frames older than the latest frame, but not old enough for a reset
+                uint64_t resets;         // Camera resets detected, each clears all data
+                int64_t max_disorder;    // Largest backward jump below the reset threshold in microseconds
+                std::size_t held_evts;   // Events currently held back for reordering
+        };
+
+        /**
+         * @brief Sorts events that arrive slightly out of order, e.g. from merged USB packets or converted datasets,
+         *        before they are stored. Events are held until no event within the tolerance of their timestamp can
+         *        still arrive, i.e. until an event later by more than the tolerance was seen, and are then released as
+         *        one sorted batch. Held events are kept in a vector sorted by timestamp, as disorder is local an out of
+         *        order event is inserted close to the end. Released events are erased from the front lazily, once
+         *        they make up half of the vector, so each event is moved O(1) times on average. An event older than
+         *        the latest one by more than the reset threshold is a camera reset: everything held is released
+         *        first, then the event starts over. With a tolerance and reset threshold of 0 events pass straight
+         *        through and any decreasing timestamp is a reset.
+         */
+        class ReorderBuffer
+        {
+            public:
+                /**
+                 * @brief Default constructor, events pass straight through.
+                 */
+                ReorderBuffer() = default;
+
+                /**
+                 * @brief Sets how much disorder is sorted out. Takes effect with the next events pushed.
+                 * @param tolerance microseconds events are held for reordering.
+                 * @param reset_threshold microseconds a timestamp must go back by to be a camera reset, at least
+                 *        the tolerance.
+                 */
+                void set_tolerance(int64_t tolerance, int64_t reset_threshold)
+                {
+                    tolerance_ = std::max(tolerance, int64_t{0});
+                    reset_threshold_ = std::max(reset_threshold, tolerance_);
+                }
+
+                /**
+                 * @brief Gets the microseconds events are held for reordering.
+                 * @return reorder tolerance in microseconds.
+                 */
+                int64_t get_tolerance() const
+                {
+                    return tolerance_;
+                }
+
+                /**
+                 * @brief Gets the microseconds a timestamp must go back by to be a camera reset.
+                 * @return reset threshold in microseconds.
+                 */
+                int64_t get_reset_threshold() const
+                {
+                    return reset_threshold_;
+                }
+
+                /**
+                 * @brief Adds events in order of arrival and releases those that can no longer be reordered.
+                 * @param raw_evt_data raw event data to add.
+                 * @param release callable taking a std::span<const EventDatum> of events sorted by timestamp, called
+                 *        for every released batch. A batch starting below the end of the previous one follows a reset.
+                 */
+                template <typename Release> void push(std::span<const EventDatum> raw_evt_data, Release &&release)
+                {
+                    if (tolerance_ == 0 && reset_threshold_ == 0)
+                    {
+                        release(raw_evt_data);
+                        return;
+                    }
+
+                    for (const EventDatum &raw_evt : raw_evt_data)
+                    {
+                        if (latest_timestamp_ >= 0 && raw_evt.timestamp < latest_timestamp_ - reset_threshold_)
+                        {
+                            flush(release);
+                            latest_timestamp_ = -1;
+                            released_timestamp_ = -1;
+                        }
+                        else if (raw_evt.timestamp < latest_timestamp_)
+                        {
+                            stats_.max_disorder = std::max(stats_.max_disorder, latest_timestamp_ - raw_evt.timestamp);
+                        }
+
+                        // Events behind already stored ones can not be put in order anymore
+                        if (raw_evt.timestamp < released_timestamp_)
+                        {
+                            ++stats_.dropped_evts;
+                            continue;
+                        }
+
+                        if (held_count() == 0 || held_.back().timestamp <= raw_evt.timestamp)
+                        {
+                            held_.push_back(raw_evt);
+                        }
+                        else
+                        {
+                            ++stats_.reordered_evts;
+                            auto later = [](int64_t timestamp, const EventDatum &evt) {
+                                return timestamp < evt.timestamp;
+                            };
+                            held_.insert(std::upper_bound(held_first(), held_.end(), raw_evt.timestamp, later),
+                                         raw_evt);
+                        }
+                        latest_timestamp_ = std::max(latest_timestamp_, raw_evt.timestamp);
+                    }
+
+                    // Release events no event within the tolerance of can still arrive before
+                    auto ready_end = std::upper_bound(
+                        held_first(), held_.end(), latest_timestamp_ - tolerance_,
+                        [](int64_t timestamp, const EventDatum &evt) { return timestamp < evt.timestamp; });
+                    release_held(static_cast<std::size_t>(ready_end - held_first()), release);
+                }
+
+                /**
+                 * @brief Releases all held events, e.g. at the end of a file.
+                 * @param release callable taking a std::span<const EventDatum>, see push.
+                 */
+                template <typename Release> void flush(Release &&release)
+                {
+                    release_held(held_count(), release);
+                }
+
+                /**
+                 * @brief Drops held events and forgets the latest timestamp, e.g. on a clear. Settings and statistics
+                 *        are kept.
+                 */
+                void clear()
+                {
+                    held_.clear();
+                    held_begin_ = 0;
+                    latest_timestamp_ = -1;
+                    released_timestamp_ = -1;
+                }
+
+                /**
+                 * @brief Gets the disorder statistics.
+                 * @return statistics since construction.
+                 */
+                ReorderStats get_stats() const
+                {
+                    ReorderStats stats{stats_};
+                    stats.held_evts = held_count();
+                    return stats;
+                }
+
+                /**
+                 * @brief Counts a frame dropped for being out of order.
+                 */
+                void count_dropped_frame()
+                {
+                    ++stats_.dropped_frames;
+                }
+
+                /**
+                 * @brief Counts a camera reset, detected when stored timestamps go back.
+                 */
+                void count_reset()
+                {
+                    ++stats_.resets;
+                }
+
+            private:
+                int64_t tolerance_{0};
+                int64_t reset_threshold_{0};
+                int64_t latest_timestamp_{-1};   // Latest timestamp pushed since the last reset
+                int64_t released_timestamp_{-1}; // Timestamp of the last released event since the last reset
+                std::vector<EventDatum> held_{}; // Sorted by timestamp from held_begin_, earlier ones were released
+                std::size_t held_begin_{0};
+                ReorderStats stats_{};
+
+                /**
+                 * @brief Returns number of events held.
+                 * @return number of events held.
+                 */
+                std::size_t held_count() const
+                {
+                    return held_.size() - held_begin_;
+                }
+
+                /**
+                 * @brief Returns iterator to the earliest held event.
+                 * @return iterator to the earliest held event.
+                 */
+                std::vector<EventDatum>::iterator held_first()
+                {
+                    return held_.begin() + static_cast<std::ptrdiff_t>(held_begin_);
+                }
+
+                /**
+                 * @brief Releases the first held events as one batch.
+                 * @param count number of events to release.
+                 * @param release callable taking a std::span<const EventDatum>, see push.
+                 */
+                template <typename Release> void release_held(std::size_t count, Release &&release)
+                {
+                    if (count == 0)
+                    {
+                        return;
+                    }
+                    released_timestamp_ = held_[held_begin_ + count - 1].timestamp;
+                    release(std::span<const EventDatum>{held_.data() + held_begin_, count});
+                    held_begin_ += count;
+
+                    // Compact once released events make up half of the vector
+                    if (held_begin_ == held_.size())
+                    {
+                        held_.clear();
+                        held_begin_ = 0;
+                    }
+                    else if (held_begin_ * 2 >= held_.size())
+                    {
+                        held_.erase(held_.begin(), held_first());
+                        held_begin_ = 0;
+                    }
+                }
+        };
+
+        // Member variables
+    private:
+        // Anonymous memory used by the storage of all EventData objects, HYBRID storage spills to files above its limit
+        static inline std::atomic<std::size_t> anonymous_storage_bytes{0};
+
+        // Layout version of save_cache output, bump whenever a saved structure changes
+        static constexpr uint32_t kCacheVersion{7};
+
+        // Scalar state written by save_cache next to the saved buffers
+        struct CacheState
+        {
+                uint32_t version;
+                EventFormat evt_format;
+                int64_t evt_data_earliest_timestamp;
+                int64_t evt_data_latest_timestamp;
+                int64_t frame_data_latest_timestamp;
+                int64_t evt_pending_epoch_start;
+        };
+
+        // Stores event and frame data with relative timestamps (timestamps - earliest event timestamp)
+        // Only the event buffer matching evt_format holds data, event times are offsets from their time segment.
+        // Events, time segments and the time index are written by one writer holding evt_lock and read without
+        // locking, see get_evt_view.
+        MappedEventBuffer<glm::vec4> evt_data_vector_relative;
+        MappedEventBuffer<PackedEvent> evt_data_packed_relative;
+        ColumnarEventBuffer evt_data_columnar_relative;
+        MappedEventBuffer<TimeSegment> evt_time_segments;
+        // Epochs since the last clear, the newest is the one being written
+        MappedEventBuffer<Epoch> evt_epochs;
+        // Sparse time index, relative timestamp of every kTimeIndexStride-th event, entry i is event i * stride
+        MappedEventBuffer<int64_t> evt_time_index;
+        // Positive events before every kTimeIndexStride-th event since the last clear, entry i counts the positive
+        // events before event i * stride. Entries are published before the time index entries readers go by.
+        MappedEventBuffer<uint64_t> evt_positive_index;
+        uint64_t evt_positive_count{0}; // Positive events stored since the last clear, writer only
+        // Indices of the negative (0) and positive (1) events since the last clear, one stream per polarity. Entry p
+        // of a stream holds the low 32 bits of the index of the p-th event of its polarity, so the entries of a
+        // range of events are found through the positive count index. Published before the events.
+        std::array<MappedEventBuffer<uint32_t>, 2> evt_polarity_indices;
+        // IMU samples and triggers recorded next to the events, on the same relative timeline
+        SampleStore<ImuSample> imu_store;
+        SampleStore<uint8_t> trigger_store;
+        // Frames are compressed on disk, only recently used ones are kept decoded
+        FrameStore frame_store;
+        // Events grouped by spatial tile, for region of interest queries
+        EventTileIndex evt_tile_index;
+        // Compressed copies of full event chunks, only written when evt_compression is set
+        SealedEventStore evt_sealed;
+
+        std::atomic<EventFormat> evt_format{EventFormat::VEC4};
+        bool evt_compression{false};
+
+        // Incremented before and after every clear or cache load, odd while one is in progress
+        std::atomic<uint64_t> evt_generation{0};
+
+        StorageConfig storage_config{};
+
+        RetentionMode evt_retention_mode{RetentionMode::UNBOUNDED};
+        int64_t evt_retention_limit{0}; // Events or microseconds depending on evt_retention_mode
+
+        // Sorts slightly out of order events before they are stored
+        ReorderBuffer reorder_buffer;
+
+        // Epochs kept across camera resets, 1 clears all data on a reset, 0 keeps every epoch
+        std::size_t evt_epoch_limit{1};
+        // Relative timestamp the epoch started by the next event begins at, -1 if that event continues the epoch
+        int64_t evt_pending_epoch_start{-1};
+        // Camera timestamp of relative timestamp 0 in the first epoch, -1 to start the first epoch at its first event
+        int64_t evt_time_origin{-1};
+
+        // Earliest event/frame timestamps
+        std::atomic<int64_t> evt_data_earliest_timestamp{-1};
+
+        int64_t evt_data_latest_timestamp{-1};
+        int64_t frame_data_latest_timestamp{-1};
+
+        // Set camera resolution
+        std::atomic<int32_t> camera_event_width{};
+        std::atomic<int32_t> camera_event_height{};
+
+        std::atomic<int32_t> camera_frame_width{};
+        std::atomic<int32_t> camera_frame_height{};
+
+        std::recursive_mutex evt_lock;
+
+        /**
+         * @brief Calls fn with the event buffer of the active format.
+         * @param fn callable taking a MappedEventBuffer<glm::vec4>, MappedEventBuffer<PackedEvent> or
+         *        ColumnarEventBuffer.
+         * @return what fn returns.
+         */
+        template <typename Fn> decltype(auto) visit_evt_buffer(Fn &&fn) const
+        {
+            switch (evt_format.load(std::memory_order_relaxed))
+            {
+            case EventFormat::PACKED:
+                return fn(evt_data_packed_relative);
+            case EventFormat::COLUMNAR:
+                return fn(evt_data_columnar_relative);
+            default:
+                return fn(evt_data_vector_relative);
+            }
+        }
+
+        /**
+         * @brief Calls fn with the event buffer of the active format. Caller must hold evt_lock.
+         * @param fn callable taking a MappedEventBuffer<glm::vec4>, MappedEventBuffer<PackedEvent> or
+         *        ColumnarEventBuffer.
+         * @return what fn returns.
+         */
+        template <typename Fn> decltype(auto) visit_evt_buffer(Fn &&fn)
+        {
+            switch (evt_format.load(std::memory_order_relaxed))
+            {
+            case EventFormat::PACKED:
+                return fn(evt_data_packed_relative);
+            case EventFormat::COLUMNAR:
+                return fn(evt_data_columnar_relative);
+            default:
+                return fn(evt_data_vector_relative);
+            }
+        }
+
+    public:
+        /**
+         * @brief Default constructor for event data.
+         */
+        EventData()
+            : evt_data_vector_relative{}, evt_data_packed_relative{}, evt_data_columnar_relative{}, evt_time_segments{},
+              evt_epochs{}, evt_time_index{}, evt_positive_index{}, evt_positive_count{0},
+              evt_polarity_indices{}, imu_store{}, trigger_store{}, frame_store{},
+              evt_tile_index{}, evt_sealed{}, evt_format{EventFormat::VEC4},
+              evt_compression{false}, evt_generation{0},
+              storage_config{}, evt_retention_mode{RetentionMode::UNBOUNDED}, evt_retention_limit{0}, reorder_buffer{},
+              evt_epoch_limit{1}, evt_pending_epoch_start{-1}, evt_time_origin{-1},
+              evt_data_earliest_timestamp{-1}, evt_data_latest_timestamp{-1}, frame_data_latest_timestamp{-1},
+              camera_event_width{},
+              camera_event_height{}, camera_frame_width{}, camera_frame_height{}, evt_lock{}
+        {
+        }
+
+        /**
+         * @brief Clears everything
+         */
+        void clear()
+        {
+            std::unique_lock<std::recursive_mutex> evt_lock_ul{evt_lock};
+
+            // Clear ref vectors
+            clear_evt_vectors();
+            frame_store.clear();
+            reorder_buffer.clear();
+
+            evt_data_earliest_timestamp = -1;
+            evt_pending_epoch_start = -1;
+            evt_time_origin = -1;
+
+            evt_data_latest_timestamp = -1;
+            frame_data_latest_timestamp = -1;
+
+            camera_event_width = 0;
+            camera_event_height = 0;
+
+            camera_frame_width = 0;
+            camera_frame_height = 0;
+
+            evt_lock_ul.unlock();
+        }
+
+        /**
+         * @brief Sets the storage format of event data. Changing the format clears all data.
+         * @param format New storage format.
+         */
+        void set_evt_format(EventFormat format)
+        {
+            std::unique_lock<std::recursive_mutex> evt_lock_ul{evt_lock};
+            if (format != evt_format)
+            {
+                clear();
+                evt_format = format;
+            }
+            evt_lock_ul.unlock();
+        }
+
+        /**
+         * @brief Gets the storage format of event data. Does not lock.
+         * @return storage format of event data.
+         */
+        EventFormat get_evt_format() const
+        {
+            return evt_format.load(std::memory_order_relaxed);
+        }
+
+        /**
+         * @brief Sets whether full storage chunks of events are sealed into compressed blocks, see SealedEventStore.
+         *        Scrubbing then decodes sealed events from memory instead of paging their storage in, and their
+         *        storage is released from memory once sealed. Random access reads still read the storage. Changing
+         *        it clears all data.
+         * @param enabled true to seal full chunks of events.
+         */
+        void set_evt_compression(bool enabled)
+        {
+            std::unique_lock<std::recursive_mutex> evt_lock_ul{evt_lock};
+            if (enabled != evt_compression)
+            {
+                clear();
+                evt_compression = enabled;
+            }
+            evt_lock_ul.unlock();
+        }
+
+        /**
+         * @brief Gets whether full storage chunks of events are sealed into compressed blocks.
+         * @return true if events are sealed.
+         */
+        bool get_evt_compression()
+        {
+            std::unique_lock<std::recursive_mutex> evt_lock_ul{evt_lock};
+            bool enabled{evt_compression};
+            evt_lock_ul.unlock();
+            return enabled;
+        }
+
+        /**
+         * @brief Gets how many retained events are sealed and the memory they take compressed. Does not lock.
+         * @return pair of number of sealed events and their size in bytes.
+         */
+        std::pair<std::size_t, std::size_t> get_sealed_evt_usage() const
+        {
+            std::size_t sealed_end{evt_sealed.end_index()};
+            std::size_t begin{evt_begin_index()};
+            return {sealed_end > begin ? sealed_end - begin : 0, evt_sealed.compressed_bytes()};
+        }
+
+        /**
+         * @brief Sets what backs event and frame storage, see StorageConfig. Clears all event and frame data if the
+         *        settings change. Storage already mapped is reused as it is, so set this before any data is written,
+         *        e.g. at startup, for the settings to apply to everything.
+         * @param storage storage settings.
+         */
+        void set_storage_config(const StorageConfig &storage)
+        {
+            std::unique_lock<std::recursive_mutex> evt_lock_ul{evt_lock};
+            if (!(storage == storage_config))
+            {
+                clear();
+                storage_config = storage;
+                evt_data_vector_relative.set_storage(storage);
+                evt_data_packed_relative.set_storage(storage);
+                evt_data_columnar_relative.set_storage(storage);
+                evt_time_segments.set_storage(storage);
+                evt_epochs.set_storage(storage);
+                evt_time_index.set_storage(storage);
+                evt_positive_index.set_storage(storage);
+                evt_polarity_indices[0].set_storage(storage);
+                evt_polarity_indices[1].set_storage(storage);
+                imu_store.set_storage(storage);
+                trigger_store.set_storage(storage);
+                frame_store.set_storage(storage);
+                evt_tile_index.set_storage(storage);
+                evt_sealed.set_storage(storage);
+            }
+            evt_lock_ul.unlock();
+        }
+
+        /**
+         * @brief Gets the storage settings.
+         * @return storage settings.
+         */
+        StorageConfig get_storage_config()
+        {
+            std::unique_lock<std::recursive_mutex> evt_lock_ul{evt_lock};
+            StorageConfig storage{storage_config};
+            evt_lock_ul.unlock();
+            return storage;
+        }
+
+        /**
+         * @brief Gets the bytes of anonymous memory used for storage by all EventData objects together.
+         * @return bytes of anonymous storage.
+         */
+        static std::size_t get_anonymous_storage_bytes()
+        {
+            return anonymous_storage_bytes.load(std::memory_order_relaxed);
+        }
+
+        /**
+         * @brief Sets how much event data is retained. Takes effect as new events are written, data beyond the limit
+         *        is evicted a whole storage chunk at a time together with its frames. Indices of retained events do
+         *        not change on eviction, the first retained index is given by get_evt_begin_index.
+         * @param mode Retention mode.
+         * @param limit Number of events for EVENTS, microseconds for DURATION, ignored for UNBOUNDED.
+         */
+        void set_evt_retention(RetentionMode mode, int64_t limit)
+        {
+            std::unique_lock<std::recursive_mutex> evt_lock_ul{evt_lock};
+            evt_retention_mode = mode;
+            evt_retention_limit = std::max(limit, int64_t{0});
+            evt_lock_ul.unlock();
+        }
+
+        /**
+         * @brief Gets the retention mode of event data.
+         * @return retention mode of event data.
+         */
+        RetentionMode get_evt_retention_mode()
+        {
+            std::unique_lock<std::recursive_mutex> evt_lock_ul{evt_lock};
+            RetentionMode mode{evt_retention_mode};
+            evt_lock_ul.unlock();
+            return mode;
+        }
+
+        /**
+         * @brief Sets how many epochs are kept across camera resets. With more than one, a reset keeps the data
+         *        written so far as a finished epoch and the next event starts a new one, see Epoch. Starting an epoch
+         *        takes constant time, nothing is cleared. Once there are more epochs than the limit, the oldest are
+         *        evicted a whole storage chunk at a time like data beyond the retention limit.
+         * @param max_epochs epochs kept including the one being written, 1 clears all data on a reset, 0 keeps every
+         *        epoch.
+         */
+        void set_evt_epoch_limit(std::size_t max_epochs)
+        {
+            std::unique_lock<std::recursive_mutex> evt_lock_ul{evt_lock};
+            evt_epoch_limit = max_epochs;
+            evt_lock_ul.unlock();
+        }
+
+        /**
+         * @brief Gets how many epochs are kept across camera resets, see set_evt_epoch_limit.
+         * @return epochs kept, 0 if every epoch is kept.
+         */
+        std::size_t get_evt_epoch_limit()
+        {
+            std::unique_lock<std::recursive_mutex> evt_lock_ul{evt_lock};
+            std::size_t max_epochs{evt_epoch_limit};
+            evt_lock_ul.unlock();
+            return max_epochs;
+        }
+
+        /**
+         * @brief Gets the epochs with retained events, oldest first. Does not lock, see get_evt_view.
+         * @return retained index range and time origin of every epoch with retained events.
+         */
+        std::vector<EpochRange> get_evt_epochs() const
+        {
+            EventView view{get_evt_view()};
+            std::vector<EpochRange> epochs{};
+            const std::size_t end{evt_epochs.end_index()};
+            for (std::size_t id{evt_epochs.begin_index()}; id < end; ++id)
+            {
+                const Epoch &epoch{evt_epochs[id]};
+                std::size_t first{std::max(epoch.first_index, view.begin_index)};
+                std::size_t last{id + 1 < end ? evt_epochs[id + 1].first_index : view.end_index};
+                last = std::min(last, view.end_index);
+                if (first < last)
+                {
+                    epochs.push_back(EpochRange{.id = id, .first_index = first, .last_index = last,
+                                                .time_origin = epoch.time_origin});
+                }
+            }
+            return epochs;
+        }
+
+        /**
+         * @brief Sets the camera timestamp relative timestamps count from, so data decoded piece by piece, e.g. the
+         *        segments of a session, keeps the same relative timestamps however often it is cleared and decoded
+         *        again. Applies from the first event after a clear, clear resets it.
+         * @param origin camera timestamp of relative timestamp 0 in microseconds, -1 to count from the first event.
+         *        Events before the origin get relative timestamp 0.
+         */
+        void set_evt_time_origin(int64_t origin)
+        {
+            std::unique_lock<std::recursive_mutex> evt_lock_ul{evt_lock};
+            evt_time_origin = std::max(origin, int64_t{-1});
+            evt_lock_ul.unlock();
+        }
+
+        /**
+         * @brief Gets the camera timestamp relative timestamps count from, see set_evt_time_origin.
+         * @return camera timestamp of relative timestamp 0 in microseconds, -1 if counted from the first event.
+         */
+        int64_t get_evt_time_origin()
+        {
+            std::unique_lock<std::recursive_mutex> evt_lock_ul{evt_lock};
+            int64_t origin{evt_time_origin};
+            evt_lock_ul.unlock();
+            return origin;
+        }
+
+        /**
+         * @brief Evicts the oldest storage chunks while all of their events are older than a relative timestamp,
+         *        along with their indices and frames, like data beyond the retention limit. For readers that decode
+         *        data on demand and drop what is no longer looked at. The chunk being written is never evicted.
+         * @param timestamp relative timestamp in microseconds, chunks with only older events are evicted.
+         */
+        void evict_evts_before(int64_t timestamp)
+        {
+            std::unique_lock<std::recursive_mutex> evt_lock_ul{evt_lock};
+            const std::size_t chunk_capacity{evt_chunk_capacity()};
+            const std::size_t evicted_begin{evt_begin_index()};
+            while (evt_count() > chunk_capacity &&
+                   get_evt_relative_time(evt_begin_index() + chunk_capacity) <= timestamp)
+            {
+                visit_evt_buffer([](auto &events) { events.pop_front_chunk(); });
+            }
+            if (evt_begin_index() != evicted_begin)
+            {
+                evict_evt_indices();
+            }
+            evt_lock_ul.unlock();
+        }
+
+        /**
+         * @brief Sets how out of order event timestamps are handled, see ReorderBuffer. Events are held back by the
+         *        tolerance before they are stored, and only a timestamp going back by more than the reset threshold
+         *        is taken as a camera reset. Frames going back by less than the reset threshold are dropped.
+         * @param tolerance microseconds events are held for reordering, 0 stores events as they arrive.
+         * @param reset_threshold microseconds a timestamp must go back by to be a camera reset, 0 takes any
+         *        decreasing timestamp as a reset.
+         */
+        void set_evt_reorder(int64_t tolerance, int64_t reset_threshold)
+        {
+            std::unique_lock<std::recursive_mutex> evt_lock_ul{evt_lock};
+            if (tolerance != reorder_buffer.get_tolerance() || reset_threshold != reorder_buffer.get_reset_threshold())
+            {
+                flush_evt_data(); // Held events were sorted for the old tolerance
+                reorder_buffer.set_tolerance(tolerance, reset_threshold);
+            }
+            evt_lock_ul.unlock();
+        }
+
+        /**
+         * @brief Gets statistics of out of order timestamps seen so far.
+         * @return reorder statistics.
+         */
+        ReorderStats get_reorder_stats()
+        {
+            std::unique_lock<std::recursive_mutex> evt_lock_ul{evt_lock};
+            ReorderStats stats{reorder_buffer.get_stats()};
+            evt_lock_ul.unlock();
+            return stats;
+        }
+
+        /**
+         * @brief Writes all event and frame data, including the indices built during ingest, to a directory so
+         *        load_cache can restore it without decoding the source again. The lock is only held while the
+         *        data growing with the events is snapshotted, see get_evt_snapshot, and the small indices are
+         *        written. The events, their polarity and tile indices and the frames are written after it is
+         *        released, so ingest and rendering go on meanwhile. The data saved is the data stored when the
+         *        call is made.
+         * @param directory directory to write to, must exist.
+         * @return true if everything was written, false otherwise.
+         */
+        bool save_cache(const std::filesystem::path &directory)
+        {
+            std::unique_lock<std::recursive_mutex> evt_lock_ul{evt_lock};
+            flush_evt_data(); // Events held for reordering belong in the cache
+            EventSnapshot events{get_evt_snapshot()};
+            std::array<MappedEventBuffer<uint32_t>::Snapshot, 2> polarity_indices{
+                evt_polarity_indices[0].snapshot(), evt_polarity_indices[1].snapshot()};
+            const CacheState state{.version = kCacheVersion,
+                                   .evt_format = evt_format,
+                                   .evt_data_earliest_timestamp = evt_data_earliest_timestamp,
+                                   .evt_data_latest_timestamp = evt_data_latest_timestamp,
+                                   .frame_data_latest_timestamp = frame_data_latest_timestamp,
+                                   .evt_pending_epoch_start = evt_pending_epoch_start};
+            std::function<void()> save_tile_entries{};
+            std::function<void()> save_frame_files{};
+            try
+            {
+                evt_time_segments.save(directory, "time_segments");
+                evt_epochs.save(directory, "epochs");
+                evt_time_index.save(directory, "time_index");
+                evt_positive_index.save(directory, "positive_index");
+                imu_store.save(directory, "imu");
+                trigger_store.save(directory, "triggers");
+                save_tile_entries = evt_tile_index.save(directory, "tile_index");
+                save_frame_files = frame_store.save(directory, "frames");
+            }
+            catch (const std::exception &)
+            {
+                return false;
+            }
+            evt_lock_ul.unlock();
+
+            try
+            {
+                events.visit_evts([&](const auto &evts) { evts.save(directory, "events"); });
+                polarity_indices[0].save(directory, "negative_indices");
+                polarity_indices[1].save(directory, "positive_indices");
+                save_tile_entries();
+                save_frame_files();
+
+                std::ofstream state_file{directory / "state.bin", std::ios::binary | std::ios::trunc};
+                state_file.write(reinterpret_cast<const char *>(&state), sizeof(state));
+                state_file.close();
+                if (!state_file)
+                {
+                    return false;
+                }
+            }
+            catch (const std::exception &)
+            {
+                return false;
+            }
+            return true;
+        }
+
+        /**
+         * @brief Replaces all event and frame data with data written by save_cache. Event data is mapped copy on
+         *        write rather than read, so loading takes about constant time. On failure all data is cleared.
+         *        Camera resolutions are not saved, set the event resolution of the source before loading.
+         * @param directory directory save_cache wrote to.
+         * @return true if the data was loaded, false otherwise.
+         */
+        bool load_cache(const std::filesystem::path &directory)
+        {
+            std::unique_lock<std::recursive_mutex> evt_lock_ul{evt_lock};
+
+            CacheState state{};
+            std::ifstream state_file{directory / "state.bin", std::ios::binary};
+            state_file.read(reinterpret_cast<char *>(&state), sizeof(state));
+            if (!state_file || state.version != kCacheVersion ||
+                (state.evt_format != EventFormat::VEC4 && state.evt_format != EventFormat::PACKED &&
+                 state.evt_format != EventFormat::COLUMNAR))
+            {
+                return false;
+            }
+
+            // Readers see an odd generation for the whole load, like for a clear
+            bool loaded{true};
+            evt_generation.fetch_add(1, std::memory_order_acq_rel);
+            try
+            {
+                evt_data_vector_relative.clear();
+                evt_data_packed_relative.clear();
+                evt_data_columnar_relative.clear();
+                evt_format = state.evt_format;
+                visit_evt_buffer([&](auto &events) { events.load(directory, "events"); });
+                evt_time_segments.load(directory, "time_segments");
+                evt_epochs.load(directory, "epochs");
+                evt_time_index.load(directory, "time_index");
+                evt_positive_index.load(directory, "positive_index");
+                evt_positive_count = positive_evts_before(evt_end_index());
+                evt_polarity_indices[0].load(directory, "negative_indices");
+                evt_polarity_indices[1].load(directory, "positive_indices");
+                imu_store.load(directory, "imu");
+                trigger_store.load(directory, "triggers");
+                evt_tile_index.load(directory, "tile_index");
+                frame_store.load(directory, "frames");
+                evt_tile_index.set_resolution(camera_event_width, camera_event_height);
+
+                // Sealed events are not cached, they are sealed again from the loaded events
+                evt_sealed.clear();
+                if (evt_compression)
+                {
+                    visit_evt_buffer([&](const auto &events) { seal_evts(events); });
+                }
+            }
+            catch (const std::exception &)
+            {
+                loaded = false;
+            }
+            evt_data_earliest_timestamp = state.evt_data_earliest_timestamp;
+            evt_data_latest_timestamp = state.evt_data_latest_timestamp;
+            frame_data_latest_timestamp = state.frame_data_latest_timestamp;
+            evt_pending_epoch_start = state.evt_pending_epoch_start;
+            evt_generation.fetch_add(1, std::memory_order_release);
+
+            if (!loaded)
+            {
+                evt_data_earliest_timestamp = -1;
+                evt_pending_epoch_start = -1;
+                evt_data_latest_timestamp = -1;
+                frame_data_latest_timestamp = -1;
+                clear_evt_vectors();
+                frame_store.clear();
+            }
+
+            evt_lock_ul.unlock();
+            return loaded;
+        }
+
+        /**
+         * @brief Locks event data vectors. If a thread calls get_*_vector_ref functions and uses the returned
+         *        reference to vectors, the thread must call this. Any use of the reference vector must be inside a
+         *        critical section for thread-safety. Reading events through get_evt_view and the functions taking
+         *        event indices does not need the lock, frame data does.
+         */
+        void lock_data_vectors()
+        {
+            evt_lock.lock();
+        }
+
+        /**
+         * @brief Unlocks event data vectors. If a thread calls get_*_vector_ref functions and uses the returned
+         *        reference to vectors, the thread must call this after it is done using the data vectors.
+         *        Any use of the reference vector must be inside a critical section for thread-safety.
+         */
+        void unlock_data_vectors()
+        {
+            evt_lock.unlock();
+        }
+
+        /**
+         * @brief Sets camera resolution for event data.
+         * @param width Width of camera.
+         * @param height Height of camera.
+         */
+        void set_camera_event_resolution(int32_t width, int32_t height)
+        {
+            camera_event_width = width;
+            camera_event_height = height;
+        }
+
+        /**
+         * @brief Sets camera resolution for frame data.
+         * @param width Width of camera.
+         * @param height Height of camera.
+         */
+        void set_camera_frame_resolution(int32_t width, int32_t height)
+        {
+            camera_frame_width = width;
+            camera_frame_height = height;
+        }
+
+        /**
+         * @brief Gets event camera resolution.
+         * @return event camera resolution as glm::vec2 (width, height).
+         */
+        glm::vec2 get_camera_event_resolution()
+        {
+            return glm::vec2{static_cast<float>(camera_event_width), static_cast<float>(camera_event_height)};
+        }
+
+        /**
+         * @brief Gets frame camera resolution.
+         * @return frame camera resolution as glm::vec2 (width, height).
+         */
+        glm::vec2 get_camera_frame_resolution()
+        {
+            return glm::vec2{static_cast<float>(camera_frame_width), static_cast<float>(camera_frame_height)};
+        }
+
+        /**
+         * @brief Inserts event data into the event data vector with relative timestamps (absolute timestamp - absolute
+         *        earliest event timestamp). Following documentation of the AEDAT formats
+         *        (https://docs.inivation.com/_static/inivation-docs_2025-08-05.pdf page 163), data is assumed to be
+         *        read in as monotonically increasing timestamps. If a decreasing timestamp is detected, as per documentation,
+         *        a camera reset/syncronization is assumed where timestamps are reset to 0. Timestamps going back by
+         *        less than the reset threshold are sorted out instead, see set_evt_reorder.
+         * @param raw_evt_data Raw event data to add.
+         */
+        void write_evt_data(EventDatum raw_evt_data)
+        {
+            write_evt_data_batch(std::span<const EventDatum>{&raw_evt_data, 1});
+        }
+
+        /**
+         * @brief Inserts a batch of event data the same way as write_evt_data, but takes the lock and maps storage
+         *        once for the whole batch and converts events in a tight loop. The new events are published to
+         *        readers once per batch (and once per storage chunk filled).
+         * @param raw_evt_data Raw event data to add, in order of arrival.
+         */
+        void write_evt_data_batch(std::span<const EventDatum> raw_evt_data)
+        {
+            std::unique_lock<std::recursive_mutex> evt_lock_ul{evt_lock};
+            reorder_buffer.push(raw_evt_data, [this](std::span<const EventDatum> sorted) { append_evts(sorted); });
+            evt_lock_ul.unlock();
+        }
+
+        /**
+         * @brief Stores the events held back for reordering, see set_evt_reorder. Call when no more events will
+         *        arrive, e.g. at the end of a file.
+         */
+        void flush_evt_data()
+        {
+            std::unique_lock<std::recursive_mutex> evt_lock_ul{evt_lock};
+            reorder_buffer.flush([this](std::span<const EventDatum> sorted) { append_evts(sorted); });
+            evt_lock_ul.unlock();
+        }
+
+        /**
+         * @brief Inserts frame data into the frame store with relative timestamps (absolute timestamp - absolute
+         *        earliest event timestamp). Following documentation of the AEDAT formats
+         *        (https://docs.inivation.com/_static/inivation-docs_2025-08-05.pdf page 163), data is assumed to be
+         *        read in as monotonically increasing timestamps. If a decreasing timestamp is detected, as per documentation,
+         *        a camera reset/syncronization is assumed where timestamps are reset to 0. Frames going back by less
+         *        than the reset threshold are dropped instead, see set_evt_reorder. Frames not yet compressed are
+         *        compressed before the lock is taken.
+         * @param raw_frame_data Raw frame data to add.
+         */
+        void write_frame_data(FrameDatum raw_frame_data)
+        {
+            if (raw_frame_data.encoded.empty())
+            {
+                raw_frame_data.encoded = FrameStore::encode(raw_frame_data.frameData);
+            }
+
+            std::unique_lock<std::recursive_mutex> evt_lock_ul{evt_lock};
+
+            // If this condition is met, unordered frame assumes camera reset
+            if (raw_frame_data.timestamp < frame_data_latest_timestamp)
+            {
+                // Small disorder is not a reset, the frame can not be inserted in order though
+                if (frame_data_latest_timestamp - raw_frame_data.timestamp <= reorder_buffer.get_reset_threshold())
+                {
+                    reorder_buffer.count_dropped_frame();
+                    return;
+                }
+
+                // Reset assumed, timestamps are all back to zero. Held events are from before the reset, stored first.
+                flush_evt_data();
+                reset_evt_data();
+                reorder_buffer.clear();
+                reorder_buffer.count_reset();
+            }
+
+            // Need to normalize timestamps relative to event data, ignore until event data of the epoch is in
+            if (evt_count() == 0 || evt_pending_epoch_start >= 0)
+            {
+                return;
+            }
+
+            int64_t timestamp_relative{raw_frame_data.timestamp - evt_data_earliest_timestamp};
+
+            frame_store.push_back(raw_frame_data.frameData, timestamp_relative, raw_frame_data.encoded);
+
+            frame_data_latest_timestamp = raw_frame_data.timestamp;
+
+            evt_lock_ul.unlock();
+        }
+
+        /**
+         * @brief Inserts a batch of IMU samples, placed on the event timeline like frames. Samples are ignored until
+         *        events of the current epoch are stored, and samples older than the newest stored one, e.g. from
+         *        before a camera reset, are dropped. The whole batch is published at once.
+         * @param raw_imu_data IMU samples to add, in time order.
+         */
+        void write_imu_data_batch(std::span<const ImuDatum> raw_imu_data)
+        {
+            std::unique_lock<std::recursive_mutex> evt_lock_ul{evt_lock};
+            append_samples(imu_store, raw_imu_data, [](const ImuDatum &datum) { return datum.sample; });
+            evt_lock_ul.unlock();
+        }
+
+        /**
+         * @brief Inserts a batch of triggers, see write_imu_data_batch.
+         * @param raw_trigger_data triggers to add, in time order.
+         */
+        void write_trigger_data_batch(std::span<const TriggerDatum> raw_trigger_data)
+        {
+            std::unique_lock<std::recursive_mutex> evt_lock_ul{evt_lock};
+            append_samples(trigger_store, raw_trigger_data, [](const TriggerDatum &datum) { return datum.type; });
+            evt_lock_ul.unlock();
+        }
+
+        /**
+         * @brief Exposes the stored IMU samples. Does not lock, see SampleStore.
+         * @return const reference to internal IMU sample store.
+         */
+        const SampleStore<ImuSample> &get_imu_store_ref() const
+        {
+            return imu_store;
+        }
+
+        /**
+         * @brief Exposes the stored triggers, values are dv::TriggerType. Does not lock, see SampleStore.
+         * @return const reference to internal trigger store.
+         */
+        const SampleStore<uint8_t> &get_trigger_store_ref() const
+        {
+            return trigger_store;
+        }
+
+        /**
+         * @brief Gets the IMU samples with relative timestamps in [start_timestamp, end_timestamp). Does not lock.
+         * @param start_timestamp start of time range in microseconds (inclusive).
+         * @param end_timestamp end of time range in microseconds (exclusive).
+         * @return pair of index of first sample and index one past the last sample in the IMU store.
+         */
+        std::pair<std::size_t, std::size_t> get_imu_index_range_from_relative_timestamps(int64_t start_timestamp,
+                                                                                         int64_t end_timestamp) const
+        {
+            return imu_store.index_range(start_timestamp, end_timestamp);
+        }
+
+        /**
+         * @brief Gets the triggers with relative timestamps in [start_timestamp, end_timestamp). Does not lock.
+         * @param start_timestamp start of time range in microseconds (inclusive).
+         * @param end_timestamp end of time range in microseconds (exclusive).
+         * @return pair of index of first trigger and index one past the last trigger in the trigger store.
+         */
+        std::pair<std::size_t, std::size_t> get_trigger_index_range_from_relative_timestamps(
+            int64_t start_timestamp, int64_t end_timestamp) const
+        {
+            return trigger_store.index_range(start_timestamp, end_timestamp);
+        }
+
+        /**
+         * @brief Interpolates the IMU samples linearly at a relative timestamp, e.g. at the time of an event for
+         *        motion compensation. Finds the bracketing samples in O(log n). Times outside the stored samples get
+         *        the first or last sample. Does not lock.
+         * @param timestamp relative timestamp in microseconds.
+         * @return interpolated sample, std::nullopt if no IMU samples are stored.
+         */
+        std::optional<ImuSample> get_imu_at_relative_timestamp(int64_t timestamp) const
+        {
+            const std::size_t begin{imu_store.begin_index()};
+            const std::size_t end{imu_store.end_index()};
+            if (end <= begin)
+            {
+                return std::nullopt;
+            }
+            const std::size_t next{imu_store.lower_bound(timestamp)};
+            if (next == begin)
+            {
+                return imu_store[begin];
+            }
+            if (next == end)
+            {
+                return imu_store[end - 1];
+            }
+
+            const ImuSample &before{imu_store[next - 1]};
+            const ImuSample &after{imu_store[next]};
+            const int64_t before_time{imu_store.time(next - 1)};
+            const float weight{static_cast<float>(timestamp - before_time) /
+                               static_cast<float>(imu_store.time(next) - before_time)};
+            return ImuSample{.accelerometer = glm::mix(before.accelerometer, after.accelerometer, weight),
+                             .gyroscope = glm::mix(before.gyroscope, after.gyroscope, weight),
+                             .temperature = glm::mix(before.temperature, after.temperature, weight)};
+        }
+
+        /**
+         * @brief Exposes event data as a vector of glm::vec4 (only populated when the format is VEC4). The z component
+         *        is the time offset from the event's time segment, use get_evt_relative_time for the relative timestamp
+         *        (absolute timestamp - earliest event timestamp). Readers not holding lock_data_vectors() must stay
+         *        within a view from get_evt_view.
+         * @return const reference to internal event data vector.
+         */
+        const MappedEventBuffer<glm::vec4> &get_evt_vector_ref() const
+        {
+            return evt_data_vector_relative;
+        }
+
+        /**
+         * @brief Exposes event data stored in the compact format (only populated when the format is PACKED).
+         *        Readers not holding lock_data_vectors() must stay within a view from get_evt_view.
+         * @return const reference to internal packed event data vector.
+         */
+        const MappedEventBuffer<PackedEvent> &get_packed_evt_vector_ref() const
+        {
+            return evt_data_packed_relative;
+        }
+
+        /**
+         * @brief Exposes event data stored in columns (only populated when the format is COLUMNAR).
+         *        Readers not holding lock_data_vectors() must stay within a view from get_evt_view.
+         * @return const reference to internal columnar event buffer.
+         */
+        const ColumnarEventBuffer &get_columnar_evt_buffer_ref() const
+        {
+            return evt_data_columnar_relative;
+        }
+
+        /**
+         * @brief Gets number of retained published events regardless of storage format. Does not lock.
+         * @return number of retained events.
+         */
+        std::size_t get_evt_count() const
+        {
+            return evt_count();
+        }
+
+        /**
+         * @brief Gets index of the first retained event, 0 unless events were evicted by the retention mode.
+         *        Valid event indices are [get_evt_begin_index(), get_evt_end_index()). Does not lock.
+         * @return index of the first retained event.
+         */
+        std::size_t get_evt_begin_index() const
+        {
+            return evt_begin_index();
+        }
+
+        /**
+         * @brief Gets index one past the last published event. Does not lock.
+         * @return index one past the last published event.
+         */
+        std::size_t get_evt_end_index() const
+        {
+            return evt_end_index();
+        }
+
+        /**
+         * @brief Takes a wait-free view of the published events for reading without lock_data_vectors. Events are
+         *        only appended, so events in the view stay as they are until evicted by the retention mode or
+         *        cleared. Read them with the functions taking event indices, then call is_evt_view_current to know
+         *        whether the data read is consistent. A view taken while a clear is in progress is empty.
+         * @return view of the published events.
+         */
+        EventView get_evt_view() const
+        {
+            uint64_t generation{evt_generation.load(std::memory_order_acquire)};
+            if (generation % 2 != 0)
+            {
+                return EventView{generation, 0, 0};
+            }
+            std::size_t begin_index{evt_begin_index()};
+            std::size_t end_index{std::max(begin_index, evt_end_index())};
+            return EventView{generation, begin_index, end_index};
+        }
+
+        /**
+         * @brief Checks that events read through a view were not cleared or evicted while being read.
+         * @param view view taken with get_evt_view before reading.
+         * @return true if everything read in [view.begin_index, view.end_index) is consistent.
+         */
+        bool is_evt_view_current(const EventView &view) const
+        {
+            std::atomic_thread_fence(std::memory_order_acquire); // Keep the reads of event data before the checks
+            return evt_generation.load(std::memory_order_relaxed) == view.generation &&
+                   evt_begin_index() <= view.begin_index;
+        }
+
+        /**
+         * @brief Takes a snapshot handle of the published events, see EventSnapshot. Unlike a view it can be read for
+         *        as long as needed, the storage it reads is reclaimed only once its last copy is destroyed. Events
+         *        still held by the reorder stage are not part of it. Locks only while the snapshot is taken.
+         * @return snapshot of the published events.
+         */
+        EventSnapshot get_evt_snapshot()
+        {
+            std::unique_lock<std::recursive_mutex> evt_lock_ul{evt_lock};
+            EventSnapshot snapshot{};
+            snapshot.format_ = evt_format;
+            switch (snapshot.format_)
+            {
+            case EventFormat::PACKED:
+                snapshot.packed_evts_ = evt_data_packed_relative.snapshot();
+                break;
+            case EventFormat::COLUMNAR:
+                snapshot.columnar_evts_ = evt_data_columnar_relative.snapshot();
+                break;
+            default:
+                snapshot.vec4_evts_ = evt_data_vector_relative.snapshot();
+                break;
+            }
+            snapshot.time_segments_ = evt_time_segments.snapshot();
+            snapshot.earliest_timestamp_ = evt_data_earliest_timestamp;
+            snapshot.begin_index_ = evt_begin_index();
+            snapshot.end_index_ = std::max(snapshot.begin_index_, evt_end_index());
+            evt_lock_ul.unlock();
+            return snapshot;
+        }
+
+        /**
+         * @brief Gets size in bytes of one stored event in the current storage format.
+         * @return size in bytes of one stored event.
+         */
+        std::size_t get_evt_element_size() const
+        {
+            return evt_element_size();
+        }
+
+        /**
+         * @brief Gets event at index decoded as glm::vec4 (x, y, relative time, polarity) regardless of storage
+         *        format. The relative time is converted to float and loses precision on long recordings, use
+         *        get_evt_relative_time for the exact value. Does not lock, see get_evt_view.
+         * @param index index of event.
+         * @return decoded event.
+         */
+        glm::vec4 get_evt(std::size_t index) const
+        {
+            glm::vec4 evt{visit_evt_buffer([index](const auto &events) { return unpack_event(events[index]); })};
+            evt.z = static_cast<float>(get_evt_relative_time(index));
+            return evt;
+        }
+
+        /**
+         * @brief Gets exact relative timestamp (absolute timestamp - earliest event timestamp) of event at index
+         *        regardless of storage format. Does not lock, see get_evt_view.
+         * @param index index of event.
+         * @return relative timestamp of event in microseconds.
+         */
+        int64_t get_evt_relative_time(std::size_t index) const
+        {
+            return evt_time_segments[segment_of(index)].base_time + evt_time_offset(index);
+        }
+
+        /**
+         * @brief Gets base time of the time segment holding the event at index. Events of a range starting at index
+         *        can be uploaded without conversion if they are rebased to this time (see for_each_evt_span).
+         *        Does not lock, see get_evt_view.
+         * @param index index of event.
+         * @return relative base time in microseconds of the time segment holding the event.
+         */
+        int64_t get_evt_time_base(std::size_t index) const
+        {
+            return evt_time_segments[segment_of(index)].base_time;
+        }
+
+        /**
+         * @brief Exposes the time segments of the stored events. Segments before the one holding the first retained
+         *        event may still be present. Does not lock, see get_evt_view.
+         * @return const reference to internal time segment buffer.
+         */
+        const MappedEventBuffer<TimeSegment> &get_evt_time_segments_ref() const
+        {
+            return evt_time_segments;
+        }
+
+        /**
+         * @brief Visits the raw bytes of the events in [first, last) in their storage format with the stored time of
+         *        each event rebased to an offset from time_base, so shaders get small exact times. Runs of events
+         *        whose time segment starts at time_base are passed straight from storage, one contiguous span per
+         *        storage chunk. Other runs, and sealed events (see set_evt_compression), are converted in blocks into
+         *        a temporary buffer, those spans are only valid during the call to fn. Does not lock, see
+         *        get_evt_view.
+         * @param first index of first event.
+         * @param last index one past last event.
+         * @param time_base relative time in microseconds event times are rebased to.
+         * @param fn callable taking a std::span<const std::byte>.
+         */
+        template <typename Fn>
+        void for_each_evt_span(std::size_t first, std::size_t last, int64_t time_base, Fn &&fn) const
+        {
+            visit_evt_buffer([&](const auto &events) { for_each_rebased_span(events, first, last, time_base, fn); });
+        }
+
+        /**
+         * @brief Copies the events in [first, last) in their storage format, with times rebased like
+         *        for_each_evt_span, straight into memory such as a mapped GPU transfer buffer. Sealed events are
+         *        decoded into it without an intermediate copy. Does not lock, see get_evt_view.
+         * @param first index of first event.
+         * @param last index one past last event.
+         * @param time_base relative time in microseconds event times are rebased to.
+         * @param out receives (last - first) * get_evt_element_size() bytes, aligned for the storage format.
+         */
+        void copy_evts(std::size_t first, std::size_t last, int64_t time_base, std::byte *out) const
+        {
+            visit_evt_buffer([&](const auto &events) { copy_rebased(events, first, last, time_base, out); });
+        }
+
+        /**
+         * @brief Tells the OS how soon the events in [first, last) are read, so their pages are read from disk ahead
+         *        of the render thread or dropped from memory before hotter ones. Only a hint, events never change.
+         * @param first index of first event.
+         * @param last index one past last event.
+         * @param advice how soon the events are read.
+         */
+        void advise_evts(std::size_t first, std::size_t last, AccessAdvice advice)
+        {
+            // Locked so no chunk is evicted and unmapped while it is advised
+            std::unique_lock<std::recursive_mutex> evt_lock_ul{evt_lock};
+            if (advice == AccessAdvice::WILL_NEED)
+            {
+                first = std::max(first, evt_sealed.end_index()); // Sealed events are read compressed
+            }
+            visit_evt_buffer([&](const auto &events) { events.advise(first, last, advice); });
+            evt_lock_ul.unlock();
+        }
+
+        /**
+         * @brief Exposes frame data with relative timestamp (absolute timestamp - earliest event timestamp) as a store
+         *        indexed by timestamp that decodes frames on demand. IMPORTANT: Caller must have called
+         *        lock_data_vectors(). Call unlock_data_vectors() when done working with the data vectors.
+         * @return reference to internal frame store.
+         */
+        FrameStore &get_frame_store_ref()
+        {
+            return frame_store;
+        }
+
+        /**
+         * @brief Gets the event rate over all retained events, split into at most max_buckets equally long time
+         *        buckets. Each bucket is counted through get_evt_polarity_counts, so cost is O(max_buckets log n)
+         *        regardless of the number of events. Does not lock, see get_evt_view.
+         * @param max_buckets largest number of values wanted.
+         * @return event rate in events per second of each time bucket, oldest first.
+         */
+        std::vector<float> get_evt_rate_timeline(std::size_t max_buckets) const
+        {
+            std::vector<float> timeline{};
+            EventView view{get_evt_view()};
+            if (view.end_index <= view.begin_index || max_buckets == 0)
+            {
+                return timeline;
+            }
+
+            const int64_t first_time{get_evt_relative_time(view.begin_index)};
+            const int64_t last_time{get_evt_relative_time(view.end_index - 1) + 1};
+            const int64_t duration{rate_bucket_duration(first_time, last_time, max_buckets)};
+            const double per_second{1e6 / static_cast<double>(duration)};
+            for (int64_t bucket_time{first_time}; bucket_time < last_time; bucket_time += duration)
+            {
+                PolarityCounts counts{get_evt_polarity_counts(bucket_time, bucket_time + duration)};
+                timeline.push_back(static_cast<float>(static_cast<double>(counts[0] + counts[1]) * per_second));
+            }
+            return timeline;
+        }
+
+        /**
+         * @brief Returns the bucket duration get_evt_rate_timeline uses for a time range.
+         * @param first_time relative timestamp range start.
+         * @param last_time relative timestamp range end (exclusive).
+         * @param max_buckets largest number of buckets wanted, not 0.
+         * @return shortest duration in microseconds that splits the range into at most max_buckets buckets.
+         */
+        static int64_t rate_bucket_duration(int64_t first_time, int64_t last_time, std::size_t max_buckets)
+        {
+            const int64_t buckets{static_cast<int64_t>(max_buckets)};
+            return std::max<int64_t>((last_time - first_time + buckets - 1) / buckets, 1);
+        }
+
+        /**
+         * @brief Gets the number of events of each polarity with relative timestamps in [start_timestamp,
+         *        end_timestamp). Both ends are found through the time index and the positive events between them are
+         *        counted from the positive count index, which leaves fewer than kTimeIndexStride events to read at
+         *        each end, in the blocks the searches read anyway. Cost is O(log n) whatever the length of the range.
+         *        Does not lock, see get_evt_view.
+         * @param start_timestamp Start of time range in microseconds (inclusive).
+         * @param end_timestamp End of time range in microseconds (exclusive).
+         * @return event counts indexed by polarity.
+         */
+        PolarityCounts get_evt_polarity_counts(int64_t start_timestamp, int64_t end_timestamp) const
+        {
+            auto [first, last] = get_event_index_range_from_relative_timestamps(start_timestamp, end_timestamp);
+            if (first >= last)
+            {
+                return PolarityCounts{0, 0};
+            }
+            uint64_t positive{positive_evts_before(last) - positive_evts_before(first)};
+            return PolarityCounts{last - first - positive, positive};
+        }
+
+        /**
+         * @brief Gets the event rate of each polarity over the latest window of time, from the time and positive
+         *        count indices alone, no event is read. Resolution is kTimeIndexStride events, when fewer events
+         *        arrived during the window the rate is averaged over the latest kTimeIndexStride events instead.
+         *        Does not lock, see get_evt_view.
+         * @param window length of time to average over in microseconds.
+         * @return events per second indexed by polarity, zeros until kTimeIndexStride + 1 events are stored.
+         */
+        std::array<double, 2> get_latest_evt_rate(int64_t window) const
+        {
+            EventView view{get_evt_view()};
+            const std::size_t first_entry{view.begin_index / kTimeIndexStride};
+            const std::size_t last_entry{view.end_index == 0 ? 0 : (view.end_index - 1) / kTimeIndexStride};
+            if (last_entry <= first_entry || last_entry >= evt_time_index.end_index())
+            {
+                return {0.0, 0.0};
+            }
+
+            // Latest entry at least window before the newest one, or the entry before the newest one if that is later
+            using index_iterator = MappedEventBuffer<int64_t>::const_iterator;
+            const int64_t last_time{evt_time_index[last_entry]};
+            index_iterator first_it{&evt_time_index, first_entry};
+            auto entry = std::upper_bound(first_it, index_iterator{&evt_time_index, last_entry}, last_time - window);
+            std::ptrdiff_t position{std::max<std::ptrdiff_t>(entry - first_it, 1) - 1};
+            const std::size_t from_entry{std::min(first_entry + static_cast<std::size_t>(position), last_entry - 1)};
+
+            const double seconds{static_cast<double>(std::max<int64_t>(last_time - evt_time_index[from_entry], 1)) /
+                                 1e6};
+            const double positive{static_cast<double>(evt_positive_index[last_entry] - evt_positive_index[from_entry])};
+            const double total{static_cast<double>((last_entry - from_entry) * kTimeIndexStride)};
+            return {(total - positive) / seconds, positive / seconds};
+        }
+
+        /**
+         * @brief Visits the events in [first, last) inside a region of interest in index order, using the tile index
+         *        so the cost follows the number of events near the region. Events of the tile block still being
+         *        filled, at most EventTileIndex::kBlockEvents, are scanned instead. Does not lock, see get_evt_view.
+         * @param roi region of interest.
+         * @param first index of first event to consider, clamped to the retained events.
+         * @param last index one past the last event to consider, clamped to the published events.
+         * @param fn callable taking the index (std::size_t) of an event inside the region.
+         */
+        template <typename Fn>
+        void for_each_roi_evt(const RegionOfInterest &roi, std::size_t first, std::size_t last, Fn &&fn) const
+        {
+            first = std::max(first, evt_begin_index());
+            last = std::min(last, evt_end_index());
+            if (first >= last)
+            {
+                return;
+            }
+            const std::size_t unindexed_first{
+                evt_tile_index.for_each_candidate(roi, first, last, [&](std::size_t index) {
+                    auto [x, y] = evt_position(index);
+                    if (x >= roi.x && x < roi.x + roi.width && y >= roi.y && y < roi.y + roi.height)
+                    {
+                        fn(index);
+                    }
+                })};
+            for_each_matching_evt(EventFilter{.roi = roi, .polarity = -1}, unindexed_first, last, fn);
+        }
+
+        /**
+         * @brief Visits the events in [first, last) matching a filter in index order by scanning them. Matches are
+         *        tested without branches over blocks of events and only the matching indices are passed on, so the
+         *        scan runs at memory speed whatever the selectivity. Columnar storage only reads the coordinate and
+         *        polarity columns. Prefer for_each_roi_evt for small regions over long ranges, it skips most events
+         *        instead. Does not lock, see get_evt_view.
+         * @param filter region and polarity to match.
+         * @param first index of first event to consider, clamped to the retained events.
+         * @param last index one past the last event to consider, clamped to the published events.
+         * @param fn callable taking the index (std::size_t) of a matching event.
+         */
+        template <typename Fn>
+        void for_each_matching_evt(const EventFilter &filter, std::size_t first, std::size_t last, Fn &&fn) const
+        {
+            constexpr std::size_t SCAN_BLOCK{1024}; // Events tested before their matches are passed on
+            const FilterBounds bounds{.x = filter.roi.x,
+                                      .y = filter.roi.y,
+                                      .width = static_cast<uint32_t>(std::max(filter.roi.width, 0)),
+                                      .height = static_cast<uint32_t>(std::max(filter.roi.height, 0)),
+                                      .polarity_mask = filter.polarity < 0 ? 0u : 1u,
+                                      .polarity = filter.polarity < 0 ? 0u : static_cast<uint32_t>(filter.polarity)};
+            std::array<uint32_t, SCAN_BLOCK> hits{};
+
+            // Blocks write the offset of every event but only count the matching ones, emit passes those on
+            auto emit = [&](std::size_t first_index, std::size_t hit_count) {
+                for (std::size_t hit{0}; hit < hit_count; ++hit)
+                {
+                    fn(first_index + hits[hit]);
+                }
+            };
+
+            if (evt_format == EventFormat::COLUMNAR)
+            {
+                evt_data_columnar_relative.for_each_column_span(
+                    first, last, [&](const ColumnarEventBuffer::ColumnSpan &span) {
+                        for (std::size_t offset{0}; offset < span.count; offset += SCAN_BLOCK)
+                        {
+                            const std::size_t count{std::min(SCAN_BLOCK, span.count - offset)};
+                            std::size_t hit_count{0};
+                            for (std::size_t i{0}; i < count; ++i)
+                            {
+                                hits[hit_count] = static_cast<uint32_t>(i);
+                                hit_count += filter_match(span.xs[offset + i], span.ys[offset + i],
+                                                          span.polarities[offset + i], bounds);
+                            }
+                            emit(span.first_index + offset, hit_count);
+                        }
+                    });
+                return;
+            }
+
+            visit_evt_buffer([&](const auto &events) {
+                using T = typename std::remove_cvref_t<decltype(events)>::value_type;
+                first = std::max(first, events.begin_index());
+                events.for_each_span(first, last, [&](std::span<const T> span) {
+                    for (std::size_t offset{0}; offset < span.size(); offset += SCAN_BLOCK)
+                    {
+                        const std::size_t count{std::min(SCAN_BLOCK, span.size() - offset)};
+                        std::size_t hit_count{0};
+                        for (std::size_t i{0}; i < count; ++i)
+                        {
+                            hits[hit_count] = static_cast<uint32_t>(i);
+                            hit_count += filter_match(span[offset + i], bounds);
+                        }
+                        emit(first + offset, hit_count);
+                    }
+                    first += span.size();
+                });
+            });
+        }
+
+        /**
+         * @brief Gets the indices of the events in [first, last) inside a region of interest, see for_each_roi_evt.
+         * @param roi region of interest.
+         * @param first index of first event to consider.
+         * @param last index one past the last event to consider.
+         * @return indices of events inside the region in increasing order.
+         */
+        std::vector<std::size_t> get_roi_evt_indices(const RegionOfInterest &roi, std::size_t first,
+                                                     std::size_t last) const
+        {
+            std::vector<std::size_t> indices{};
+            for_each_roi_evt(roi, first, last, [&](std::size_t index) { indices.push_back(index); });
+            return indices;
+        }
+
+        /**
+         * @brief Copies the events in [first, last) inside a region of interest in the active storage format, with
+         *        times as offsets from time_base like for_each_evt_span, so they can be uploaded in place of a
+         *        contiguous range. Does not lock, see get_evt_view.
+         * @param roi region of interest.
+         * @param first index of first event to consider.
+         * @param last index one past the last event to consider.
+         * @param time_base relative timestamp the copied event times are offsets from.
+         * @param out bytes of the copied events, replaced.
+         * @param polarity polarity of the events to copy, -1 copies both.
+         * @return number of copied events.
+         */
+        std::size_t gather_roi_evts(const RegionOfInterest &roi, std::size_t first, std::size_t last,
+                                    int64_t time_base, std::vector<std::byte> &out, int32_t polarity = -1) const
+        {
+            out.clear();
+            visit_evt_buffer([&](const auto &events) {
+                gather_rebased_evts(
+                    events,
+                    [&](auto &&emit) {
+                        for_each_roi_evt(roi, first, last, [&](std::size_t index) {
+                            if (polarity < 0 || evt_polarity(index) == polarity)
+                            {
+                                emit(index);
+                            }
+                        });
+                    },
+                    time_base, out);
+            });
+            return out.size() / evt_element_size();
+        }
+
+        /**
+         * @brief Visits the events of one polarity in [first, last) in index order. The indices come from the
+         *        index stream of that polarity, so the cost follows the number of visited events instead of the size
+         *        of the range. Does not lock, see get_evt_view.
+         * @param polarity polarity of the events to visit, 0 or 1.
+         * @param first index of first event to consider, clamped to the retained events.
+         * @param last index one past the last event to consider, clamped to the published events.
+         * @param fn callable taking the index (std::size_t) of an event of the polarity.
+         */
+        template <typename Fn>
+        void for_each_polarity_evt(uint8_t polarity, std::size_t first, std::size_t last, Fn &&fn) const
+        {
+            first = std::max(first, evt_begin_index());
+            last = std::min(last, evt_end_index());
+            if (first >= last)
+            {
+                return;
+            }
+
+            // Stream entries of the range, events before an index are either positive or negative
+            const std::size_t positive_first{static_cast<std::size_t>(positive_evts_before(first))};
+            const std::size_t positive_last{static_cast<std::size_t>(positive_evts_before(last))};
+            const std::size_t entry_first{polarity ? positive_first : first - positive_first};
+            const std::size_t entry_last{polarity ? positive_last : last - positive_last};
+
+            // Entries hold the low 32 bits of increasing indices, the high bits go up whenever those wrap
+            constexpr std::size_t LOW_BITS{std::size_t{1} << 32};
+            std::size_t previous{first};
+            std::size_t high{first & ~(LOW_BITS - 1)};
+            evt_polarity_indices[polarity ? 1 : 0].for_each_span(
+                entry_first, entry_last, [&](std::span<const uint32_t> entries) {
+                    for (uint32_t low : entries)
+                    {
+                        std::size_t index{high | low};
+                        if (index < previous)
+                        {
+                            high += LOW_BITS;
+                            index += LOW_BITS;
+                        }
+                        previous = index;
+                        fn(index);
+                    }
+                });
+        }
+
+        /**
+         * @brief Copies the events of one polarity in [first, last) in the active storage format, with times as
+         *        offsets from time_base like gather_roi_evts, e.g. to upload only ON or only OFF events. The cost
+         *        follows the number of copied events, see for_each_polarity_evt. Does not lock, see get_evt_view.
+         * @param polarity polarity of the events to copy, 0 or 1.
+         * @param first index of first event to consider.
+         * @param last index one past the last event to consider.
+         * @param time_base relative timestamp the copied event times are offsets from.
+         * @param out bytes of the copied events, replaced.
+         * @return number of copied events.
+         */
+        std::size_t gather_polarity_evts(uint8_t polarity, std::size_t first, std::size_t last, int64_t time_base,
+                                         std::vector<std::byte> &out) const
+        {
+            out.clear();
+            visit_evt_buffer([&](const auto &events) {
+                gather_rebased_evts(
+                    events, [&](auto &&emit) { for_each_polarity_evt(polarity, first, last, emit); }, time_base,
+                    out);
+            });
+            return out.size() / evt_element_size();
+        }
+
+        /**
+         * @brief Gets the earliest event timestamp. After a camera reset that kept the data as an epoch, this is the
+         *        camera timestamp of relative timestamp 0 in the current epoch instead, see Epoch. Does not lock.
+         * @return earliest event data timestamp.
+         */
+        int64_t get_earliest_evt_timestamp() const
+        {
+            if (evt_count() == 0)
+            {
+                return -1; // No evt data
+            }
+            return evt_data_earliest_timestamp.load(std::memory_order_relaxed);
+        }
+
+        /**
+         * @brief Gets index of first event data in relative event data vector with timestamp that is equal or greater
+         *        than provided timestamp. Does not lock, see get_evt_view.
+         * @param timestamp Provided timestamp in microseconds.
+         * @return -1 if relative event data vector is empty or index not found, index otherwise.
+         */
+        int64_t get_event_index_from_relative_timestamp(int64_t timestamp) const
+        {
+            EventView view{get_evt_view()};
+            if (view.begin_index == view.end_index)
+            {
+                return -1; // Vector is empty, return -1
+            }
+
+            std::size_t index{lower_bound_index(timestamp, view)};
+            return index == view.end_index ? -1 : static_cast<int64_t>(index); // -1 if not found
+        }
+
+        /**
+         * @brief Gets range of indices of events with relative timestamps in [start_timestamp, end_timestamp).
+         *        Does not lock, see get_evt_view.
+         * @param start_timestamp Start of time range in microseconds (inclusive).
+         * @param end_timestamp End of time range in microseconds (exclusive).
+         * @return [first, last) indices of events in time range, first == last if no event is in the range.
+         */
+        std::pair<std::size_t, std::size_t> get_event_index_range_from_relative_timestamps(int64_t start_timestamp,
+                                                                                           int64_t end_timestamp) const
+        {
+            EventView view{get_evt_view()};
+            std::size_t first{lower_bound_index(start_timestamp, view)};
+            std::size_t last{end_timestamp > start_timestamp ? lower_bound_index(end_timestamp, view) : first};
+            return {first, last};
+        }
+
+    private:
+        // EventFilter prepared for branch-free tests, one unsigned compare tests both ends of a coordinate range
+        struct FilterBounds
+        {
+                int32_t x;
+                int32_t y;
+                uint32_t width;
+                uint32_t height;
+                uint32_t polarity_mask; // 0 matches both polarities
+                uint32_t polarity;
+        };
+
+        /**
+         * @brief Tests an event against a filter without branching.
+         * @param x x coordinate of event.
+         * @param y y coordinate of event.
+         * @param polarity polarity of event, 0 or 1.
+         * @param bounds filter to test against.
+         * @return 1 if the event matches, 0 otherwise.
+         */
+        static std::size_t filter_match(int32_t x, int32_t y, uint32_t polarity, const FilterBounds &bounds)
+        {
+            return static_cast<std::size_t>((static_cast<uint32_t>(x - bounds.x) < bounds.width) &
+                                            (static_cast<uint32_t>(y - bounds.y) < bounds.height) &
+                                            ((polarity & bounds.polarity_mask) == bounds.polarity));
+        }
+
+        /**
+         * @brief Tests a stored vec4 event against a filter without branching.
+         * @param evt stored event.
+         * @param bounds filter to test against.
+         * @return 1 if the event matches, 0 otherwise.
+         */
+        static std::size_t filter_match(const glm::vec4 &evt, const FilterBounds &bounds)
+        {
+            return filter_match(static_cast<int32_t>(evt.x), static_cast<int32_t>(evt.y),
+                                static_cast<uint32_t>(evt.w), bounds);
+        }
+
+        /**
+         * @brief Tests a stored packed event against a filter without branching.
+         * @param evt stored event.
+         * @param bounds filter to test against.
+         * @return 1 if the event matches, 0 otherwise.
+         */
+        static std::size_t filter_match(const PackedEvent &evt, const FilterBounds &bounds)
+        {
+            return filter_match(evt.x, evt.y, evt.time_polarity >> 31, bounds);
+        }
+
+        /**
+         * @brief Number of retained published events in the active format.
+         * @return number of retained events.
+         */
+        std::size_t evt_count() const
+        {
+            return visit_evt_buffer([](const auto &events) { return events.size(); });
+        }
+
+        /**
+         * @brief Index of first retained event in the active format.
+         * @return index of first retained event.
+         */
+        std::size_t evt_begin_index() const
+        {
+            return visit_evt_buffer([](const auto &events) { return events.begin_index(); });
+        }
+
+        /**
+         * @brief Index one past the last published event in the active format.
+         * @return index one past the last published event.
+         */
+        std::size_t evt_end_index() const
+        {
+            return visit_evt_buffer([](const auto &events) { return events.end_index(); });
+        }
+
+        /**
+         * @brief Number of events in one storage chunk of the active format, the granularity of eviction.
+         * @return number of events in one storage chunk.
+         */
+        std::size_t evt_chunk_capacity() const
+        {
+            return visit_evt_buffer(
+                [](const auto &events) { return std::remove_cvref_t<decltype(events)>::kChunkCapacity; });
+        }
+
+        /**
+         * @brief Evicts the oldest storage chunks while all of their events fall outside the retention limit, along
+         *        with their time index entries, time segments and frames. Caller must hold evt_lock.
+         * @param timestamp_relative relative timestamp of the newest event in microseconds.
+         */
+        void evict_expired_evts(int64_t timestamp_relative)
+        {
+            const std::size_t chunk_capacity{evt_chunk_capacity()};
+            const std::size_t evicted_begin{evt_begin_index()};
+
+            while (evt_count() > chunk_capacity)
+            {
+                // Front chunk expires once the data after it alone satisfies the limit
+                bool expired{false};
+                if (evt_retention_mode == RetentionMode::EVENTS)
+                {
+                    expired = evt_count() - chunk_capacity >= static_cast<std::size_t>(evt_retention_limit);
+                }
+                else if (evt_retention_mode == RetentionMode::DURATION)
+                {
+                    expired = get_evt_relative_time(evt_begin_index() + chunk_capacity) <=
+                              timestamp_relative - evt_retention_limit;
+                }
+                // Or once it only holds events of epochs beyond the epoch limit
+                if (evt_epoch_limit > 1 && evt_epochs.size() > evt_epoch_limit)
+                {
+                    expired = expired || evt_begin_index() + chunk_capacity <=
+                                             evt_epochs[evt_epochs.end_index() - evt_epoch_limit].first_index;
+                }
+                if (!expired)
+                {
+                    break;
+                }
+
+                visit_evt_buffer([](auto &events) { events.pop_front_chunk(); });
+            }
+
+            if (evt_begin_index() != evicted_begin)
+            {
+                evict_evt_indices();
+            }
+        }
+
+        /**
+         * @brief Drops what describes events evicted from the front of the event buffer: time index entries, time
+         *        segments, polarity indices, frames, samples and event count buckets. Caller must hold evt_lock.
+         */
+        void evict_evt_indices()
+        {
+            // Drop chunks of time index entries and time segments once they only describe evicted events
+            constexpr std::size_t INDEX_CHUNK{MappedEventBuffer<int64_t>::kChunkCapacity};
+            while (evt_time_index.begin_index() + INDEX_CHUNK <= evt_begin_index() / kTimeIndexStride &&
+                   evt_time_index.pop_front_chunk())
+            {
+            }
+            while (evt_positive_index.begin_index() + INDEX_CHUNK <= evt_begin_index() / kTimeIndexStride &&
+                   evt_positive_index.pop_front_chunk())
+            {
+            }
+            constexpr std::size_t POLARITY_CHUNK{MappedEventBuffer<uint32_t>::kChunkCapacity};
+            const std::size_t positive_begin{static_cast<std::size_t>(positive_evts_before(evt_begin_index()))};
+            const std::array<std::size_t, 2> polarity_begin{evt_begin_index() - positive_begin, positive_begin};
+            for (std::size_t polarity{0}; polarity < 2; ++polarity)
+            {
+                while (evt_polarity_indices[polarity].begin_index() + POLARITY_CHUNK <= polarity_begin[polarity] &&
+                       evt_polarity_indices[polarity].pop_front_chunk())
                 {
-                    return capacity_ == 0 ? nullptr : reinterpret_cast<value_type *>(mapped_file_.data());
                 }
+            }
+            constexpr std::size_t SEGMENT_CHUNK{MappedEventBuffer<TimeSegment>::kChunkCapacity};
+            while (evt_time_segments.chunk_count() > 1 &&
+                   evt_time_segments[evt_time_segments.begin_index() + SEGMENT_CHUNK].first_index <=
+                       evt_begin_index() &&
+                   evt_time_segments.pop_front_chunk())
+            {
+            }
 
-                /**
-                 * @brief Returns pointer to const internal data.
-                 * @return pointer to const internal data.
-                 */
-                const value_type *ptr() const
-                {
-                    return capacity_ == 0 ? nullptr : reinterpret_cast<const value_type *>(mapped_file_.data());
-                }
-        };
+            // Drop frames and samples older than the first retained event
+            frame_store.evict_before(get_evt_relative_time(evt_begin_index()));
+            imu_store.evict_before(get_evt_relative_time(evt_begin_index()));
+            trigger_store.evict_before(get_evt_relative_time(evt_begin_index()));
+            evt_tile_index.evict_before(evt_begin_index());
+            evt_sealed.evict_before(evt_begin_index());
+        }
 
-        // Internal structs
-        // Represents single event datum
-        struct EventDatum
+        /**
+         * @brief Size in bytes of one event in the active format.
+         * @return size in bytes of one event.
+         */
+        std::size_t evt_element_size() const
         {
-                int32_t x;
-                int32_t y;
-                int64_t timestamp;
-                uint8_t polarity;
-        };
+            // Columnar events are gathered to the packed layout for upload
+            return evt_format == EventFormat::VEC4 ? sizeof(glm::vec4) : sizeof(PackedEvent);
+        }
 
-        // Represents a single frame datum
-        struct FrameDatum
+        /**
+         * @brief Largest time offset from a segment base the active format stores exactly.
+         * @return largest exact time offset in microseconds.
+         */
+        int64_t max_time_offset() const
         {
-                cv::Mat frameData;
-                int64_t timestamp;
-        };
-
-        // Member variables
-    private:
-        // Stores event and frame data with relative timestamps (timestamps - earliest event timestamp)
-        MappedEventBuffer evt_data_vector_relative;
-        std::vector<std::pair<cv::Mat, float>> frame_data_vector_relative;
-
-        // Earliest event/frame timestamps
-        int64_t evt_data_earliest_timestamp{-1};
-
-        int64_t evt_data_latest_timestamp{-1};
-        int64_t frame_data_latest_timestamp{-1};
-
-        // Set camera resolution
-        int32_t camera_event_width{};
-        int32_t camera_event_height{};
+            return evt_format == EventFormat::VEC4 ? kVec4MaxTimeOffset : kPackedMaxTimeOffset;
+        }
 
-        int32_t camera_frame_width{};
-        int32_t camera_frame_height{};
+        /**
+         * @brief Handles a camera reset, timestamps are all back to zero. With an epoch limit of 1 all data is
+         *        cleared, otherwise the data is kept as a finished epoch and the next event starts a new one right
+         *        after the latest event or frame. Caller must hold evt_lock.
+         */
+        void reset_evt_data()
+        {
+            if (evt_epoch_limit != 1 && !evt_epochs.empty())
+            {
+                if (evt_pending_epoch_start < 0)
+                {
+                    int64_t latest_timestamp{std::max(evt_data_latest_timestamp, frame_data_latest_timestamp)};
+                    evt_pending_epoch_start = latest_timestamp - evt_data_earliest_timestamp + 1;
+                }
+                evt_data_latest_timestamp = -1;
+                frame_data_latest_timestamp = -1;
+                return;
+            }
 
-        std::recursive_mutex evt_lock;
+            evt_data_earliest_timestamp = -1;
+            evt_data_latest_timestamp = -1;
+            frame_data_latest_timestamp = -1;
+            evt_pending_epoch_start = -1;
+            clear_evt_vectors();
+            frame_store.clear();
+        }
 
-    public:
         /**
-         * @brief Default constructor for event data.
+         * @brief Clears stored events and their time segments. The generation is odd during the clear so readers
+         *        neither take views of nor trust data read across it. Caller must hold evt_lock.
          */
-        EventData()
-            : evt_data_vector_relative{}, frame_data_vector_relative{}, evt_data_earliest_timestamp{-1},
-              evt_data_latest_timestamp{-1}, frame_data_latest_timestamp{-1}, camera_event_width{},
-              camera_event_height{}, camera_frame_width{}, camera_frame_height{}, evt_lock{}
+        void clear_evt_vectors()
         {
+            evt_generation.fetch_add(1, std::memory_order_acq_rel);
+            evt_data_vector_relative.clear();
+            evt_data_packed_relative.clear();
+            evt_data_columnar_relative.clear();
+            evt_time_segments.clear();
+            evt_epochs.clear();
+            evt_time_index.clear();
+            evt_positive_index.clear();
+            evt_positive_count = 0;
+            evt_polarity_indices[0].clear();
+            evt_polarity_indices[1].clear();
+            imu_store.clear();
+            trigger_store.clear();
+            evt_tile_index.clear();
+            evt_sealed.clear();
+            evt_generation.fetch_add(1, std::memory_order_release);
         }
 
         /**
-         * @brief Clears everything
+         * @brief Finds index of first event with relative timestamp equal or greater than timestamp. The sparse time
+         *        index narrows the search to one block of kTimeIndexStride events which is then binary searched.
+         * @param timestamp relative timestamp in microseconds.
+         * @param view events to search.
+         * @return index of first event at or after timestamp, view.end_index if there is none.
          */
-        void clear()
+        std::size_t lower_bound_index(int64_t timestamp, const EventView &view) const
         {
-            std::unique_lock<std::recursive_mutex> evt_lock_ul{evt_lock};
+            // Index entries of the events in view, entries are published before their events
+            using index_iterator = MappedEventBuffer<int64_t>::const_iterator;
+            std::size_t first_entry{view.begin_index / kTimeIndexStride};
+            std::size_t last_entry{std::min((view.end_index + kTimeIndexStride - 1) / kTimeIndexStride,
+                                            evt_time_index.end_index())};
+            if (first_entry >= last_entry)
+            {
+                return view.begin_index;
+            }
 
-            // Clear ref vectors
-            evt_data_vector_relative.clear();
-            frame_data_vector_relative.clear();
+            // First indexed event at or after timestamp, the answer is in the block before it or is that event
+            index_iterator first_it{&evt_time_index, first_entry};
+            auto entry = std::lower_bound(first_it, index_iterator{&evt_time_index, last_entry}, timestamp);
+            if (entry == first_it)
+            {
+                return view.begin_index;
+            }
+            std::size_t block{first_entry + static_cast<std::size_t>(entry - first_it)};
 
-            evt_data_earliest_timestamp = -1;
+            std::size_t first{(block - 1) * kTimeIndexStride + 1}; // Indexed event itself is before timestamp
+            std::size_t last{std::min(block * kTimeIndexStride, view.end_index)};
 
-            evt_data_latest_timestamp = -1;
-            frame_data_latest_timestamp = -1;
+            // All events of the block share at most a couple of time segments, resolve them once
+            std::size_t segment{segment_of(first)};
+            while (first < last)
+            {
+                std::size_t segment_last{segment_last_index(segment, first, last)};
+                int64_t time_offset{timestamp - evt_time_segments[segment].base_time};
+                std::size_t index{lower_bound_offset(first, segment_last, time_offset)};
+                if (index < segment_last)
+                {
+                    return index;
+                }
+                first = segment_last;
+                ++segment;
+            }
+            return last;
+        }
 
-            camera_event_width = 0;
-            camera_event_height = 0;
+        /**
+         * @brief Binary searches stored time offsets of events in [first, last), all in the same time segment.
+         *        Offsets are compared as integers to stay exact.
+         * @param first index of first event.
+         * @param last index one past last event.
+         * @param time_offset time offset from the segment base in microseconds.
+         * @return index of first event with offset equal or greater than time_offset, last if there is none.
+         */
+        std::size_t lower_bound_offset(std::size_t first, std::size_t last, int64_t time_offset) const
+        {
+            if (evt_format == EventFormat::COLUMNAR)
+            {
+                // Only the time column is read, 16 offsets per cache line
+                using time_iterator = MappedEventBuffer<uint32_t>::const_iterator;
+                const MappedEventBuffer<uint32_t> &time_offsets{evt_data_columnar_relative.time_offsets()};
+                time_iterator first_it{&time_offsets, first};
+                auto lb = std::lower_bound(first_it, time_iterator{&time_offsets, last}, time_offset,
+                                           [](uint32_t offset, int64_t value) {
+                                               return static_cast<int64_t>(offset) < value;
+                                           });
+                return first + static_cast<std::size_t>(lb - first_it);
+            }
 
-            camera_frame_width = 0;
-            camera_frame_height = 0;
+            if (evt_format == EventFormat::PACKED)
+            {
+                using packed_iterator = MappedEventBuffer<PackedEvent>::const_iterator;
+                packed_iterator first_it{&evt_data_packed_relative, first};
+                auto lb = std::lower_bound(first_it, packed_iterator{&evt_data_packed_relative, last}, time_offset,
+                                           [](const PackedEvent &evt, int64_t offset) {
+                                               return static_cast<int64_t>(evt.time_polarity & kPackedTimeMask) <
+                                                      offset;
+                                           });
+                return first + static_cast<std::size_t>(lb - first_it);
+            }
 
-            evt_lock_ul.unlock();
+            using vec4_iterator = MappedEventBuffer<glm::vec4>::const_iterator;
+            vec4_iterator first_it{&evt_data_vector_relative, first};
+            auto lb = std::lower_bound(
+                first_it, vec4_iterator{&evt_data_vector_relative, last}, time_offset,
+                [](const glm::vec4 &evt, int64_t offset) { return static_cast<int64_t>(evt.z) < offset; });
+            return first + static_cast<std::size_t>(lb - first_it);
         }
 
         /**
-         * @brief Locks event data vectors. If a thread calls get_*_vector_ref functions and uses the returned
-         *        reference to vectors, the thread must call this. Any use of the reference vector must be inside a
-         *        critical section for thread-safety.
+         * @brief Finds the time segment holding the event at index.
+         * @param index index of event.
+         * @return index of time segment.
          */
-        void lock_data_vectors()
+        std::size_t segment_of(std::size_t index) const
         {
-            evt_lock.lock();
+            auto first = evt_time_segments.begin();
+            auto segment = std::upper_bound(first, evt_time_segments.end(), index,
+                                            [](std::size_t i, const TimeSegment &seg) { return i < seg.first_index; });
+            // Only a reader racing with a clear can find no segment, any segment in range is safe to read then
+            std::ptrdiff_t position{std::max<std::ptrdiff_t>(segment - first, 1) - 1};
+            return first.index() + static_cast<std::size_t>(position);
         }
 
         /**
-         * @brief Unlocks event data vectors. If a thread calls get_*_vector_ref functions and uses the returned
-         *        reference to vectors, the thread must call this after it is done using the data vectors.
-         *        Any use of the reference vector must be inside a critical section for thread-safety.
+         * @brief Finds where a run of events in [first, last) within one time segment ends. Clamped to
+         *        [first + 1, last] so loops over segments always make progress, even when racing with a clear.
+         * @param segment index of time segment holding the event at first.
+         * @param first index of first event, less than last.
+         * @param last index one past last event.
+         * @return index one past the last event of the run.
          */
-        void unlock_data_vectors()
+        std::size_t segment_last_index(std::size_t segment, std::size_t first, std::size_t last) const
         {
-            evt_lock.unlock();
+            if (segment + 1 >= evt_time_segments.end_index())
+            {
+                return last;
+            }
+            return std::clamp(evt_time_segments[segment + 1].first_index, first + 1, last);
         }
 
         /**
-         * @brief Sets camera resolution for event data.
-         * @param width Width of camera.
-         * @param height Height of camera.
+         * @brief Stored time offset of the event at index from its time segment base.
+         * @param index index of event.
+         * @return time offset in microseconds.
          */
-        void set_camera_event_resolution(int32_t width, int32_t height)
+        int64_t evt_time_offset(std::size_t index) const
         {
-            std::unique_lock<std::recursive_mutex> evt_lock_ul{evt_lock};
-            camera_event_width = width;
-            camera_event_height = height;
-            evt_lock_ul.unlock();
+            if (evt_format == EventFormat::COLUMNAR)
+            {
+                return static_cast<int64_t>(evt_data_columnar_relative.time_offset(index));
+            }
+            if (evt_format == EventFormat::PACKED)
+            {
+                return static_cast<int64_t>(evt_data_packed_relative[index].time_polarity & kPackedTimeMask);
+            }
+            return static_cast<int64_t>(evt_data_vector_relative[index].z);
         }
 
         /**
-         * @brief Sets camera resolution for frame data.
-         * @param width Width of camera.
-         * @param height Height of camera.
+         * @brief Polarity of the event at index.
+         * @param index index of event.
+         * @return polarity, 0 or 1.
          */
-        void set_camera_frame_resolution(int32_t width, int32_t height)
+        uint8_t evt_polarity(std::size_t index) const
         {
-            std::unique_lock<std::recursive_mutex> evt_lock_ul{evt_lock};
-            camera_frame_width = width;
-            camera_frame_height = height;
-            evt_lock_ul.unlock();
+            if (evt_format == EventFormat::COLUMNAR)
+            {
+                return evt_data_columnar_relative.polarity(index);
+            }
+            if (evt_format == EventFormat::PACKED)
+            {
+                return (evt_data_packed_relative[index].time_polarity & kPackedPolarityBit) ? 1 : 0;
+            }
+            return evt_data_vector_relative[index].w != 0.0f ? 1 : 0;
         }
 
         /**
-         * @brief Gets event camera resolution.
-         * @return event camera resolution as glm::vec2 (width, height).
+         * @brief Counts the positive events stored before index since the last clear, from the nearest positive count
+         *        index entry and the fewer than kTimeIndexStride events after it.
+         * @param index index of event, clamped to the retained events.
+         * @return number of positive events before index.
          */
-        glm::vec2 get_camera_event_resolution()
+        uint64_t positive_evts_before(std::size_t index) const
         {
-            std::unique_lock<std::recursive_mutex> evt_lock_ul{evt_lock};
-            glm::vec2 camera_res{static_cast<float>(camera_event_width), static_cast<float>(camera_event_height)};
-            evt_lock_ul.unlock();
-            return camera_res;
+            index = std::clamp(index, evt_begin_index(), evt_end_index());
+            if (evt_positive_index.empty())
+            {
+                return 0;
+            }
+            // The entry of index itself is not pushed yet when index is the end of a full stride
+            std::size_t entry{std::min(index / kTimeIndexStride, evt_positive_index.end_index() - 1)};
+            uint64_t positive{evt_positive_index[entry]};
+            for (std::size_t i{std::max(entry * kTimeIndexStride, evt_begin_index())}; i < index; ++i)
+            {
+                positive += evt_polarity(i);
+            }
+            return positive;
         }
 
         /**
-         * @brief Gets frame camera resolution.
-         * @return frame camera resolution as glm::vec2 (width, height).
+         * @brief Converts raw event data to a stored vec4 event.
+         * @param raw_evt_data raw event data.
+         * @param time_offset time offset from the segment base in microseconds.
+         * @param evt receives the stored event.
          */
-        glm::vec2 get_camera_frame_resolution()
+        static void make_evt(const EventDatum &raw_evt_data, int64_t time_offset, glm::vec4 &evt)
         {
-            std::unique_lock<std::recursive_mutex> evt_lock_ul{evt_lock};
-            glm::vec2 camera_res{static_cast<float>(camera_frame_width), static_cast<float>(camera_frame_height)};
-            evt_lock_ul.unlock();
-            return camera_res;
+            evt = glm::vec4{static_cast<float>(raw_evt_data.x), static_cast<float>(raw_evt_data.y),
+                            static_cast<float>(time_offset), static_cast<float>(raw_evt_data.polarity)};
         }
 
         /**
-         * @brief Inserts event data into the event data vector with relative timestamps (absolute timestamp - absolute
-         *        earliest event timestamp). Following documentation of the AEDAT formats
-         *        (https://docs.inivation.com/_static/inivation-docs_2025-08-05.pdf page 163), data is assumed to be
-         *        read in as monotonically increasing timestamps. If a decreasing timestamp is detected, as per documentation,
-         *        a camera reset/syncronization is assumed where timestamps are reset to 0.
-         * @param raw_evt_data Raw event data to add.
+         * @brief Converts raw event data to a stored packed event.
+         * @param raw_evt_data raw event data.
+         * @param time_offset time offset from the segment base in microseconds.
+         * @param evt receives the stored event.
          */
-        void write_evt_data(EventDatum raw_evt_data)
+        static void make_evt(const EventDatum &raw_evt_data, int64_t time_offset, PackedEvent &evt)
         {
-            std::unique_lock<std::recursive_mutex> evt_lock_ul{evt_lock};
-
-            // 100 GB / sizeof(glm::vec4) =  max number of elements to reach 100 GB
-            constexpr size_t MAX_EVENT_BACKING_SIZE{
-                (static_cast<size_t>(100) * (static_cast<size_t>(1) << 30)) /
-                sizeof(glm::vec4)}; // Set 100 GB approximately as maximum of backing store
+            evt = pack_event(raw_evt_data.x, raw_evt_data.y, static_cast<uint32_t>(time_offset), raw_evt_data.polarity);
+        }
 
-            // If this condition is met, then we have unordered data, assume camera reset, clear all previous data
-            // Or maximum number of event data has been reached
-            if ((raw_evt_data.timestamp < evt_data_latest_timestamp) ||
-                (evt_data_vector_relative.size() > MAX_EVENT_BACKING_SIZE))
+        /**
+         * @brief Appends samples of a stream recorded next to the events to its store, see write_imu_data_batch.
+         *        Caller must hold evt_lock.
+         * @param store store to append to.
+         * @param raw_data samples with camera timestamps.
+         * @param value callable getting the value to store of a sample.
+         */
+        template <typename Store, typename Datum, typename Value>
+        void append_samples(Store &store, std::span<const Datum> raw_data, Value &&value)
+        {
+            // Need to normalize timestamps relative to event data, ignore until event data of the epoch is in
+            if (evt_count() == 0 || evt_pending_epoch_start >= 0)
             {
-                // Reset assumed, timestamps are all back to zero, clear data
-                evt_data_earliest_timestamp = -1;
-                evt_data_latest_timestamp = -1;
-                frame_data_latest_timestamp = -1;
-                evt_data_vector_relative.clear();
-                frame_data_vector_relative.clear();
+                return;
             }
 
-            // update earliest timestamp
-            if (evt_data_vector_relative.empty())
+            int64_t latest_time{store.latest_time()};
+            for (const Datum &datum : raw_data)
             {
-                evt_data_earliest_timestamp = raw_evt_data.timestamp;
+                int64_t timestamp_relative{datum.timestamp - evt_data_earliest_timestamp};
+                if (timestamp_relative < latest_time)
+                {
+                    continue;
+                }
+                store.stage(timestamp_relative, value(datum));
+                latest_time = timestamp_relative;
             }
+            store.publish();
+        }
 
-            float x{static_cast<float>(raw_evt_data.x)};
-            float y{static_cast<float>(raw_evt_data.y)};
-            float timestamp_relative{static_cast<float>(raw_evt_data.timestamp - evt_data_earliest_timestamp)};
-            float polarity{static_cast<float>(raw_evt_data.polarity)};
-            evt_data_vector_relative.push_back(glm::vec4{x, y, timestamp_relative, polarity});
-
-            evt_data_latest_timestamp = raw_evt_data.timestamp;
-
-            evt_lock_ul.unlock();
+        /**
+         * @brief Stores events released by the reorder stage in the buffer of the active format. Caller must hold
+         *        evt_lock.
+         * @param raw_evt_data raw event data to add, sorted unless a camera reset happened.
+         */
+        void append_evts(std::span<const EventDatum> raw_evt_data)
+        {
+            visit_evt_buffer([&](auto &events) { append_evts(events, raw_evt_data); });
         }
 
         /**
-         * @brief Inserts frame data into the frame data vector with relative timestamps (absolute timestamp - absolute
-         *        earliest event timestamp). Following documentation of the AEDAT formats
-         *        (https://docs.inivation.com/_static/inivation-docs_2025-08-05.pdf page 163), data is assumed to be
-         *        read in as monotonically increasing timestamps. If a decreasing timestamp is detected, as per documentation,
-         *        a camera reset/syncronization is assumed where timestamps are reset to 0.
-         * @param raw_frame_data Raw frame data to add.
+         * @brief Implementation of write_evt_data_batch for one storage format. Following documentation of the AEDAT
+         *        formats (https://docs.inivation.com/_static/inivation-docs_2025-08-05.pdf page 163), data is assumed
+         *        to be read in as monotonically increasing timestamps. If a decreasing timestamp is detected, a camera
+         *        reset/syncronization is assumed where timestamps are reset to 0. Caller must hold evt_lock.
+         * @param events event buffer of the active format.
+         * @param raw_evt_data raw event data to add.
          */
-        void write_frame_data(FrameDatum raw_frame_data)
+        template <typename Buffer> void append_evts(Buffer &events, std::span<const EventDatum> raw_evt_data)
         {
-            std::unique_lock<std::recursive_mutex> evt_lock_ul{evt_lock};
+            using T = typename Buffer::value_type;
 
-            constexpr size_t MAX_FRAME_SIZE{static_cast<size_t>(1) << 20}; // Set max to 1 million frames
+            // 100 GB / size of an event = max number of elements to reach 100 GB
+            constexpr size_t MAX_EVENT_BACKING_BYTES{static_cast<size_t>(100) *
+                                                     (static_cast<size_t>(1) << 30)}; // Set 100 GB approximately
+            constexpr size_t MAX_EVENT_BACKING_SIZE{MAX_EVENT_BACKING_BYTES / sizeof(T)};
 
-            // If this condition is met, unordered frame assumes camera reset,
-            // or maximum number of frames met.
-            if ((raw_frame_data.timestamp < frame_data_latest_timestamp) ||
-                (frame_data_vector_relative.size() > MAX_FRAME_SIZE))
+            // Map storage for the whole batch at once. Ring retention reuses evicted chunks instead.
+            if (evt_retention_mode == RetentionMode::UNBOUNDED)
             {
-                // Reset assumed, timestamps are all back to zero, clear data
-                evt_data_earliest_timestamp = -1;
-                evt_data_latest_timestamp = -1;
-                frame_data_latest_timestamp = -1;
-                evt_data_vector_relative.clear();
-                frame_data_vector_relative.clear();
+                events.reserve(std::min(events.size() + raw_evt_data.size(), MAX_EVENT_BACKING_SIZE + 1));
             }
 
-            // update earliest timestamp
-            if (evt_data_vector_relative
-                    .empty()) // Need to normalize timestamps relative to event data, ignore until event data is in
+            const int64_t max_offset{max_time_offset()};
+            evt_tile_index.set_resolution(camera_event_width, camera_event_height);
+            for (const EventDatum &raw_evt : raw_evt_data)
             {
-                return;
-            }
+                std::size_t end_index{events.staged_end_index()};
+
+                // If this condition is met, then we have unordered data, assume camera reset
+                if (raw_evt.timestamp < evt_data_latest_timestamp)
+                {
+                    reorder_buffer.count_reset();
+                    reset_evt_data();
+                    end_index = events.staged_end_index();
+                }
+                // Or maximum number of event data has been reached, clear all previous data
+                else if (end_index - events.begin_index() > MAX_EVENT_BACKING_SIZE)
+                {
+                    evt_data_earliest_timestamp = -1;
+                    evt_data_latest_timestamp = -1;
+                    frame_data_latest_timestamp = -1;
+                    evt_pending_epoch_start = -1;
+                    clear_evt_vectors();
+                    frame_store.clear();
+                    end_index = events.staged_end_index();
+                }
 
-            float timestamp_relative{static_cast<float>(raw_frame_data.timestamp - evt_data_earliest_timestamp)};
+                // Start the first epoch, or a new one after a reset, and update earliest timestamp
+                if (end_index == events.begin_index() || evt_pending_epoch_start >= 0)
+                {
+                    int64_t start_time{evt_pending_epoch_start};
+                    if (end_index == events.begin_index())
+                    {
+                        start_time = evt_time_origin < 0 ? 0
+                                                         : std::max(raw_evt.timestamp - evt_time_origin, int64_t{0});
+                    }
+                    evt_data_earliest_timestamp = raw_evt.timestamp - start_time;
+                    evt_epochs.push_back(Epoch{end_index, start_time, evt_data_earliest_timestamp});
+                    evt_pending_epoch_start = -1;
+                }
 
-            frame_data_vector_relative.push_back(std::make_pair(raw_frame_data.frameData, timestamp_relative));
+                int64_t timestamp_relative{raw_evt.timestamp - evt_data_earliest_timestamp};
 
-            frame_data_latest_timestamp = raw_frame_data.timestamp;
+                // Publish every filled chunk. Evict expired data when the next event starts a new chunk, so the
+                // evicted chunk is reused for it.
+                if ((end_index & Buffer::kChunkMask) == 0 && end_index != events.begin_index())
+                {
+                    evt_polarity_indices[0].publish();
+                    evt_polarity_indices[1].publish();
+                    events.publish();
+                    if (evt_compression)
+                    {
+                        seal_evts(events);
+                    }
+                    if (evt_retention_mode != RetentionMode::UNBOUNDED || evt_epoch_limit > 1)
+                    {
+                        evict_expired_evts(timestamp_relative);
+                    }
+                }
 
-            evt_lock_ul.unlock();
+                // Start a new time segment once the offset from the current one can no longer be stored exactly.
+                // Segments and index entries are published before the events they describe.
+                if (evt_time_segments.empty() || timestamp_relative - evt_time_segments.back().base_time > max_offset)
+                {
+                    evt_time_segments.push_back(TimeSegment{end_index, timestamp_relative});
+                }
+
+                // Maintain sparse time and positive count indices
+                if (end_index % kTimeIndexStride == 0)
+                {
+                    evt_positive_index.push_back(evt_positive_count);
+                    evt_time_index.push_back(timestamp_relative);
+                }
+                evt_positive_count += raw_evt.polarity ? 1 : 0;
+                evt_polarity_indices[raw_evt.polarity ? 1 : 0].stage(static_cast<uint32_t>(end_index));
+
+                T evt;
+                make_evt(raw_evt, timestamp_relative - evt_time_segments.back().base_time, evt);
+                events.stage(evt);
+                evt_tile_index.add(raw_evt.x, raw_evt.y);
+
+                evt_data_latest_timestamp = raw_evt.timestamp;
+            }
+
+            evt_polarity_indices[0].publish();
+            evt_polarity_indices[1].publish();
+            events.publish();
         }
 
         /**
-         * @brief Exposes event data with relative timestamp (absolute timestamp - earliest event timestamp) as a vector
-         *        of glm::vec4. IMPORTANT: Caller must have called lock_data_vectors(). Call unlock_data_vectors() when
-         *        done working with the data vectors.
-         * @return const reference to internal event data vector.
+         * @brief Returns a copy of an event with its time offset shifted.
+         * @param evt event to shift.
+         * @param shift time shift in microseconds.
+         * @return shifted event.
          */
-        const MappedEventBuffer &get_evt_vector_ref() const
+        static glm::vec4 rebase_event(const glm::vec4 &evt, int64_t shift)
         {
-            return evt_data_vector_relative;
+            return glm::vec4{evt.x, evt.y, static_cast<float>(static_cast<int64_t>(evt.z) + shift), evt.w};
         }
 
         /**
-         * @brief Exposes frame data with relative timestamp (absolute timestamp - earliest event timestamp) as a vector
-         *        of pairs containing image data and timestamp. IMPORTANT: Caller must have called lock_data_vectors().
-         *        Call unlock_data_vectors() when done working with the data vectors.
-         * @return const reference to internal frame data vector.
+         * @brief Returns a copy of a packed event with its time offset shifted, saturated to the 31 bits available.
+         * @param evt event to shift.
+         * @param shift time shift in microseconds.
+         * @return shifted event.
          */
-        const std::vector<std::pair<cv::Mat, float>> &get_frame_vector_ref()
+        static PackedEvent rebase_event(const PackedEvent &evt, int64_t shift)
         {
-            return frame_data_vector_relative;
+            int64_t time{std::clamp(static_cast<int64_t>(evt.time_polarity & kPackedTimeMask) + shift, int64_t{0},
+                                    kPackedMaxTimeOffset)};
+            return PackedEvent{evt.x, evt.y,
+                               static_cast<uint32_t>(time) | (evt.time_polarity & kPackedPolarityBit)};
         }
 
         /**
-         * @brief Gets the earliest event timestamp.
-         * @return earliest event data timestamp.
+         * @brief Implementation of gather_roi_evts and gather_polarity_evts for one storage format.
+         * @param events event buffer of the active format.
+         * @param for_each_index callable passing the index of every event to copy, in order, to the callable it
+         *        takes.
+         * @param time_base relative timestamp the copied event times are offsets from.
+         * @param out bytes to append the copied events to.
          */
-        int64_t get_earliest_evt_timestamp()
+        template <typename Buffer, typename ForEachIndex>
+        void gather_rebased_evts(const Buffer &events, ForEachIndex &&for_each_index, int64_t time_base,
+                                 std::vector<std::byte> &out) const
         {
-            std::unique_lock<std::recursive_mutex> evt_lock_ul{evt_lock};
+            using T = typename Buffer::value_type;
+            for_each_index([&](std::size_t index) {
+                T evt{rebase_event(events[index], get_evt_time_base(index) - time_base)};
+                const std::byte *bytes{reinterpret_cast<const std::byte *>(&evt)};
+                out.insert(out.end(), bytes, bytes + sizeof(T));
+            });
+        }
 
-            if (evt_data_vector_relative.empty())
+        /**
+         * @brief Implementation of copy_evts for one storage format.
+         * @param events event buffer of the active format.
+         * @param first index of first event.
+         * @param last index one past last event.
+         * @param time_base relative time in microseconds event times are rebased to.
+         * @param out receives last - first events.
+         */
+        template <typename Buffer>
+        void copy_rebased(const Buffer &events, std::size_t first, std::size_t last, int64_t time_base,
+                          std::byte *out) const
+        {
+            using T = typename Buffer::value_type;
+            const std::size_t sealed_last{std::clamp(evt_sealed.end_index(), first, std::max(first, last))};
+            if (first < sealed_last)
             {
-                evt_lock_ul.unlock();
-                return -1; // No evt data
+                evt_sealed.decode(first, sealed_last, time_base, reinterpret_cast<T *>(out));
+                out += (sealed_last - first) * sizeof(T);
+            }
+            if constexpr (std::is_same_v<Buffer, ColumnarEventBuffer>)
+            {
+                // Columns are gathered straight into out and rebased there, without a staging copy
+                copy_columns_rebased(events, sealed_last, last, time_base, reinterpret_cast<PackedEvent *>(out));
             }
+            else
+            {
+                auto copy = [&out](std::span<const std::byte> span) {
+                    std::memcpy(out, span.data(), span.size_bytes());
+                    out += span.size_bytes();
+                };
+                for_each_rebased_span(events, sealed_last, last, time_base, copy);
+            }
+        }
 
-            int64_t earliest_timestamp{evt_data_earliest_timestamp};
+        /**
+         * @brief Implementation of copy_evts for columnar storage, gathers the columns straight into out.
+         * @param events columnar event buffer.
+         * @param first index of first event.
+         * @param last index one past last event.
+         * @param time_base relative time in microseconds event times are rebased to.
+         * @param out receives last - first events in packed layout.
+         */
+        void copy_columns_rebased(const ColumnarEventBuffer &events, std::size_t first, std::size_t last,
+                                  int64_t time_base, PackedEvent *out) const
+        {
+            first = std::max(first, events.begin_index());
+            last = std::min(last, events.end_index());
+            for (std::size_t segment{first < last ? segment_of(first) : 0}; first < last; ++segment)
+            {
+                std::size_t segment_last{segment_last_index(segment, first, last)};
+                int64_t shift{evt_time_segments[segment].base_time - time_base};
+                events.for_each_column_span(first, segment_last, [&](const ColumnarEventBuffer::ColumnSpan &span) {
+                    ColumnarEventBuffer::gather(span, 0, span.count, out);
+                    if (shift != 0)
+                    {
+                        std::transform(out, out + span.count, out,
+                                       [shift](const PackedEvent &evt) { return rebase_event(evt, shift); });
+                    }
+                    out += span.count;
+                });
+                first = segment_last;
+            }
+        }
 
-            evt_lock_ul.unlock();
+        /**
+         * @brief Seals every full storage chunk of events not sealed yet into compressed blocks and releases the
+         *        chunks' storage from memory. Caller must hold evt_lock.
+         * @param events event buffer of the active format.
+         */
+        template <typename Buffer> void seal_evts(const Buffer &events)
+        {
+            constexpr std::size_t BLOCK_EVENTS{SealedEventStore::kBlockEvents};
+            const std::size_t first_sealed{evt_sealed.end_index()};
+            const std::size_t sealed_last{events.end_index() & ~Buffer::kChunkMask};
+            if (first_sealed < events.begin_index() || first_sealed >= sealed_last)
+            {
+                return; // Blocks are sealed in order, evicted events can not be sealed anymore
+            }
 
-            return earliest_timestamp;
+            std::vector<EventDatum> block(BLOCK_EVENTS);
+            for (std::size_t first{first_sealed}; first < sealed_last; first += BLOCK_EVENTS)
+            {
+                std::size_t segment{segment_of(first)};
+                std::size_t segment_last{segment_last_index(segment, first, first + BLOCK_EVENTS)};
+                for (std::size_t i{0}; i < BLOCK_EVENTS; ++i)
+                {
+                    if (first + i == segment_last)
+                    {
+                        ++segment;
+                        segment_last = segment_last_index(segment, first + i, first + BLOCK_EVENTS);
+                    }
+                    glm::vec4 evt{unpack_event(events[first + i])};
+                    int64_t timestamp{evt_time_segments[segment].base_time + evt_time_offset(first + i)};
+                    block[i] = EventDatum{.x = static_cast<int32_t>(evt.x),
+                                          .y = static_cast<int32_t>(evt.y),
+                                          .timestamp = timestamp,
+                                          .polarity = static_cast<uint8_t>(evt.w)};
+                }
+                evt_sealed.seal(block);
+            }
+            events.advise(first_sealed, sealed_last, AccessAdvice::DONT_NEED);
         }
 
         /**
-         * @brief Gets index of first event data in relative event data vector with timestamp that is equal or greater
-         *        than provided timestamp.
-         * @param timestamp Provided timestamp.
-         * @return -1 if relative event data vector is empty or index not found, index otherwise.
+         * @brief Pixel position of a stored event.
+         * @param index index of event.
+         * @return x and y coordinates of event.
          */
-        int64_t get_event_index_from_relative_timestamp(float timestamp)
+        std::pair<int32_t, int32_t> evt_position(std::size_t index) const
         {
-            std::unique_lock<std::recursive_mutex> evt_lock_ul{evt_lock};
-
-            if (evt_data_vector_relative.empty())
+            if (evt_format == EventFormat::COLUMNAR)
             {
-                evt_lock_ul.unlock();
-                return -1; // Vector is empty, return -1
+                return evt_data_columnar_relative.position(index);
             }
+            if (evt_format == EventFormat::PACKED)
+            {
+                const PackedEvent &evt{evt_data_packed_relative[index]};
+                return {evt.x, evt.y};
+            }
+            const glm::vec4 &evt{evt_data_vector_relative[index]};
+            return {static_cast<int32_t>(evt.x), static_cast<int32_t>(evt.y)};
+        }
+
+        /**
+         * @brief Implementation of for_each_evt_span for one storage format.
+         * @param events event buffer of the active format.
+         * @param first index of first event.
+         * @param last index one past last event.
+         * @param time_base relative time in microseconds event times are rebased to.
+         * @param fn callable taking a std::span<const std::byte>.
+         */
+        template <typename Buffer, typename Fn>
+        void for_each_rebased_span(const Buffer &events, std::size_t first, std::size_t last, int64_t time_base,
+                                   Fn &fn) const
+        {
+            using T = typename Buffer::value_type;
+            constexpr std::size_t STAGING_SIZE{static_cast<std::size_t>(1) << 16}; // Events converted at a time
 
-            glm::vec4 timestampVec4(0.0f, 0.0f, timestamp, 0.0f);
+            std::vector<T> staging{};
+            first = std::max(first, events.begin_index());
+            last = std::min(last, events.end_index());
 
-            // evt_data_vector_relative should be sorted by the way EventData class is setup.
-            auto lb = std::lower_bound(evt_data_vector_relative.begin(), evt_data_vector_relative.end(), timestampVec4,
-                                       event_less_vec4_t);
-            if (lb == evt_data_vector_relative.end())
+            // Sealed events are decoded from memory rather than read from storage
+            for (const std::size_t sealed_last{std::min(last, evt_sealed.end_index())}; first < sealed_last;)
             {
-                return -1; // Not found
+                std::size_t count{std::min(STAGING_SIZE, sealed_last - first)};
+                staging.resize(count);
+                evt_sealed.decode(first, first + count, time_base, staging.data());
+                fn(std::as_bytes(std::span<const T>{staging}));
+                first += count;
             }
-            int64_t ret_index{static_cast<int64_t>(std::distance(evt_data_vector_relative.begin(), lb))};
 
-            evt_lock_ul.unlock();
-            return ret_index;
+            for (std::size_t segment{first < last ? segment_of(first) : 0}; first < last; ++segment)
+            {
+                std::size_t segment_last{segment_last_index(segment, first, last)};
+                int64_t shift{evt_time_segments[segment].base_time - time_base};
+
+                events.for_each_span(first, segment_last, [&](std::span<const T> span) {
+                    if (shift == 0)
+                    {
+                        fn(std::as_bytes(span));
+                        return;
+                    }
+                    for (std::size_t offset{0}; offset < span.size(); offset += STAGING_SIZE)
+                    {
+                        std::span<const T> block{span.subspan(offset, std::min(STAGING_SIZE, span.size() - offset))};
+                        staging.resize(block.size());
+                        std::transform(block.begin(), block.end(), staging.begin(),
+                                       [shift](const T &evt) { return rebase_event(evt, shift); });
+                        fn(std::as_bytes(std::span<const T>{staging}));
+                    }
+                });
+                first = segment_last;
+            }
         }
 };
 
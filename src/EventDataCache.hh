@@ -0,0 +1,191 @@
+#pragma once
+#ifndef EVENT_DATA_CACHE_HH
+#define EVENT_DATA_CACHE_HH
+
+#include "EventData.hh"
+
+#include <algorithm>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <system_error>
+#include <vector>
+
+/**
+ * @brief Persists decoded file data next to the source file so reopening the file maps the cache instead of decoding
+ *        it again. The cache of "recording.aedat4" is the directory "recording.aedat4.nova-cache", it holds the output
+ *        of EventData::save_cache and a key identifying the source file it was decoded from. A cache whose key does
+ *        not match the source file (changed size, modification time or contents) is ignored and replaced on the next
+ *        save.
+ */
+class EventDataCache
+{
+    private:
+        // Layout version of key.bin, bump whenever CacheKey changes
+        static constexpr uint32_t kKeyVersion{1};
+        // Bytes hashed at each end of the source file
+        static constexpr std::size_t kHashedBytes{static_cast<std::size_t>(1) << 20};
+
+        // Identifies the source file and decode settings a cache was made from
+        struct CacheKey
+        {
+                uint32_t version;
+                EventData::EventFormat evt_format;
+                uint64_t file_size;
+                int64_t file_mtime;
+                uint64_t content_hash;
+
+                bool operator==(const CacheKey &) const = default;
+        };
+
+        /**
+         * @brief Gets the cache directory of a source file.
+         * @param file_name name of the source file.
+         * @return path of the cache directory.
+         */
+        static std::filesystem::path cache_path(const std::string &file_name)
+        {
+            return std::filesystem::path{file_name + ".nova-cache"};
+        }
+
+        /**
+         * @brief FNV-1a hash of the first and last kHashedBytes of a file. Catches files rewritten in place with the
+         *        same size and modification time without reading all of a multi gigabyte recording.
+         * @param file_name name of the file to hash.
+         * @param file_size size of the file in bytes.
+         * @return hash of the file, 0 if it could not be read.
+         */
+        static uint64_t hash_file_ends(const std::string &file_name, uint64_t file_size)
+        {
+            std::ifstream file{file_name, std::ios::binary};
+            if (!file)
+            {
+                return 0;
+            }
+
+            uint64_t hash{14695981039346656037ull};
+            std::vector<char> bytes(kHashedBytes);
+            auto hash_range = [&](uint64_t offset, uint64_t count) {
+                file.seekg(static_cast<std::streamoff>(offset));
+                file.read(bytes.data(), static_cast<std::streamsize>(count));
+                for (std::streamsize i{0}; i < file.gcount(); ++i)
+                {
+                    hash = (hash ^ static_cast<unsigned char>(bytes[i])) * 1099511628211ull;
+                }
+            };
+
+            hash_range(0, std::min<uint64_t>(file_size, kHashedBytes));
+            if (file_size > kHashedBytes)
+            {
+                uint64_t tail_offset{std::max<uint64_t>(file_size - kHashedBytes, kHashedBytes)};
+                hash_range(tail_offset, file_size - tail_offset);
+            }
+            return file ? hash : 0;
+        }
+
+        /**
+         * @brief Computes the cache key of a source file as it is now.
+         * @param file_name name of the source file.
+         * @param evt_format storage format events are decoded into.
+         * @param key key to fill.
+         * @return true if the key was computed, false if the file could not be inspected.
+         */
+        static bool make_key(const std::string &file_name, EventData::EventFormat evt_format, CacheKey &key)
+        {
+            std::error_code error{};
+            uint64_t file_size{std::filesystem::file_size(file_name, error)};
+            if (error)
+            {
+                return false;
+            }
+            auto file_mtime{std::filesystem::last_write_time(file_name, error)};
+            if (error)
+            {
+                return false;
+            }
+
+            key = CacheKey{.version = kKeyVersion,
+                           .evt_format = evt_format,
+                           .file_size = file_size,
+                           .file_mtime = static_cast<int64_t>(file_mtime.time_since_epoch().count()),
+                           .content_hash = hash_file_ends(file_name, file_size)};
+            return key.content_hash != 0;
+        }
+
+    public:
+        /**
+         * @brief Loads the cache of a source file into an EventData object if the cache is valid for the file as it
+         *        is now and for the current storage format of the EventData object.
+         * @param file_name name of the source file.
+         * @param evt_data EventData object to load into, cleared if a valid cache fails to load.
+         * @return true if the cache was loaded, false if decoding the source file is needed.
+         */
+        static bool load(const std::string &file_name, EventData &evt_data)
+        {
+            std::filesystem::path directory{cache_path(file_name)};
+            CacheKey expected_key{};
+            if (!std::filesystem::is_directory(directory) ||
+                !make_key(file_name, evt_data.get_evt_format(), expected_key))
+            {
+                return false;
+            }
+
+            CacheKey saved_key{};
+            std::ifstream key_file{directory / "key.bin", std::ios::binary};
+            key_file.read(reinterpret_cast<char *>(&saved_key), sizeof(saved_key));
+            if (!key_file || !(saved_key == expected_key))
+            {
+                return false;
+            }
+
+            return evt_data.load_cache(directory);
+        }
+
+        /**
+         * @brief Saves the data of an EventData object as the cache of a source file, replacing any previous cache.
+         *        The cache is written to a temporary directory first and the key is written last, so an interrupted
+         *        save never leaves a cache that looks valid.
+         * @param file_name name of the source file the data was fully decoded from.
+         * @param evt_data EventData object to save.
+         * @return true if the cache was saved, false otherwise.
+         */
+        static bool save(const std::string &file_name, EventData &evt_data)
+        {
+            std::filesystem::path directory{cache_path(file_name)};
+            std::filesystem::path temp_directory{directory.string() + ".tmp"};
+            CacheKey key{};
+            if (!make_key(file_name, evt_data.get_evt_format(), key))
+            {
+                return false;
+            }
+
+            std::error_code error{};
+            std::filesystem::remove_all(temp_directory, error);
+            if (!std::filesystem::create_directory(temp_directory, error) || !evt_data.save_cache(temp_directory))
+            {
+                std::filesystem::remove_all(temp_directory, error);
+                return false;
+            }
+
+            std::ofstream key_file{temp_directory / "key.bin", std::ios::binary | std::ios::trunc};
+            key_file.write(reinterpret_cast<const char *>(&key), sizeof(key));
+            key_file.close();
+            if (!key_file)
+            {
+                std::filesystem::remove_all(temp_directory, error);
+                return false;
+            }
+
+            std::filesystem::remove_all(directory, error);
+            std::filesystem::rename(temp_directory, directory, error);
+            if (error)
+            {
+                std::filesystem::remove_all(temp_directory, error);
+                return false;
+            }
+            return true;
+        }
+};
+
+#endif // EVENT_DATA_CACHE_HH
@@ -0,0 +1,157 @@
+#pragma once
+#ifndef EVENT_PREFETCHER_HH
+#define EVENT_PREFETCHER_HH
+
+#include "EventData.hh"
+#include "VirtualMemory.hh"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+
+/**
+ * @brief Reads event data ahead of the scrubber so the render thread does not stall on page faults when recordings
+ *        are larger than RAM. Follows the scrubber window and its speed and direction: the events the scrubber will
+ *        show within kLookaheadSeconds are prefetched in the background, and events that fall out of that range are
+ *        dropped from memory before anything the scrubber still needs. Meant to be updated periodically from a
+ *        thread of its own.
+ */
+class EventPrefetcher
+{
+    public:
+        // How far ahead of the scrubber events are prefetched, in seconds of playback at the current speed
+        static constexpr double kLookaheadSeconds{0.5};
+        // Events kept hot around the window even when the scrubber stands still
+        static constexpr std::size_t kMinMargin{static_cast<std::size_t>(1) << 16};
+        // Most events prefetched ahead, bounds memory use at high speeds
+        static constexpr std::size_t kMaxLookahead{static_cast<std::size_t>(1) << 24};
+        // Weight of the newest speed sample, smooths out frame to frame jitter of the scrubber
+        static constexpr double kVelocitySmoothing{0.25};
+
+        /**
+         * @brief Constructor.
+         * @param evt_data EventData object to prefetch events of.
+         */
+        explicit EventPrefetcher(EventData &evt_data) : evt_data{evt_data}
+        {
+        }
+
+        /**
+         * @brief Updates the speed estimate from the scrubber window and advises the events that became hot or
+         *        cold since the last update.
+         * @param lower_index index of first event in the scrubber window.
+         * @param current_index index of last event in the scrubber window.
+         * @param now time the window was sampled at.
+         */
+        void update(std::size_t lower_index, std::size_t current_index, std::chrono::steady_clock::time_point now)
+        {
+            // Indices start over after a clear, the old hot range means nothing anymore
+            const uint64_t generation{evt_data.get_evt_view().generation};
+            if (!has_sample || generation != last_generation)
+            {
+                hot_first = 0;
+                hot_last = 0;
+                velocity = 0.0;
+            }
+            else
+            {
+                double seconds{std::chrono::duration<double>(now - last_time).count()};
+                double step{static_cast<double>(current_index) - static_cast<double>(last_index)};
+                if (std::abs(step) > static_cast<double>(kMaxLookahead))
+                {
+                    velocity = 0.0; // A seek, not playback
+                }
+                else if (seconds > 0.0)
+                {
+                    velocity += kVelocitySmoothing * (step / seconds - velocity);
+                }
+            }
+            has_sample = true;
+            last_generation = generation;
+            last_index = current_index;
+            last_time = now;
+
+            // Ahead of the window in the direction of playback, a small margin behind it
+            std::size_t lookahead{static_cast<std::size_t>(std::abs(velocity) * kLookaheadSeconds)};
+            lookahead = std::clamp(lookahead, kMinMargin, kMaxLookahead);
+            std::size_t first{lower_index - std::min(lower_index, velocity < 0.0 ? lookahead : kMinMargin)};
+            std::size_t last{current_index + 1 + (velocity < 0.0 ? kMinMargin : lookahead)};
+
+            // Only the difference to the previous range is advised, ranges move little from one update to the next
+            advise_difference(first, last, hot_first, hot_last, EventData::AccessAdvice::WILL_NEED);
+            advise_difference(hot_first, hot_last, first, last, EventData::AccessAdvice::DONT_NEED);
+            hot_first = first;
+            hot_last = last;
+        }
+
+        /**
+         * @brief Gets the estimated scrubber speed.
+         * @return speed in events per second, negative when playing backwards.
+         */
+        double get_velocity() const
+        {
+            return velocity;
+        }
+
+        /**
+         * @brief Gets the range of events currently kept hot, [first, last).
+         * @return pair of index of first event and index one past the last event.
+         */
+        std::pair<std::size_t, std::size_t> get_hot_range() const
+        {
+            return {hot_first, hot_last};
+        }
+
+        /**
+         * @brief Gets the number of page faults so far that had to wait on a read from disk, see
+         *        virtual_memory::page_fault_count.
+         * @return number of page faults.
+         */
+        static uint64_t get_page_fault_count()
+        {
+            return virtual_memory::page_fault_count();
+        }
+
+    private:
+        EventData &evt_data;
+
+        // Last scrubber sample
+        bool has_sample{false};
+        uint64_t last_generation{0};
+        std::size_t last_index{0};
+        std::chrono::steady_clock::time_point last_time{};
+        double velocity{0.0}; // Events per second
+
+        // Events advised WILL_NEED by the last update, [hot_first, hot_last)
+        std::size_t hot_first{0};
+        std::size_t hot_last{0};
+
+        /**
+         * @brief Advises the events in [first, last) that are not in [other_first, other_last).
+         * @param first index of first event of the range to advise.
+         * @param last index one past the last event of the range to advise.
+         * @param other_first index of first event of the range to leave out.
+         * @param other_last index one past the last event of the range to leave out.
+         * @param advice how soon the events are read.
+         */
+        void advise_difference(std::size_t first, std::size_t last, std::size_t other_first, std::size_t other_last,
+                               EventData::AccessAdvice advice)
+        {
+            if (other_first >= other_last)
+            {
+                other_first = last; // Nothing to leave out
+                other_last = last;
+            }
+            if (first < std::min(last, other_first))
+            {
+                evt_data.advise_evts(first, std::min(last, other_first), advice);
+            }
+            if (std::max(first, other_last) < last)
+            {
+                evt_data.advise_evts(std::max(first, other_last), last, advice);
+            }
+        }
+};
+
+#endif // EVENT_PREFETCHER_HH
@@ -7,6 +7,8 @@
 
 #include "imgui_internal.h"
 
+#include "AcquisitionPipeline.hh"
+#include "EventPrefetcher.hh"
 #include "ParameterStore.hh"
 #include "RenderTarget.hh"
 #include "Scrubber.hh"
@@ -18,6 +20,10 @@
 inline void SDLCALL stream_file_handle_callback(void *param_store, const char *const *data_file_list,
                                                 int filter_unused);
 
+// Callback used with SDL_ShowOpenFolderDialog in draw_stream_window
+inline void SDLCALL stream_session_folder_callback(void *param_store, const char *const *folder_list,
+                                                   int filter_unused);
+
 // Callback used with SDL_ShowSaveFileDialog in draw_stream_window
 inline void SDLCALL save_stream_handle_callback(void *param_store, const char *const *data_file_list,
                                                 int filter_unused);
@@ -41,6 +47,11 @@ class GUI
         std::vector<float> fps_history_buf;
         size_t fps_buf_index;
 
+        // Circular buffer of page faults per frame, and the fault count at the last frame
+        std::vector<float> page_fault_history_buf;
+        size_t page_fault_buf_index;
+        uint64_t last_page_fault_count;
+
         bool check_for_layout_file;
         bool show_quickstart;
 
@@ -310,7 +321,7 @@ class GUI
         }
 
         /**
-         * @brief Draw debug window containing fps data.
+         * @brief Draw debug window containing fps and page fault data.
          * @param fps Calculated fps in current frame.
          */
         void draw_debug_window(float fps)
@@ -331,6 +342,79 @@ class GUI
             ImGui::PlotLines("##FPS History", fps_history_buf.data(), static_cast<int>(fps_history_buf.size()),
                              static_cast<int>(fps_buf_index), nullptr, 0.0f, max_fps + 10.0f, ImVec2(0, 80));
             ImGui::Separator();
+
+            // Page faults of the render thread that waited on disk, should stay near 0 while playing
+            uint64_t page_fault_count{EventPrefetcher::get_page_fault_count()};
+            float page_faults{static_cast<float>(page_fault_count - last_page_fault_count)};
+            last_page_fault_count = page_fault_count;
+            page_fault_history_buf[page_fault_buf_index] = page_faults;
+            page_fault_buf_index = (page_fault_buf_index + 1) % page_fault_history_buf.size();
+            float max_page_faults{*std::max_element(page_fault_history_buf.begin(), page_fault_history_buf.end())};
+            ImGui::Text("Page Faults This Frame: %.0f", page_faults);
+            ImGui::Text("Max Page Faults Per Frame: %.0f", max_page_faults);
+            ImGui::PlotLines("##Page Fault History", page_fault_history_buf.data(),
+                             static_cast<int>(page_fault_history_buf.size()), static_cast<int>(page_fault_buf_index),
+                             nullptr, 0.0f, max_page_faults + 1.0f, ImVec2(0, 80));
+            if (parameter_store->exists("prefetch_velocity"))
+            {
+                ImGui::Text("Prefetch Speed (ev/s): %.0f", parameter_store->get<double>("prefetch_velocity"));
+            }
+            ImGui::Separator();
+
+            // Live event rate by polarity, read from the count index so it costs nothing at any rate
+            if (parameter_store->exists("event_rate"))
+            {
+                std::array<double, 2> event_rate{parameter_store->get<std::array<double, 2>>("event_rate")};
+                ImGui::Text("Event Rate (ev/s): %.0f", event_rate[0] + event_rate[1]);
+                ImGui::Text("Positive / Negative (ev/s): %.0f / %.0f", event_rate[1], event_rate[0]);
+                ImGui::Separator();
+            }
+
+            // Out of order timestamps, many dropped events or frames call for a larger reorder tolerance
+            if (parameter_store->exists("event_reorder_stats"))
+            {
+                EventData::ReorderStats reorder_stats{
+                    parameter_store->get<EventData::ReorderStats>("event_reorder_stats")};
+                ImGui::Text("Reordered Events: %llu", static_cast<unsigned long long>(reorder_stats.reordered_evts));
+                ImGui::Text("Dropped Late Events: %llu", static_cast<unsigned long long>(reorder_stats.dropped_evts));
+                ImGui::Text("Dropped Late Frames: %llu", static_cast<unsigned long long>(reorder_stats.dropped_frames));
+                ImGui::Text("Camera Resets: %llu", static_cast<unsigned long long>(reorder_stats.resets));
+                ImGui::Text("Max Disorder (us): %lld", static_cast<long long>(reorder_stats.max_disorder));
+                ImGui::Text("Held Events: %zu", reorder_stats.held_evts);
+                ImGui::Separator();
+            }
+
+            // Where streamed data waits on its way to event data, see AcquisitionPipeline
+            if (parameter_store->exists("acquisition_stage_stats"))
+            {
+                auto stage_stats{parameter_store->get<std::array<AcquisitionPipeline::StageStats,
+                                                                 AcquisitionPipeline::kStageCount>>(
+                    "acquisition_stage_stats")};
+                const char *stage_names[]{"Read", "Convert", "Ingest", "Write"};
+                for (std::size_t stage{0}; stage < AcquisitionPipeline::kStageCount; ++stage)
+                {
+                    ImGui::Text("%s: %zu/%zu queued, %.0f batches/s, %.2f Mevt/s", stage_names[stage],
+                                stage_stats[stage].queue_depth, stage_stats[stage].queue_capacity,
+                                stage_stats[stage].batch_rate, stage_stats[stage].evt_rate / 1e6);
+                }
+                ImGui::Text("Dropped Camera Batches: %llu",
+                            static_cast<unsigned long long>(stage_stats[0].dropped_batches));
+                ImGui::Separator();
+            }
+
+            // Size of compressed events, see Compress Event History
+            if (parameter_store->exists("sealed_event_usage"))
+            {
+                auto [sealed_evts, sealed_bytes] =
+                    parameter_store->get<std::pair<std::size_t, std::size_t>>("sealed_event_usage");
+                if (sealed_evts > 0)
+                {
+                    ImGui::Text("Compressed Events: %zu", sealed_evts);
+                    ImGui::Text("Compressed Bytes Per Event: %.2f",
+                                static_cast<double>(sealed_bytes) / static_cast<double>(sealed_evts));
+                    ImGui::Separator();
+                }
+            }
             if (ImGui::Button("Reset Layout"))
             {
                 reset_layout_with_dockbuilder();
@@ -458,7 +542,13 @@ class GUI
             ImGui::Text("Stream From File:");
             if (ImGui::Button("Open File To Stream"))
             {
-                SDL_ShowOpenFileDialog(stream_file_handle_callback, parameter_store, nullptr, nullptr, 0, nullptr, 0);
+                // Several files are opened as one session
+                SDL_ShowOpenFileDialog(stream_file_handle_callback, parameter_store, nullptr, nullptr, 0, nullptr, 1);
+            }
+            ImGui::SameLine();
+            if (ImGui::Button("Open Session Folder"))
+            {
+                SDL_ShowOpenFolderDialog(stream_session_folder_callback, parameter_store, nullptr, nullptr, 0);
             }
 
             if (!parameter_store->exists("stream_paused"))
@@ -519,6 +609,113 @@ class GUI
             }
             parameter_store->add("stream_save_events", stream_save_events);
 
+            if (!parameter_store->exists("event_storage_layout"))
+            {
+                parameter_store->add("event_storage_layout", 0);
+            }
+
+            int32_t event_storage_layout{parameter_store->get<int32_t>("event_storage_layout")};
+            int32_t event_storage_layout_copy{event_storage_layout};
+            // Packed events take 8 bytes instead of 16 byte vec4s, halving memory and upload bandwidth
+            // Columnar keeps times, coordinates and polarities apart so searches and filters read less memory
+            ImGui::Combo("Event Storage (Will Stop Streaming)", &event_storage_layout, "Vec4\0Packed\0Columnar\0");
+            if (event_storage_layout != event_storage_layout_copy)
+            {
+                parameter_store->add("program_state",
+                                     GUI::PROGRAM_STATE::IDLE); // Stop program to ensure correct initialization
+            }
+            parameter_store->add("event_storage_layout", event_storage_layout);
+
+            if (!parameter_store->exists("compress_event_history"))
+            {
+                parameter_store->add("compress_event_history", false);
+            }
+
+            bool compress_event_history{parameter_store->get<bool>("compress_event_history")};
+            bool compress_event_history_copy{compress_event_history};
+            // Keep full chunks of events compressed in memory and their storage out of memory, for long recordings
+            ImGui::Checkbox("Compress Event History (Will Stop Streaming)", &compress_event_history);
+            if (compress_event_history != compress_event_history_copy)
+            {
+                parameter_store->add("program_state",
+                                     GUI::PROGRAM_STATE::IDLE); // Stop program to ensure correct initialization
+            }
+            parameter_store->add("compress_event_history", compress_event_history);
+
+            if (!parameter_store->exists("use_file_cache"))
+            {
+                parameter_store->add("use_file_cache", false);
+            }
+
+            bool use_file_cache{parameter_store->get<bool>("use_file_cache")};
+            // Keep decoded files in a cache next to them so reopening them does not decode them again
+            // Only used when all events are kept, takes effect the next time a file is opened
+            ImGui::Checkbox("Cache Decoded Files", &use_file_cache);
+            parameter_store->add("use_file_cache", use_file_cache);
+
+            if (!parameter_store->exists("stream_decode_on_demand"))
+            {
+                parameter_store->add("stream_decode_on_demand", false);
+            }
+
+            bool stream_decode_on_demand{parameter_store->get<bool>("stream_decode_on_demand")};
+            // Opening a file only reads its packet table, parts of it are decoded when the Scrubber reaches them
+            // Takes effect the next time a file is opened
+            ImGui::Checkbox("Decode Files On Demand", &stream_decode_on_demand);
+            parameter_store->add("stream_decode_on_demand", stream_decode_on_demand);
+
+            if (!parameter_store->exists("event_retention_mode"))
+            {
+                parameter_store->add("event_retention_mode", 0);
+            }
+            if (!parameter_store->exists("event_retention_limit"))
+            {
+                parameter_store->add("event_retention_limit", 60.0f);
+            }
+
+            int32_t event_retention_mode{parameter_store->get<int32_t>("event_retention_mode")};
+            float event_retention_limit{parameter_store->get<float>("event_retention_limit")};
+            // Keep only the latest events so long running live streams use constant memory and disk
+            ImGui::Combo("Event Retention", &event_retention_mode, "Keep All\0Last N Million Events\0Last N Seconds\0");
+            if (event_retention_mode != 0)
+            {
+                ImGui::InputFloat(event_retention_mode == 1 ? "Million Events Retained" : "Seconds Retained",
+                                  &event_retention_limit);
+                event_retention_limit = std::max(event_retention_limit, 0.0f);
+            }
+            parameter_store->add("event_retention_mode", event_retention_mode);
+            parameter_store->add("event_retention_limit", event_retention_limit);
+
+            if (!parameter_store->exists("event_reorder_tolerance"))
+            {
+                parameter_store->add("event_reorder_tolerance", 1000); // 1 ms
+            }
+            if (!parameter_store->exists("event_reset_threshold"))
+            {
+                parameter_store->add("event_reset_threshold", 1000000); // 1 s
+            }
+
+            int32_t event_reorder_tolerance{parameter_store->get<int32_t>("event_reorder_tolerance")};
+            int32_t event_reset_threshold{parameter_store->get<int32_t>("event_reset_threshold")};
+            // Sort out events arriving slightly out of order, only large backward jumps in time are camera resets
+            ImGui::InputInt("Reorder Tolerance (us)", &event_reorder_tolerance);
+            ImGui::InputInt("Camera Reset Threshold (us)", &event_reset_threshold);
+            event_reorder_tolerance = std::max(event_reorder_tolerance, 0);
+            event_reset_threshold = std::max(event_reset_threshold, event_reorder_tolerance);
+            parameter_store->add("event_reorder_tolerance", event_reorder_tolerance);
+            parameter_store->add("event_reset_threshold", event_reset_threshold);
+
+            if (!parameter_store->exists("event_epoch_limit"))
+            {
+                parameter_store->add("event_epoch_limit", 1);
+            }
+
+            int32_t event_epoch_limit{parameter_store->get<int32_t>("event_epoch_limit")};
+            // Keep data from before camera resets as epochs to scrub, 1 clears data on every reset
+            ImGui::InputInt("Epochs Kept Across Resets (0 = All)", &event_epoch_limit);
+            event_epoch_limit = std::max(event_epoch_limit, 0);
+            parameter_store->add("event_epoch_limit", event_epoch_limit);
+
             if (!parameter_store->exists("stream_save_file_name"))
             {
                 std::string stream_save_file_name{""}; // No filename
@@ -642,6 +839,41 @@ class GUI
 
             ImGui::Separator();
 
+            // Epochs are the data recorded between camera resets, only listed once a reset kept one
+            std::vector<EventData::EpochRange> epochs{
+                parameter_store->get<std::vector<EventData::EpochRange>>("scrubber.epochs")};
+            if (epochs.size() > 1)
+            {
+                std::vector<std::string> epoch_names{"All"};
+                for (const EventData::EpochRange &epoch : epochs)
+                {
+                    epoch_names.push_back("Epoch " + std::to_string(epoch.id) + " (" +
+                                          std::to_string(epoch.last_index - epoch.first_index) + " Events)");
+                }
+                std::vector<const char *> epoch_names_char{};
+                for (std::string &element : epoch_names)
+                {
+                    epoch_names_char.push_back(element.c_str());
+                }
+
+                int64_t epoch_id{parameter_store->get<int64_t>("scrubber.epoch")};
+                int epoch_item{0};
+                for (std::size_t epoch{0}; epoch < epochs.size(); ++epoch)
+                {
+                    if (static_cast<int64_t>(epochs[epoch].id) == epoch_id)
+                    {
+                        epoch_item = static_cast<int>(epoch) + 1;
+                    }
+                }
+                if (ImGui::Combo("Epoch", &epoch_item, epoch_names_char.data(),
+                                 static_cast<int>(epoch_names_char.size())))
+                {
+                    int64_t selected_id{epoch_item == 0 ? -1 : static_cast<int64_t>(epochs[epoch_item - 1].id)};
+                    parameter_store->add("scrubber.epoch", selected_id);
+                }
+                ImGui::Separator();
+            }
+
             if (!parameter_store->exists("scrubber.cap_mode"))
             {
                 parameter_store->add("scrubber.cap_mode", 0);
@@ -665,28 +897,22 @@ class GUI
             // Current Index (for EVENT type)
             if (parameter_store->get<Scrubber::ScrubberType>("scrubber.type") == Scrubber::ScrubberType::EVENT)
             {
-                size_t current_index_size_t = parameter_store->get<std::size_t>("scrubber.current_index");
+                // Indices are 64 bit so billion event recordings can be scrubbed to the exact event
+                ImU64 current_index = parameter_store->get<std::size_t>("scrubber.current_index");
 
                 // Get min/max values from scrubber if available
-                size_t min_index_size_t = 0;
-                size_t max_index_size_t = 0;
+                ImU64 min_index = 0;
+                ImU64 max_index = 0;
                 if (scrubber)
                 {
-                    min_index_size_t = parameter_store->get<std::size_t>("scrubber.min_index");
-                    max_index_size_t = parameter_store->get<std::size_t>("scrubber.max_index");
+                    min_index = parameter_store->get<std::size_t>("scrubber.min_index");
+                    max_index = parameter_store->get<std::size_t>("scrubber.max_index");
                 }
 
-                float current_index_float{static_cast<float>(current_index_size_t)};
-                float min_index_float{static_cast<float>(min_index_size_t)};
-                float max_index_float{static_cast<float>(max_index_size_t)};
-
-                if (ImGui::SliderFloat("Current Index", &current_index_float, min_index_float, max_index_float))
+                if (ImGui::SliderScalar("Current Index", ImGuiDataType_U64, &current_index, &min_index, &max_index))
                 {
-                    if (current_index_float < min_index_float)
-                        current_index_float = min_index_float;
-                    if (current_index_float > max_index_float)
-                        current_index_float = max_index_float;
-                    parameter_store->add("scrubber.current_index", static_cast<std::size_t>(current_index_float));
+                    current_index = std::clamp(current_index, min_index, std::max(min_index, max_index));
+                    parameter_store->add("scrubber.current_index", static_cast<std::size_t>(current_index));
                 }
 
                 // Index Window
@@ -694,28 +920,22 @@ class GUI
                 {
                     parameter_store->add("scrubber.index_window", static_cast<std::size_t>(50));
                 }
-                size_t index_window_size_t = parameter_store->get<std::size_t>("scrubber.index_window");
-
-                float index_window_float{static_cast<float>(index_window_size_t)};
+                ImU64 index_window = parameter_store->get<std::size_t>("scrubber.index_window");
 
                 // Calculate maximum window size (1/2 or 1/100 of data size, minimum 1)
-                size_t max_window_size = 1;
+                ImU64 min_window_size = 1;
+                ImU64 max_window_size = 1;
                 if (scrubber)
                 {
-                    size_t data_size = parameter_store->get<std::size_t>("scrubber.max_index") -
-                                       parameter_store->get<std::size_t>("scrubber.min_index") + 1;
-                    max_window_size = std::max(static_cast<size_t>(1), data_size / window_div_factor);
+                    ImU64 data_size = max_index - min_index + 1;
+                    max_window_size = std::max(static_cast<ImU64>(1), data_size / window_div_factor);
                 }
 
-                float max_window_size_float{static_cast<float>(max_window_size)};
-
-                if (ImGui::SliderFloat("Index Window", &index_window_float, 1.0f, max_window_size_float))
+                if (ImGui::SliderScalar("Index Window", ImGuiDataType_U64, &index_window, &min_window_size,
+                                        &max_window_size))
                 {
-                    if (index_window_float < 1.0f)
-                        index_window_float = 1.0f;
-                    if (index_window_float > max_window_size_float)
-                        index_window_float = max_window_size_float;
-                    parameter_store->add("scrubber.index_window", static_cast<std::size_t>(index_window_float));
+                    index_window = std::clamp(index_window, min_window_size, max_window_size);
+                    parameter_store->add("scrubber.index_window", static_cast<std::size_t>(index_window));
                 }
 
                 // Time Step
@@ -724,23 +944,18 @@ class GUI
                     size_t default_step{0};
                     parameter_store->add("scrubber.index_step", default_step);
                 }
-                size_t event_step = parameter_store->get<std::size_t>("scrubber.index_step");
+                ImU64 event_step = parameter_store->get<std::size_t>("scrubber.index_step");
 
                 // Calculate maximum step size (total time range)
-                size_t max_step_size_t = (max_index_size_t - min_index_size_t) / step_div_factor;
-                float max_step_float{static_cast<float>(max_step_size_t)};
+                ImU64 min_step = 0;
+                ImU64 max_step = (max_index - min_index) / step_div_factor;
 
-                float event_step_float = static_cast<float>(event_step);
                 std::string event_step_label{"Index Step"};
-                if (ImGui::SliderFloat(event_step_label.c_str(), &event_step_float, 0.0f, max_step_float))
+                if (ImGui::SliderScalar(event_step_label.c_str(), ImGuiDataType_U64, &event_step, &min_step,
+                                        &max_step))
                 {
-                    if (max_step_float >= 0.0f)
-                    {
-                        event_step_float = event_step_float;
-                        float lowest_step_float{0.0f};
-                        event_step_float = std::clamp(event_step_float, lowest_step_float, max_step_float);
-                        parameter_store->add("scrubber.index_step", static_cast<size_t>(event_step_float));
-                    }
+                    event_step = std::clamp(event_step, min_step, max_step);
+                    parameter_store->add("scrubber.index_step", static_cast<size_t>(event_step));
                 }
             }
             // Time-based controls (for TIME type)
@@ -765,44 +980,45 @@ class GUI
                     break;
                 }
 
-                // Current Time
-                if (!parameter_store->exists("scrubber.current_time"))
+                // Scrubber deals in whole microseconds stored as int64_t, sliders edit doubles in the selected unit
+                // (exact to the microsecond for any realistic recording length)
+                if (!parameter_store->exists("unit_time_conversion_factor"))
                 {
-                    parameter_store->add("scrubber.current_time", 0.0f);
+                    parameter_store->add("unit_time_conversion_factor", 1.0f); // Assume default unit of microseconds
                 }
-                float current_time = parameter_store->get<float>("scrubber.current_time");
+                double unit_time_conversion_factor{parameter_store->get<float>("unit_time_conversion_factor")};
 
-                if (!parameter_store->exists("unit_time_conversion_factor"))
+                // Current Time
+                if (!parameter_store->exists("scrubber.current_time"))
                 {
-                    parameter_store->add("unit_time_conversion_factor", 1.0f); // Assume default unit of microseconds
+                    parameter_store->add("scrubber.current_time", static_cast<int64_t>(0));
                 }
-                float unit_time_conversion_factor{parameter_store->get<float>("unit_time_conversion_factor")};
-                float current_time_unit_adjusted = current_time / unit_time_conversion_factor;
+                int64_t current_time = parameter_store->get<int64_t>("scrubber.current_time");
+                double current_time_unit_adjusted = static_cast<double>(current_time) / unit_time_conversion_factor;
 
                 // Get min/max time values from scrubber if available
-                float min_time = 0.0f;
-                float max_time = 0.0f;
+                int64_t min_time = 0;
+                int64_t max_time = 0;
                 if (scrubber)
                 {
-                    min_time = parameter_store->get<float>("scrubber.min_time");
-                    max_time = parameter_store->get<float>("scrubber.max_time");
+                    min_time = parameter_store->get<int64_t>("scrubber.min_time");
+                    max_time = parameter_store->get<int64_t>("scrubber.max_time");
                 }
 
-                float min_time_unit_adjusted = min_time / unit_time_conversion_factor;
-                float max_time_unit_adjusted = max_time / unit_time_conversion_factor;
+                double min_time_unit_adjusted = static_cast<double>(min_time) / unit_time_conversion_factor;
+                double max_time_unit_adjusted = static_cast<double>(max_time) / unit_time_conversion_factor;
 
                 std::string current_time_label = "Current Time " + time_unit_suffix;
-                if (ImGui::SliderFloat(current_time_label.c_str(), &current_time_unit_adjusted, min_time_unit_adjusted,
-                                       max_time_unit_adjusted, time_format_str.c_str()))
+                if (ImGui::SliderScalar(current_time_label.c_str(), ImGuiDataType_Double, &current_time_unit_adjusted,
+                                        &min_time_unit_adjusted, &max_time_unit_adjusted, time_format_str.c_str()))
                 {
                     // STOP CLAMP FROM CRASHING THE PROGRAM FOR THE NTH TIME
                     if (max_time_unit_adjusted > min_time_unit_adjusted)
                     {
                         current_time_unit_adjusted =
                             std::clamp(current_time_unit_adjusted, min_time_unit_adjusted, max_time_unit_adjusted);
-                        current_time = current_time_unit_adjusted *
-                                       unit_time_conversion_factor; // Revert conversion to store back into scrubber
-                        // Scrubber deals in us time unit
+                        // Revert conversion to store back into scrubber
+                        current_time = std::llround(current_time_unit_adjusted * unit_time_conversion_factor);
                         parameter_store->add("scrubber.current_time", current_time);
                     }
                 }
@@ -810,26 +1026,29 @@ class GUI
                 // Time Window
                 if (!parameter_store->exists("scrubber.time_window"))
                 {
-                    parameter_store->add("scrubber.time_window", 1.0f);
+                    parameter_store->add("scrubber.time_window", static_cast<int64_t>(1));
                 }
-                float time_window = parameter_store->get<float>("scrubber.time_window");
-                float time_window_unit_adjusted = time_window / unit_time_conversion_factor;
+                int64_t time_window = parameter_store->get<int64_t>("scrubber.time_window");
+                double time_window_unit_adjusted = static_cast<double>(time_window) / unit_time_conversion_factor;
 
-                // Calculate maximum window size (1/2 or 1/100 of total time range, minimum 0.001)
-                float max_window_time = std::max(0.00001f, (max_time - min_time) / window_div_factor);
-                float max_window_time_unit_adjusted = max_window_time / unit_time_conversion_factor;
+                // Calculate maximum window size (1/2 or 1/100 of total time range, minimum 1 microsecond)
+                double min_window_time_unit_adjusted = 1.0 / unit_time_conversion_factor;
+                double max_window_time_unit_adjusted =
+                    static_cast<double>(std::max(static_cast<int64_t>(1), (max_time - min_time) / window_div_factor)) /
+                    unit_time_conversion_factor;
 
                 std::string time_window_label = "Time Window " + time_unit_suffix;
-                if (ImGui::SliderFloat(time_window_label.c_str(), &time_window_unit_adjusted, 0.00001f,
-                                       max_window_time_unit_adjusted, time_format_str.c_str()))
+                if (ImGui::SliderScalar(time_window_label.c_str(), ImGuiDataType_Double, &time_window_unit_adjusted,
+                                        &min_window_time_unit_adjusted, &max_window_time_unit_adjusted,
+                                        time_format_str.c_str()))
                 {
                     // STOP CLAMP FROM CRASHING THE PROGRAM FOR THE NTH TIME
-                    if (max_window_time_unit_adjusted > 0.00001f)
+                    if (max_window_time_unit_adjusted >= min_window_time_unit_adjusted)
                     {
-                        time_window_unit_adjusted =
-                            std::clamp(time_window_unit_adjusted, 0.00001f, max_window_time_unit_adjusted);
+                        time_window_unit_adjusted = std::clamp(time_window_unit_adjusted, min_window_time_unit_adjusted,
+                                                               max_window_time_unit_adjusted);
                         // Adjust back to us to store into scrubber
-                        time_window = time_window_unit_adjusted * unit_time_conversion_factor;
+                        time_window = std::llround(time_window_unit_adjusted * unit_time_conversion_factor);
                         parameter_store->add("scrubber.time_window", time_window);
                     }
                 }
@@ -837,31 +1056,75 @@ class GUI
                 // Time Step
                 if (!parameter_store->exists("scrubber.time_step"))
                 {
-                    parameter_store->add("scrubber.time_step", 0.1f);
+                    parameter_store->add("scrubber.time_step", static_cast<int64_t>(0));
                 }
-                float time_step = parameter_store->get<float>("scrubber.time_step");
-                float time_step_unit_adjusted = time_step / unit_time_conversion_factor;
+                int64_t time_step = parameter_store->get<int64_t>("scrubber.time_step");
+                double time_step_unit_adjusted = static_cast<double>(time_step) / unit_time_conversion_factor;
 
                 // Calculate maximum step size (total time range)
-                float max_step_time = (max_time - min_time) / step_div_factor;
-                float max_step_time_unit_adjusted = max_step_time / unit_time_conversion_factor;
+                double min_step_time_unit_adjusted = 0.0;
+                double max_step_time_unit_adjusted =
+                    static_cast<double>((max_time - min_time) / step_div_factor) / unit_time_conversion_factor;
 
                 std::string time_step_label = "Time Step " + time_unit_suffix;
-                if (ImGui::SliderFloat(time_step_label.c_str(), &time_step_unit_adjusted, 0.00001f,
-                                       max_step_time_unit_adjusted, time_format_str.c_str()))
+                if (ImGui::SliderScalar(time_step_label.c_str(), ImGuiDataType_Double, &time_step_unit_adjusted,
+                                        &min_step_time_unit_adjusted, &max_step_time_unit_adjusted,
+                                        time_format_str.c_str()))
                 {
                     // STOP CLAMP FROM CRASHING THE PROGRAM FOR THE NTH TIME
-                    if (max_step_time_unit_adjusted > 0.00001f)
+                    if (max_step_time_unit_adjusted > min_step_time_unit_adjusted)
                     {
-                        time_step_unit_adjusted =
-                            std::clamp(time_step_unit_adjusted, 0.00001f, max_step_time_unit_adjusted);
+                        time_step_unit_adjusted = std::clamp(time_step_unit_adjusted, min_step_time_unit_adjusted,
+                                                             max_step_time_unit_adjusted);
                         // Adjust back to us to store into data scrubber
-                        time_step = time_step_unit_adjusted * unit_time_conversion_factor;
+                        time_step = std::llround(time_step_unit_adjusted * unit_time_conversion_factor);
                         parameter_store->add("scrubber.time_step", time_step);
                     }
                 }
             }
 
+            // Event rate over the whole retained recording, from the polarity count index so it stays cheap to draw
+            if (scrubber)
+            {
+                constexpr std::size_t EVT_RATE_TIMELINE_BUCKETS{256};
+                std::vector<float> evt_rate_timeline{scrubber->get_evt_rate_timeline(EVT_RATE_TIMELINE_BUCKETS)};
+                if (!evt_rate_timeline.empty())
+                {
+                    float max_rate = *std::max_element(evt_rate_timeline.begin(), evt_rate_timeline.end());
+                    ImGui::PlotHistogram("Event Rate (ev/s)", evt_rate_timeline.data(),
+                                         static_cast<int>(evt_rate_timeline.size()), 0, nullptr, 0.0f, max_rate,
+                                         ImVec2(0, 60));
+                }
+            }
+
+            // Region of interest, only events inside it are drawn and used for DCE
+            bool roi_enabled{parameter_store->get<bool>("scrubber.roi_enabled")};
+            if (ImGui::Checkbox("Region of Interest", &roi_enabled))
+            {
+                parameter_store->add("scrubber.roi_enabled", roi_enabled);
+            }
+            if (roi_enabled)
+            {
+                int roi[4] = {parameter_store->get<int32_t>("scrubber.roi_x"),
+                              parameter_store->get<int32_t>("scrubber.roi_y"),
+                              parameter_store->get<int32_t>("scrubber.roi_width"),
+                              parameter_store->get<int32_t>("scrubber.roi_height")};
+                if (ImGui::InputInt4("ROI x, y, width, height (px)", roi))
+                {
+                    parameter_store->add("scrubber.roi_x", static_cast<int32_t>(std::max(roi[0], 0)));
+                    parameter_store->add("scrubber.roi_y", static_cast<int32_t>(std::max(roi[1], 0)));
+                    parameter_store->add("scrubber.roi_width", static_cast<int32_t>(std::max(roi[2], 0)));
+                    parameter_store->add("scrubber.roi_height", static_cast<int32_t>(std::max(roi[3], 0)));
+                }
+            }
+
+            // Polarity filter, only events of the selected polarity are uploaded, drawn and used for DCE
+            int32_t polarity_choice{parameter_store->get<int32_t>("scrubber.polarity") + 1};
+            if (ImGui::Combo("Polarity", &polarity_choice, "Both\0Negative Only\0Positive Only\0"))
+            {
+                parameter_store->add("scrubber.polarity", static_cast<int32_t>(polarity_choice - 1));
+            }
+
             // Control if frame data shows up with event data
             if (!parameter_store->exists("scrubber.show_frame_data"))
             {
@@ -1149,7 +1412,8 @@ class GUI
         GUI(std::unordered_map<std::string, RenderTarget> &render_targets, ParameterStore *parameter_store,
             SDL_Window *window, SDL_GPUDevice *gpu_device, Scrubber *scrubber)
             : render_targets(render_targets), parameter_store(parameter_store), window(window), gpu_device(gpu_device),
-              scrubber(scrubber), fps_history_buf(100, 0.0f), fps_buf_index(0)
+              scrubber(scrubber), fps_history_buf(100, 0.0f), fps_buf_index(0), page_fault_history_buf(100, 0.0f),
+              page_fault_buf_index(0), last_page_fault_count(EventPrefetcher::get_page_fault_count())
         {
             // Setup Dear ImGui context
             IMGUI_CHECKVERSION();
@@ -1334,6 +1598,16 @@ inline void SDLCALL stream_file_handle_callback(void *param_store, const char *c
         if (*data_file_list)
         {
             std::string file_name{*data_file_list};
+            std::vector<std::string> session_paths{};
+            for (const char *const *file{data_file_list}; *file; ++file)
+            {
+                session_paths.emplace_back(*file);
+            }
+            if (session_paths.size() == 1)
+            {
+                session_paths.clear(); // A single file is streamed, not read as a session
+            }
+            param_store_ptr->add("stream_session_paths", session_paths);
             param_store_ptr->add("stream_file_name", file_name);
             param_store_ptr->add("stream_file_changed", true);
             param_store_ptr->add("program_state",
@@ -1348,6 +1622,33 @@ inline void SDLCALL stream_file_handle_callback(void *param_store, const char *c
     }
 }
 
+// Callback used with SDL_ShowOpenFolderDialog in draw_stream_window
+/**
+ * @brief Callback function to open folder dialog for reading the segment files in a folder as one session.
+ * @param param_store ParameterStore object containing data from GUI.
+ * @param folder_list Chosen folder by user.
+ * @param filter_unused unused filter.
+ */
+inline void SDLCALL stream_session_folder_callback(void *param_store, const char *const *folder_list,
+                                                   int filter_unused)
+{
+    ParameterStore *param_store_ptr{static_cast<ParameterStore *>(param_store)};
+    if (folder_list && *folder_list)
+    {
+        std::string folder_name{*folder_list};
+        param_store_ptr->add("stream_session_paths", std::vector<std::string>{folder_name});
+        param_store_ptr->add("stream_file_name", folder_name);
+        param_store_ptr->add("stream_file_changed", true);
+        param_store_ptr->add("program_state", GUI::PROGRAM_STATE::FILE_STREAM);
+
+        param_store_ptr->add("camera_changed", true);
+    }
+    else
+    {
+        std::cerr << "Error happened when selecting folder or no folder was chosen" << std::endl;
+    }
+}
+
 // Callback used with SDL_ShowSaveFileDialog in draw_stream_window
 /**
  * @brief Callback function to open file dialog for selecting file to save data into.
@@ -0,0 +1,311 @@
+#pragma once
+#ifndef MULTI_SOURCE_EVENT_DATA_HH
+#define MULTI_SOURCE_EVENT_DATA_HH
+
+#include "EventData.hh"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <span>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Holds the events of several cameras, e.g. a stereo rig, on a common clock. Every source is an EventData
+ *        object of its own with its own storage, resolution, indices and lock, so the sources are written from
+ *        separate threads without contending and a timestamp reset of one camera only clears that camera. A source's
+ *        events are placed on the common clock by adding its clock offset to their timestamps. Events of all sources
+ *        are read in time order through a k-way merge, or per source through windows of common clock time.
+ *        Sources are added before streaming starts, adding a source is not thread safe.
+ */
+class MultiSourceEventData
+{
+    private:
+        // Events of one camera and where they sit on the common clock
+        struct Source
+        {
+                EventData evt_data;
+                std::atomic<int64_t> clock_offset{0}; // Microseconds added to the camera's timestamps
+        };
+
+        std::vector<std::unique_ptr<Source>> sources;
+
+        /**
+         * @brief Gets the common clock time relative timestamps of a source are offsets from.
+         * @param source source to get time base of.
+         * @return common clock time of relative timestamp 0 of the source.
+         */
+        int64_t source_time_base(const Source &source) const
+        {
+            return source.evt_data.get_earliest_evt_timestamp() + source.clock_offset.load(std::memory_order_relaxed);
+        }
+
+    public:
+        /**
+         * @brief Event of the merged view, where it is stored and when it happened on the common clock.
+         */
+        struct SourceEvent
+        {
+                std::size_t source;
+                std::size_t index;
+                int64_t timestamp;
+        };
+
+        /**
+         * @brief Default constructor, holds no sources.
+         */
+        MultiSourceEventData() = default;
+
+        /**
+         * @brief Adds a source.
+         * @param width event resolution width of the camera.
+         * @param height event resolution height of the camera.
+         * @param clock_offset microseconds added to the camera's timestamps to place them on the common clock.
+         * @return id of the new source, ids count up from 0.
+         */
+        std::size_t add_source(int32_t width, int32_t height, int64_t clock_offset = 0)
+        {
+            sources.push_back(std::make_unique<Source>());
+            sources.back()->evt_data.set_camera_event_resolution(width, height);
+            sources.back()->clock_offset.store(clock_offset, std::memory_order_relaxed);
+            return sources.size() - 1;
+        }
+
+        /**
+         * @brief Gets the number of sources.
+         * @return number of sources.
+         */
+        std::size_t get_source_count() const
+        {
+            return sources.size();
+        }
+
+        /**
+         * @brief Gets the events of a source, e.g. to set its storage format or retention, or to scrub it alone.
+         *        Times of its events are relative to its own earliest event.
+         * @param source id of source.
+         * @return EventData object of the source.
+         */
+        EventData &get_source(std::size_t source)
+        {
+            return sources[source]->evt_data;
+        }
+
+        /**
+         * @brief Sets the clock offset of a source, e.g. after the cameras were synchronized.
+         * @param source id of source.
+         * @param clock_offset microseconds added to the camera's timestamps to place them on the common clock.
+         */
+        void set_clock_offset(std::size_t source, int64_t clock_offset)
+        {
+            sources[source]->clock_offset.store(clock_offset, std::memory_order_relaxed);
+        }
+
+        /**
+         * @brief Gets the clock offset of a source.
+         * @param source id of source.
+         * @return microseconds added to the camera's timestamps to place them on the common clock.
+         */
+        int64_t get_clock_offset(std::size_t source) const
+        {
+            return sources[source]->clock_offset.load(std::memory_order_relaxed);
+        }
+
+        /**
+         * @brief Inserts a batch of events of one source, see EventData::write_evt_data_batch. Only locks the
+         *        source written to.
+         * @param source id of source.
+         * @param raw_evt_data Raw event data to add, in order of arrival.
+         */
+        void write_evt_data_batch(std::size_t source, std::span<const EventData::EventDatum> raw_evt_data)
+        {
+            sources[source]->evt_data.write_evt_data_batch(raw_evt_data);
+        }
+
+        /**
+         * @brief Gets the common clock time of an event. Does not lock, see EventData::get_evt_view.
+         * @param source id of source.
+         * @param index index of event in the source.
+         * @return time of event on the common clock in microseconds.
+         */
+        int64_t get_evt_time(std::size_t source, std::size_t index) const
+        {
+            const Source &src{*sources[source]};
+            return source_time_base(src) + src.evt_data.get_evt_relative_time(index);
+        }
+
+        /**
+         * @brief Gets the common clock times of the first and last events of all sources. Does not lock.
+         * @return pair of earliest and latest event time, {0, -1} if there are no events.
+         */
+        std::pair<int64_t, int64_t> get_time_range() const
+        {
+            int64_t first_time{std::numeric_limits<int64_t>::max()};
+            int64_t last_time{std::numeric_limits<int64_t>::min()};
+            for (const std::unique_ptr<Source> &source : sources)
+            {
+                EventData::EventView view{source->evt_data.get_evt_view()};
+                if (view.begin_index == view.end_index)
+                {
+                    continue;
+                }
+                int64_t base{source_time_base(*source)};
+                first_time = std::min(first_time, base + source->evt_data.get_evt_relative_time(view.begin_index));
+                last_time = std::max(last_time, base + source->evt_data.get_evt_relative_time(view.end_index - 1));
+            }
+            return first_time <= last_time ? std::pair<int64_t, int64_t>{first_time, last_time}
+                                           : std::pair<int64_t, int64_t>{0, -1};
+        }
+
+        /**
+         * @brief Gets the window of each source's events with common clock times in [start_time, end_time), e.g.
+         *        for scrubbing all sources to the same moment. Does not lock, see EventData::get_evt_view.
+         * @param start_time start of time range on the common clock in microseconds (inclusive).
+         * @param end_time end of time range on the common clock in microseconds (exclusive).
+         * @return [first, last) event indices for every source, by source id.
+         */
+        std::vector<std::pair<std::size_t, std::size_t>> get_source_windows(int64_t start_time, int64_t end_time) const
+        {
+            std::vector<std::pair<std::size_t, std::size_t>> windows{};
+            windows.reserve(sources.size());
+            for (const std::unique_ptr<Source> &source : sources)
+            {
+                const int64_t base{source_time_base(*source)};
+                const EventData &evt_data{source->evt_data};
+                windows.push_back(evt_data.get_event_index_range_from_relative_timestamps(start_time - base,
+                                                                                          end_time - base));
+            }
+            return windows;
+        }
+
+        /**
+         * @brief Gets the window of each source's events that happened during a window of one source, e.g. the
+         *        window a Scrubber shows of that source, so every source is shown at the same moment. The source's
+         *        own window is returned as is, the others cover the common clock times from its first to its last
+         *        event. Does not lock, see EventData::get_evt_view.
+         * @param source id of source the window is of.
+         * @param first index of the first event of the window in the source.
+         * @param last index of the last event of the window in the source (inclusive).
+         * @return [first, last) event indices for every source, by source id, all empty if the window is not
+         *         retained.
+         */
+        std::vector<std::pair<std::size_t, std::size_t>> get_source_windows_at(std::size_t source, std::size_t first,
+                                                                               std::size_t last) const
+        {
+            const Source &src{*sources[source]};
+            const EventData::EventView view{src.evt_data.get_evt_view()};
+            if (first > last || first < view.begin_index || last >= view.end_index)
+            {
+                return std::vector<std::pair<std::size_t, std::size_t>>(sources.size(), {0, 0});
+            }
+
+            const int64_t base{source_time_base(src)};
+            std::vector<std::pair<std::size_t, std::size_t>> windows{
+                get_source_windows(base + src.evt_data.get_evt_relative_time(first),
+                                   base + src.evt_data.get_evt_relative_time(last) + 1)};
+            windows[source] = {first, last + 1};
+            return windows;
+        }
+
+        /**
+         * @brief Visits the events of all sources with common clock times in [start_time, end_time) in time order,
+         *        events at the same time in order of source id. Sources are merged through a heap of their next
+         *        events, and a run of events of one source before the next event of any other source is visited
+         *        without touching the heap, so interleaving costs O(log sources) per switch between sources and
+         *        long runs cost nothing extra. Does not lock, see EventData::get_evt_view.
+         * @param start_time start of time range on the common clock in microseconds (inclusive).
+         * @param end_time end of time range on the common clock in microseconds (exclusive).
+         * @param fn callable taking a SourceEvent.
+         * @return true if no visited event was cleared or evicted while being read, false otherwise.
+         */
+        template <typename Fn> bool for_each_merged_evt(int64_t start_time, int64_t end_time, Fn &&fn) const
+        {
+            // Next event of a source still to visit
+            struct Cursor
+            {
+                    SourceEvent next;
+                    std::size_t last;
+                    int64_t base;
+            };
+            auto later = [](const Cursor &a, const Cursor &b) {
+                return a.next.timestamp > b.next.timestamp ||
+                       (a.next.timestamp == b.next.timestamp && a.next.source > b.next.source);
+            };
+
+            std::vector<EventData::EventView> views{};
+            std::vector<Cursor> heap{};
+            views.reserve(sources.size());
+            heap.reserve(sources.size());
+            for (std::size_t source{0}; source < sources.size(); ++source)
+            {
+                const EventData &evt_data{sources[source]->evt_data};
+                views.push_back(evt_data.get_evt_view());
+                int64_t base{source_time_base(*sources[source])};
+                auto [first, last] =
+                    evt_data.get_event_index_range_from_relative_timestamps(start_time - base, end_time - base);
+                first = std::max(first, views.back().begin_index);
+                last = std::min(last, views.back().end_index);
+                if (first < last)
+                {
+                    heap.push_back(Cursor{{source, first, base + evt_data.get_evt_relative_time(first)}, last, base});
+                }
+            }
+            std::make_heap(heap.begin(), heap.end(), later);
+
+            while (!heap.empty())
+            {
+                std::pop_heap(heap.begin(), heap.end(), later);
+                Cursor &cursor{heap.back()};
+                const EventData &evt_data{sources[cursor.next.source]->evt_data};
+                const Cursor *other{heap.size() > 1 ? &heap.front() : nullptr};
+                do
+                {
+                    fn(cursor.next);
+                    if (++cursor.next.index == cursor.last)
+                    {
+                        break;
+                    }
+                    cursor.next.timestamp = cursor.base + evt_data.get_evt_relative_time(cursor.next.index);
+                } while (!other || later(*other, cursor));
+
+                if (cursor.next.index == cursor.last)
+                {
+                    heap.pop_back();
+                }
+                else
+                {
+                    std::push_heap(heap.begin(), heap.end(), later);
+                }
+            }
+
+            bool current{true};
+            for (std::size_t source{0}; source < sources.size(); ++source)
+            {
+                current = sources[source]->evt_data.is_evt_view_current(views[source]) && current;
+            }
+            return current;
+        }
+
+        /**
+         * @brief Clears event and frame data of every source, sources and their settings are kept.
+         */
+        void clear()
+        {
+            for (std::unique_ptr<Source> &source : sources)
+            {
+                // EventData::clear forgets the resolutions as well
+                glm::vec2 evt_resolution{source->evt_data.get_camera_event_resolution()};
+                glm::vec2 frame_resolution{source->evt_data.get_camera_frame_resolution()};
+                source->evt_data.clear();
+                source->evt_data.set_camera_event_resolution(static_cast<int32_t>(evt_resolution.x),
+                                                             static_cast<int32_t>(evt_resolution.y));
+                source->evt_data.set_camera_frame_resolution(static_cast<int32_t>(frame_resolution.x),
+                                                             static_cast<int32_t>(frame_resolution.y));
+            }
+        }
+};
+
+#endif // MULTI_SOURCE_EVENT_DATA_HH
@@ -0,0 +1,434 @@
+#pragma once
+#ifndef RECORDING_SESSION_HH
+#define RECORDING_SESSION_HH
+
+#include "EventData.hh"
+
+#include <dv-processing/io/mono_camera_recording.hpp>
+#include <dv-processing/io/read_only_file.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <filesystem>
+#include <limits>
+#include <memory>
+#include <string>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief One or more aedat4 files, e.g. the segments of a long recording, presented as one continuous timeline that
+ *        is decoded on demand. Opening a session only reads the packet table every aedat4 file ends with, which
+ *        holds the time range and byte offset of each packet, and groups the event packets into chunks of about
+ *        kChunkEvents events. The chunks overlapping the window being looked at are decoded into EventData by
+ *        seeking to their packets, and the oldest decoded chunks are evicted once more than kMaxResidentEvents
+ *        events are held, so opening time and memory use do not depend on the size of the recording. Relative
+ *        timestamps in EventData always count from the start of the session, see EventData::set_evt_time_origin,
+ *        so a chunk decoded again after a seek lands where it was before. Files must not overlap in time.
+ */
+class RecordingSession
+{
+    public:
+        // Default events grouped into one chunk, chunks hold whole packets so most hold a few more
+        static constexpr int64_t kChunkEvents{static_cast<int64_t>(1) << 20};
+        // Default most events kept decoded, the oldest chunks are evicted as the window moves on
+        static constexpr int64_t kMaxResidentEvents{static_cast<int64_t>(1) << 25};
+        // Chunk length for files without a packet table, in microseconds
+        static constexpr int64_t kFallbackChunkDuration{1000000};
+        // Returned when no chunk needs to be decoded
+        static constexpr std::size_t NO_CHUNK{std::numeric_limits<std::size_t>::max()};
+
+        /**
+         * @brief Packets of a file covering a time range, decoded as one piece.
+         */
+        struct Chunk
+        {
+                std::size_t file;    // Index into get_file_names
+                int64_t start_time;  // Camera time range [start_time, end_time) in microseconds
+                int64_t end_time;
+                int64_t evt_count; // Events of the chunk, estimated for files without a packet table
+        };
+
+        /**
+         * @brief Default constructor, no session is open.
+         */
+        RecordingSession() = default;
+
+        /**
+         * @brief Constructor with chunk sizes other than the defaults, e.g. to cut a short file into many chunks.
+         * @param chunk_evts events grouped into one chunk.
+         * @param max_resident_evts most events kept decoded.
+         */
+        RecordingSession(int64_t chunk_evts, int64_t max_resident_evts)
+            : chunk_evts{chunk_evts}, max_resident_evts{max_resident_evts}
+        {
+        }
+
+        /**
+         * @brief Opens a session. Directories are expanded to the .aedat4 files they directly contain. Every file
+         *        is indexed by its packet table, files that cannot be read are left out.
+         * @param paths files and directories holding files.
+         * @return true if at least one file could be indexed, false otherwise.
+         */
+        bool open(const std::vector<std::string> &paths)
+        {
+            close();
+            for (const std::string &file_name : expand_paths(paths))
+            {
+                try
+                {
+                    index_file(file_name);
+                }
+                catch (...)
+                {
+                    continue;
+                }
+            }
+
+            // File names need not sort in time order
+            std::sort(chunks.begin(), chunks.end(),
+                      [](const Chunk &a, const Chunk &b) { return a.start_time < b.start_time; });
+            return !chunks.empty();
+        }
+
+        /**
+         * @brief Closes the session, forgets its files and chunks.
+         */
+        void close()
+        {
+            file_names.clear();
+            chunks.clear();
+            recording.reset();
+            recording_file = NO_CHUNK;
+            event_width = 0;
+            event_height = 0;
+            frame_width = 0;
+            frame_height = 0;
+            forget_resident();
+        }
+
+        /**
+         * @brief Checks if a session is open.
+         * @return true if a session with at least one chunk is open, false otherwise.
+         */
+        bool is_open() const
+        {
+            return !chunks.empty();
+        }
+
+        /**
+         * @brief Gets the files of the session, in the order they were indexed.
+         * @return names of the files.
+         */
+        const std::vector<std::string> &get_file_names() const
+        {
+            return file_names;
+        }
+
+        /**
+         * @brief Gets the chunks of the session, in time order.
+         * @return chunks of the session.
+         */
+        const std::vector<Chunk> &get_chunks() const
+        {
+            return chunks;
+        }
+
+        /**
+         * @brief Gets the camera timestamp the session starts at, relative timestamps count from it.
+         * @return camera timestamp of the start of the first chunk in microseconds, 0 if no session is open.
+         */
+        int64_t get_start_time() const
+        {
+            return chunks.empty() ? 0 : chunks.front().start_time;
+        }
+
+        /**
+         * @brief Gets the length of the session, gaps between files included.
+         * @return relative timestamp of the end of the last chunk in microseconds, 0 if no session is open.
+         */
+        int64_t get_duration() const
+        {
+            return chunks.empty() ? 0 : chunks.back().end_time - chunks.front().start_time;
+        }
+
+        /**
+         * @brief Gets the event resolution of the session, read from its first file.
+         * @return pair of width and height, 0 if the files have no events.
+         */
+        std::pair<int32_t, int32_t> get_event_resolution() const
+        {
+            return {event_width, event_height};
+        }
+
+        /**
+         * @brief Gets the frame resolution of the session, read from its first file.
+         * @return pair of width and height, 0 if the files have no frames.
+         */
+        std::pair<int32_t, int32_t> get_frame_resolution() const
+        {
+            return {frame_width, frame_height};
+        }
+
+        /**
+         * @brief Gets the chunks overlapping a time range of the session.
+         * @param start_time start of time range relative to the session start in microseconds (inclusive).
+         * @param end_time end of time range relative to the session start in microseconds (inclusive).
+         * @return [first, last) indices of the overlapping chunks, first == last if the range falls in a gap.
+         */
+        std::pair<std::size_t, std::size_t> get_chunk_range(int64_t start_time, int64_t end_time) const
+        {
+            const int64_t base{get_start_time()};
+            auto first = std::partition_point(chunks.begin(), chunks.end(),
+                                              [&](const Chunk &chunk) { return chunk.end_time - base <= start_time; });
+            auto last = std::partition_point(first, chunks.end(),
+                                             [&](const Chunk &chunk) { return chunk.start_time - base <= end_time; });
+            return {static_cast<std::size_t>(first - chunks.begin()), static_cast<std::size_t>(last - chunks.begin())};
+        }
+
+        /**
+         * @brief Gets the chunks decoded into EventData.
+         * @return [first, last) indices of the decoded chunks.
+         */
+        std::pair<std::size_t, std::size_t> get_resident_chunks() const
+        {
+            return {resident_first, resident_last};
+        }
+
+        /**
+         * @brief Picks the chunk to decode next for a window of the session to be shown. A window past the decoded
+         *        chunks continues after them, evicting the oldest chunks outside the window while more than
+         *        max_resident_evts events would be held. Any other window not yet decoded clears the event data,
+         *        which then starts over at the window. Decode the returned chunk, then call finish_chunk.
+         * @param evt_data EventData object the session is decoded into.
+         * @param start_time start of window relative to the session start in microseconds (inclusive).
+         * @param end_time end of window relative to the session start in microseconds (inclusive).
+         * @return index of the chunk to decode, NO_CHUNK if the window is decoded or falls in a gap.
+         */
+        std::size_t next_chunk(EventData &evt_data, int64_t start_time, int64_t end_time)
+        {
+            // Cleared from elsewhere, e.g. by a camera reset, nothing decoded is left
+            if (resident_last > resident_first && evt_data.get_evt_view().generation != resident_generation)
+            {
+                forget_resident();
+            }
+
+            auto [first, last] = get_chunk_range(start_time, end_time);
+            if (first == last || (resident_first <= first && last <= resident_last))
+            {
+                return NO_CHUNK;
+            }
+
+            if (resident_first == resident_last || first < resident_first || first > resident_last)
+            {
+                // Keeps format and storage settings, but resolutions and the time origin are set again
+                evt_data.clear();
+                evt_data.set_camera_event_resolution(event_width, event_height);
+                evt_data.set_camera_frame_resolution(frame_width, frame_height);
+                evt_data.set_evt_time_origin(get_start_time());
+                resident_first = first;
+                resident_last = first;
+                resident_evts = 0;
+                resident_generation = evt_data.get_evt_view().generation;
+                return resident_last;
+            }
+
+            const std::size_t evicted_first{resident_first};
+            while (resident_first < first && resident_evts + chunks[resident_last].evt_count > max_resident_evts)
+            {
+                resident_evts -= chunks[resident_first].evt_count;
+                ++resident_first;
+            }
+            if (resident_first != evicted_first)
+            {
+                evt_data.evict_evts_before(chunks[resident_first].start_time - get_start_time());
+            }
+            return resident_last;
+        }
+
+        /**
+         * @brief Marks the chunk returned by next_chunk as decoded.
+         * @param evt_data EventData object the session is decoded into.
+         * @param chunk index of the decoded chunk.
+         */
+        void finish_chunk(EventData &evt_data, std::size_t chunk)
+        {
+            if (chunk != resident_last)
+            {
+                return;
+            }
+            evt_data.flush_evt_data(); // The next chunk may start after a gap
+            resident_evts += chunks[chunk].evt_count;
+            resident_last = chunk + 1;
+            resident_generation = evt_data.get_evt_view().generation;
+        }
+
+        /**
+         * @brief Gets the recording of the file a chunk is in to decode the chunk from. The recording is kept open
+         *        until a chunk of another file is decoded.
+         * @param chunk index of the chunk.
+         * @return recording holding the chunk.
+         */
+        dv::io::MonoCameraRecording &get_recording(std::size_t chunk)
+        {
+            if (!recording || recording_file != chunks[chunk].file)
+            {
+                recording.reset(); // Only one file is open at a time
+                recording = std::make_unique<dv::io::MonoCameraRecording>(file_names[chunks[chunk].file]);
+                recording_file = chunks[chunk].file;
+            }
+            return *recording;
+        }
+
+    private:
+        int64_t chunk_evts{kChunkEvents};
+        int64_t max_resident_evts{kMaxResidentEvents};
+
+        std::vector<std::string> file_names{};
+        std::vector<Chunk> chunks{};
+
+        // Recording of the file last decoded from
+        std::unique_ptr<dv::io::MonoCameraRecording> recording{};
+        std::size_t recording_file{NO_CHUNK};
+
+        int32_t event_width{0};
+        int32_t event_height{0};
+        int32_t frame_width{0};
+        int32_t frame_height{0};
+
+        // Chunks [resident_first, resident_last) are decoded, as of generation resident_generation of EventData
+        std::size_t resident_first{0};
+        std::size_t resident_last{0};
+        int64_t resident_evts{0};
+        uint64_t resident_generation{0};
+
+        /**
+         * @brief Forgets which chunks are decoded.
+         */
+        void forget_resident()
+        {
+            resident_first = 0;
+            resident_last = 0;
+            resident_evts = 0;
+            resident_generation = 0;
+        }
+
+        /**
+         * @brief Adds the chunks of a file, grouping its event packets by the packet table. Files without a packet
+         *        table, or without events, are cut into chunks of kFallbackChunkDuration.
+         * @param file_name name of the file.
+         */
+        void index_file(const std::string &file_name)
+        {
+            dv::io::MonoCameraRecording file_recording{file_name};
+            auto [first_time, last_time] = file_recording.getTimeRange();
+            if (last_time < first_time)
+            {
+                return; // Holds no data
+            }
+            if (file_names.empty())
+            {
+                read_resolutions(file_recording);
+            }
+            const std::size_t file{file_names.size()};
+            file_names.push_back(file_name);
+            const std::size_t file_first_chunk{chunks.size()};
+
+            // https://docs.inivation.com/software/software-advanced-usage/file-formats/aedat-4.0.html
+            dv::io::ReadOnlyFile file_reader{file_name};
+            const auto &info{file_reader.getFileInfo()};
+            auto events_stream = std::find_if(info.mStreams.begin(), info.mStreams.end(),
+                                              [](const auto &stream) { return stream.mName == "events"; });
+            auto table = events_stream == info.mStreams.end() ? info.mPerStreamDataTables.end()
+                                                               : info.mPerStreamDataTables.find(events_stream->mId);
+            if (table != info.mPerStreamDataTables.end())
+            {
+                for (const auto &packet : table->second.Table)
+                {
+                    if (chunks.size() == file_first_chunk || chunks.back().evt_count >= chunk_evts)
+                    {
+                        chunks.push_back(Chunk{.file = file,
+                                               .start_time = std::max(packet.TimestampStart, first_time),
+                                               .end_time = last_time + 1,
+                                               .evt_count = 0});
+                        if (chunks.size() > file_first_chunk + 1)
+                        {
+                            chunks[chunks.size() - 2].end_time = chunks.back().start_time;
+                        }
+                    }
+                    chunks.back().evt_count += packet.NumElements;
+                }
+            }
+
+            if (chunks.size() == file_first_chunk)
+            {
+                for (int64_t start_time{first_time}; start_time <= last_time; start_time += kFallbackChunkDuration)
+                {
+                    chunks.push_back(Chunk{.file = file,
+                                           .start_time = start_time,
+                                           .end_time = std::min(start_time + kFallbackChunkDuration, last_time + 1),
+                                           .evt_count = chunk_evts});
+                }
+            }
+            chunks[file_first_chunk].start_time = first_time; // Frames and samples may come before the first event
+        }
+
+        /**
+         * @brief Reads the event and frame resolutions of a file.
+         * @param file_recording opened file.
+         */
+        void read_resolutions(dv::io::MonoCameraRecording &file_recording)
+        {
+            if (file_recording.isEventStreamAvailable())
+            {
+                auto evt_resolution = file_recording.getEventResolution();
+                if (evt_resolution.has_value())
+                {
+                    event_width = evt_resolution.value().width;
+                    event_height = evt_resolution.value().height;
+                }
+            }
+            if (file_recording.isFrameStreamAvailable())
+            {
+                auto frame_resolution = file_recording.getFrameResolution();
+                if (frame_resolution.has_value())
+                {
+                    frame_width = frame_resolution.value().width;
+                    frame_height = frame_resolution.value().height;
+                }
+            }
+        }
+
+        /**
+         * @brief Expands directories to the .aedat4 files they directly contain, in name order.
+         * @param paths files and directories.
+         * @return file names.
+         */
+        static std::vector<std::string> expand_paths(const std::vector<std::string> &paths)
+        {
+            std::vector<std::string> expanded{};
+            for (const std::string &path : paths)
+            {
+                std::error_code ec{};
+                if (!std::filesystem::is_directory(path, ec))
+                {
+                    expanded.push_back(path);
+                    continue;
+                }
+                std::vector<std::string> directory_files{};
+                for (const auto &entry : std::filesystem::directory_iterator{path, ec})
+                {
+                    if (entry.is_regular_file(ec) && entry.path().extension() == ".aedat4")
+                    {
+                        directory_files.push_back(entry.path().string());
+                    }
+                }
+                std::sort(directory_files.begin(), directory_files.end());
+                expanded.insert(expanded.end(), directory_files.begin(), directory_files.end());
+            }
+            return expanded;
+        }
+};
+
+#endif // RECORDING_SESSION_HH
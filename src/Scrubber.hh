@@ -7,11 +7,14 @@
 #include "pch.hh"
 
 #include "EventData.hh"
+#include "MultiSourceEventData.hh"
 #include "ParameterStore.hh"
 #include "UploadBuffer.hh"
 
 #include <algorithm>
 #include <array>
+#include <utility>
+#include <vector>
 
 /**
  * @brief Provides functionality for scrubbing through subsets of event data.
@@ -55,23 +58,37 @@ class Scrubber
         std::size_t index_step = 0;
         std::size_t index_window = 0;
 
-        float lower_time = 0.0f;
-        float current_time = 0.0f;
-        float time_step = 0.0f;
-        float time_window = 0.0f;
+        // Relative times in microseconds, kept in 64 bits so long recordings scrub exactly
+        int64_t lower_time = 0;
+        int64_t current_time = 0;
+        int64_t time_step = 0;
+        int64_t time_window = 0;
 
         ParameterStore &parameter_store;
         EventData *event_data = nullptr;
         SDL_GPUDevice *gpu_device = nullptr;
 
+        // Cameras scrubbed together, event_data is the source scrubbed_source of them, nullptr for a single camera
+        const MultiSourceEventData *multi_source = nullptr;
+        std::size_t scrubbed_source = 0;
+        // [first, last) indices of every source's events at the moment shown, by source id
+        std::vector<std::pair<std::size_t, std::size_t>> source_windows;
+
         SDL_GPUBuffer *points_buffer = nullptr;
         std::size_t points_buffer_size = 0;
+        std::size_t points_count = 0;
+        bool points_packed = false;
+        // Times of uploaded points are offsets from points_time_base, depths are relative to it as well
+        int64_t points_time_base = 0;
         float lower_depth = 0.0f;
         float upper_depth = 0.0f;
         glm::vec2 camera_resolution = glm::vec2(0.0f, 0.0f);
+        // Events inside the region of interest or of the selected polarity, gathered for upload when either is set
+        std::vector<std::byte> gathered_staging;
 
         SDL_GPUTexture *frames = nullptr;
         std::array<float, 2> frame_timestamps = {-1.0, -1.0};
+        float frames_current_time = 0.0f;
         std::size_t frame_width = 0, frame_height = 0;
 
     public:
@@ -96,9 +113,36 @@ class Scrubber
             parameter_store.add("scrubber.current_time", current_time);
             parameter_store.add("scrubber.time_window", time_window);
             parameter_store.add("scrubber.time_step", time_step);
-            parameter_store.add("scrubber.min_time", 0.0f);
-            parameter_store.add("scrubber.max_time", 0.0f);
+            parameter_store.add("scrubber.min_time", static_cast<int64_t>(0));
+            parameter_store.add("scrubber.max_time", static_cast<int64_t>(0));
             parameter_store.add("scrubber.show_frame_data", false);
+
+            parameter_store.add("scrubber.roi_enabled", false);
+            parameter_store.add("scrubber.roi_x", static_cast<int32_t>(0));
+            parameter_store.add("scrubber.roi_y", static_cast<int32_t>(0));
+            parameter_store.add("scrubber.roi_width", static_cast<int32_t>(0));
+            parameter_store.add("scrubber.roi_height", static_cast<int32_t>(0));
+            parameter_store.add("scrubber.polarity", static_cast<int32_t>(-1)); // Polarity drawn, -1 for both
+
+            parameter_store.add("scrubber.epoch", static_cast<int64_t>(-1)); // Id of the epoch scrubbed, -1 for all
+            parameter_store.add("scrubber.epochs", std::vector<EventData::EpochRange>{});
+        }
+
+        /**
+         * @brief Constructor for cameras scrubbed together. One source is scrubbed as a single camera is, and every
+         *        source gets the window of its events at the same moment on the common clock, see
+         *        get_source_windows.
+         * @param parameter_store ParameterStore object containing data from GUI
+         * @param multi_source MultiSourceEventData object containing the event data of every camera
+         * @param source id of the source scrubbed
+         * @param gpu_device SDL_GPUDevice to upload event data points to
+         */
+        Scrubber(ParameterStore &parameter_store, MultiSourceEventData *multi_source, std::size_t source,
+                 SDL_GPUDevice *gpu_device)
+            : Scrubber(parameter_store, &multi_source->get_source(source), gpu_device)
+        {
+            this->multi_source = multi_source;
+            scrubbed_source = source;
         }
 
         /**
@@ -125,56 +169,106 @@ class Scrubber
             index_window = parameter_store.get<std::size_t>("scrubber.index_window");
             index_step = parameter_store.get<std::size_t>("scrubber.index_step");
 
-            event_data->lock_data_vectors();
+            // Events are read without locking so rendering never waits on acquisition
+            const EventData::EventView view = event_data->get_evt_view();
+
+            // A session is decoded as the time window reaches its parts, its whole timeline is scrubbed by time
+            // even while none of it is decoded
+            const int64_t session_duration = parameter_store.exists("stream_session_duration")
+                                                 ? parameter_store.get<int64_t>("stream_session_duration")
+                                                 : -1;
+            const bool session_timeline = session_duration >= 0 &&
+                                          parameter_store.get<ScrubberType>("scrubber.type") == ScrubberType::TIME;
 
-            if (event_data->get_evt_vector_ref().empty())
+            if (view.begin_index == view.end_index && session_timeline)
             {
-                event_data->unlock_data_vectors();
+                current_time = std::clamp(parameter_store.get<int64_t>("scrubber.current_time"),
+                                          static_cast<int64_t>(0), session_duration);
+                time_window = std::clamp(parameter_store.get<int64_t>("scrubber.time_window"),
+                                         static_cast<int64_t>(0), session_duration);
+                lower_time = current_time - time_window;
+                parameter_store.add("scrubber.current_time", current_time);
+                parameter_store.add("scrubber.time_window", time_window);
+                parameter_store.add("scrubber.min_time", static_cast<int64_t>(0));
+                parameter_store.add("scrubber.max_time", session_duration);
+                parameter_store.add("scrubber.current_index", static_cast<std::size_t>(0));
+                parameter_store.add("scrubber.index_window", static_cast<std::size_t>(0));
 
+                lower_index = 0;
+                current_index = 0;
+                index_window = 0;
+                source_windows.clear();
+
+                return;
+            }
+
+            if (view.begin_index == view.end_index)
+            {
                 // No event data? Scrubber has nothing to scrub.
-                parameter_store.add("scrubber.current_index", 0ULL);
-                parameter_store.add("scrubber.index_window", 0ULL);
-                parameter_store.add("scrubber.index_step", 0ULL);
-                parameter_store.add("scrubber.min_index", 0ULL);
-                parameter_store.add("scrubber.max_index", 0ULL);
-
-                parameter_store.add("scrubber.current_time", 0.0f);
-                parameter_store.add("scrubber.time_window", 0.0f);
-                parameter_store.add("scrubber.time_step", 0.0f);
-                parameter_store.add("scrubber.min_time", 0.0f);
-                parameter_store.add("scrubber.max_time", 0.0f);
+                parameter_store.add("scrubber.current_index", static_cast<std::size_t>(0));
+                parameter_store.add("scrubber.index_window", static_cast<std::size_t>(0));
+                parameter_store.add("scrubber.index_step", static_cast<std::size_t>(0));
+                parameter_store.add("scrubber.min_index", static_cast<std::size_t>(0));
+                parameter_store.add("scrubber.max_index", static_cast<std::size_t>(0));
+
+                parameter_store.add("scrubber.current_time", static_cast<int64_t>(0));
+                parameter_store.add("scrubber.time_window", static_cast<int64_t>(0));
+                parameter_store.add("scrubber.time_step", static_cast<int64_t>(0));
+                parameter_store.add("scrubber.min_time", static_cast<int64_t>(0));
+                parameter_store.add("scrubber.max_time", static_cast<int64_t>(0));
                 parameter_store.add("scrubber.show_frame_data", false);
+                parameter_store.add("scrubber.epochs", std::vector<EventData::EpochRange>{});
 
                 lower_index = 0;
                 current_index = 0;
                 index_step = 0;
                 index_window = 0;
 
-                lower_time = 0.0f;
-                current_time = 0.0f;
-                time_step = 0.0f;
-                time_window = 0.0f;
+                lower_time = 0;
+                current_time = 0;
+                time_step = 0;
+                time_window = 0;
+                source_windows.clear();
 
                 return;
             }
 
-            parameter_store.add("scrubber.min_index", static_cast<std::size_t>(0));
-            parameter_store.add("scrubber.max_index", event_data->get_evt_vector_ref().size() - 1);
+            // Retained events are [min_index, max_index], min_index moves up as old events are evicted
+            std::size_t min_index = view.begin_index;
+            std::size_t max_index = view.end_index - 1;
+
+            // A selected epoch narrows them to the events recorded between two camera resets
+            std::vector<EventData::EpochRange> epochs = event_data->get_evt_epochs();
+            int64_t epoch = parameter_store.get<int64_t>("scrubber.epoch");
+            auto selected = std::find_if(epochs.begin(), epochs.end(), [epoch](const EventData::EpochRange &range) {
+                return static_cast<int64_t>(range.id) == epoch;
+            });
+            if (selected != epochs.end())
+            {
+                min_index = std::clamp(selected->first_index, min_index, max_index);
+                max_index = std::clamp(selected->last_index - 1, min_index, max_index);
+            }
+            else if (epoch != -1)
+            {
+                parameter_store.add("scrubber.epoch", static_cast<int64_t>(-1)); // Evicted, back to all epochs
+            }
+            parameter_store.add("scrubber.epochs", epochs);
+            parameter_store.add("scrubber.min_index", min_index);
+            parameter_store.add("scrubber.max_index", max_index);
 
             if (parameter_store.get<ScrubberType>("scrubber.type") == ScrubberType::TIME)
             {
-                current_time = parameter_store.get<float>("scrubber.current_time");
-                time_window = parameter_store.get<float>("scrubber.time_window");
-                time_step = parameter_store.get<float>("scrubber.time_step");
-
-                // Get time bounds from event data
-                const auto &evt_vector_relative = event_data->get_evt_vector_ref();
-                float min_time = 0.0f;
-                float max_time = 0.0f;
-                if (!evt_vector_relative.empty())
+                current_time = parameter_store.get<int64_t>("scrubber.current_time");
+                time_window = parameter_store.get<int64_t>("scrubber.time_window");
+                time_step = parameter_store.get<int64_t>("scrubber.time_step");
+
+                // Get time bounds from event data, or from the session when its segments are decoded on demand
+                int64_t min_time = event_data->get_evt_relative_time(min_index); // First retained element's time
+                int64_t max_time = event_data->get_evt_relative_time(max_index); // Last element's timestamp
+                if (session_timeline)
                 {
-                    min_time = 0.0f;                         // Relative timestamps start at 0
-                    max_time = evt_vector_relative.back().z; // Last element's timestamp
+                    min_time = 0;
+                    max_time = session_duration;
                 }
 
                 parameter_store.add("scrubber.min_time", min_time);
@@ -183,38 +277,34 @@ class Scrubber
                 if (parameter_store.get<ScrubberMode>("scrubber.mode") == ScrubberMode::PAUSED)
                 {
                     current_time = std::clamp(current_time, min_time, max_time);
-                    time_window = std::clamp(time_window, 0.0f, max_time - min_time);
-                    time_step = std::clamp(time_step, 0.0f, max_time - min_time);
+                    time_window = std::clamp(time_window, static_cast<int64_t>(0), max_time - min_time);
+                    time_step = std::clamp(time_step, static_cast<int64_t>(0), max_time - min_time);
                     lower_time = std::max(min_time, current_time - time_window);
                 }
                 else if (parameter_store.get<ScrubberMode>("scrubber.mode") == ScrubberMode::PLAYING)
                 {
-                    time_step = std::clamp(time_step, 0.0f, max_time - min_time);
-                    time_window = std::clamp(time_window, 0.0f, max_time - min_time);
+                    time_step = std::clamp(time_step, static_cast<int64_t>(0), max_time - min_time);
+                    time_window = std::clamp(time_window, static_cast<int64_t>(0), max_time - min_time);
                     current_time = std::clamp(current_time + time_step, min_time, max_time);
                     lower_time = std::max(min_time, current_time - time_window);
                 }
                 else if (parameter_store.get<ScrubberMode>("scrubber.mode") == ScrubberMode::LATEST)
                 {
                     current_time = max_time;
-                    time_window = std::clamp(time_window, 0.0f, max_time - min_time);
-                    time_step = std::clamp(time_step, 0.0f, max_time - min_time);
+                    time_window = std::clamp(time_window, static_cast<int64_t>(0), max_time - min_time);
+                    time_step = std::clamp(time_step, static_cast<int64_t>(0), max_time - min_time);
                     lower_time = std::max(min_time, current_time - time_window);
                 }
 
                 // Convert time values to indices for internal use
-                current_index = event_data->get_event_index_from_relative_timestamp(current_time);
-                lower_index = event_data->get_event_index_from_relative_timestamp(lower_time);
+                int64_t current_time_index = event_data->get_event_index_from_relative_timestamp(current_time);
+                int64_t lower_time_index = event_data->get_event_index_from_relative_timestamp(lower_time);
 
                 // Ensure indices are valid
-                if (current_index == -1)
-                    current_index = 0;
-                if (lower_index == -1)
-                    lower_index = 0;
-                if (current_index >= evt_vector_relative.size())
-                    current_index = evt_vector_relative.size() - 1;
-                if (lower_index >= evt_vector_relative.size())
-                    lower_index = evt_vector_relative.size() - 1;
+                current_index = current_time_index == -1 ? max_index : static_cast<std::size_t>(current_time_index);
+                lower_index = lower_time_index == -1 ? max_index : static_cast<std::size_t>(lower_time_index);
+                current_index = std::clamp(current_index, min_index, max_index);
+                lower_index = std::clamp(lower_index, min_index, current_index);
 
                 parameter_store.add("scrubber.current_time", current_time);
                 parameter_store.add("scrubber.time_window", time_window);
@@ -228,40 +318,34 @@ class Scrubber
             {
                 if (parameter_store.get<ScrubberMode>("scrubber.mode") == ScrubberMode::PAUSED)
                 {
-                    current_index = std::clamp(current_index, static_cast<std::size_t>(0),
-                                               event_data->get_evt_vector_ref().size() - 1);
-                    index_window = std::clamp(index_window, static_cast<std::size_t>(0),
-                                              event_data->get_evt_vector_ref().size() - 1);
-                    index_step = std::clamp(index_step, static_cast<std::size_t>(0),
-                                            event_data->get_evt_vector_ref().size() - 1);
-                    lower_index = std::max(static_cast<std::size_t>(0), current_index - index_window);
+                    current_index = std::clamp(current_index, min_index, max_index);
+                    index_window = std::clamp(index_window, static_cast<std::size_t>(0), max_index - min_index);
+                    index_step = std::clamp(index_step, static_cast<std::size_t>(0), max_index - min_index);
                 }
                 else if (parameter_store.get<ScrubberMode>("scrubber.mode") == ScrubberMode::PLAYING)
                 {
-                    index_step = std::clamp(index_step, static_cast<std::size_t>(0),
-                                            event_data->get_evt_vector_ref().size() - 1);
-                    index_window = std::clamp(index_window, static_cast<std::size_t>(0),
-                                              event_data->get_evt_vector_ref().size() - 1);
-                    current_index = std::clamp(current_index + index_step, static_cast<std::size_t>(0),
-                                               event_data->get_evt_vector_ref().size() - 1);
-                    lower_index = std::max(static_cast<std::size_t>(0), current_index - index_window);
+                    index_step = std::clamp(index_step, static_cast<std::size_t>(0), max_index - min_index);
+                    index_window = std::clamp(index_window, static_cast<std::size_t>(0), max_index - min_index);
+                    current_index = std::clamp(current_index + index_step, min_index, max_index);
                 }
                 else if (parameter_store.get<ScrubberMode>("scrubber.mode") == ScrubberMode::LATEST)
                 {
-                    std::size_t event_data_size =
-                        event_data->get_evt_vector_ref().empty() ? 0 : event_data->get_evt_vector_ref().size() - 1;
-                    current_index = event_data_size;
-                    index_window = std::clamp(index_window, static_cast<std::size_t>(0), event_data_size);
-                    index_step = std::clamp(index_step, static_cast<std::size_t>(0), event_data_size);
-                    lower_index = std::max(static_cast<std::size_t>(0), current_index - index_window);
+                    current_index = max_index;
+                    index_window = std::clamp(index_window, static_cast<std::size_t>(0), max_index - min_index);
+                    index_step = std::clamp(index_step, static_cast<std::size_t>(0), max_index - min_index);
                 }
+                lower_index = current_index - std::min(index_window, current_index - min_index);
 
                 parameter_store.add("scrubber.current_index", current_index);
                 parameter_store.add("scrubber.index_window", index_window);
                 parameter_store.add("scrubber.index_step", index_step);
             }
 
-            event_data->unlock_data_vectors();
+            // Other cameras are shown at the moment of the window
+            if (multi_source)
+            {
+                source_windows = multi_source->get_source_windows_at(scrubbed_source, lower_index, current_index);
+            }
         }
 
         /**
@@ -277,16 +361,12 @@ class Scrubber
                 return;
             }
 
-            event_data->lock_data_vectors();
-
-            // Get the data we need to copy
-            const auto &evt_vector = event_data->get_evt_vector_ref();
+            // Get the data we need to copy, events are read without locking
+            const EventData::EventView view = event_data->get_evt_view();
 
             // Return if event data is empty
-            if (evt_vector.empty())
+            if (view.begin_index == view.end_index)
             {
-                event_data->unlock_data_vectors();
-
                 // Delete old buffer if it exists
                 if (points_buffer)
                 {
@@ -296,6 +376,7 @@ class Scrubber
 
                 // Nothing to draw
                 points_buffer_size = 0;
+                points_count = 0;
 
                 // To prevent drawing of frames
                 frame_timestamps[0] = -1.0f;
@@ -310,25 +391,51 @@ class Scrubber
                 num_points = current_index - lower_index + 1;
             }
 
+            // Indices may have been evicted or reset since cpu_update, skip until it catches up
+            if (lower_index < view.begin_index || lower_index >= view.end_index || current_index >= view.end_index)
+            {
+                return;
+            }
+
             // Clamp to the actual size of the vector
-            num_points = std::min(num_points, evt_vector.size() - lower_index);
+            num_points = std::min(num_points, view.end_index - lower_index);
 
             // If we have no points to upload, skip
             if (num_points == 0)
             {
-                event_data->unlock_data_vectors();
                 return;
             }
 
-            if (lower_index >= evt_vector.size() || current_index >= evt_vector.size())
+            // Rebase times to the window so shaders get small exact floats, the time base is chosen so that
+            // events in the time segment of lower_index need no conversion before upload
+            points_time_base = event_data->get_evt_time_base(lower_index);
+            int64_t lower_evt_time = event_data->get_evt_relative_time(lower_index);
+            int64_t upper_evt_time = event_data->get_evt_relative_time(current_index);
+            lower_depth = static_cast<float>(lower_evt_time - points_time_base);
+            upper_depth = static_cast<float>(upper_evt_time - points_time_base);
+            camera_resolution = event_data->get_camera_event_resolution();
+
+            // Restrict the window to the region of interest, the tile index keeps the cost proportional to the
+            // events near the region. Or to one polarity, the polarity index streams keep the cost proportional to
+            // the events of that polarity. Points drawn and DCE both work on the gathered events.
+            bool roi_enabled = parameter_store.get<bool>("scrubber.roi_enabled");
+            int32_t polarity = parameter_store.get<int32_t>("scrubber.polarity");
+            bool gathered = roi_enabled || polarity >= 0;
+            if (roi_enabled)
             {
-                event_data->unlock_data_vectors();
-                return;
+                EventData::RegionOfInterest roi{.x = parameter_store.get<int32_t>("scrubber.roi_x"),
+                                                .y = parameter_store.get<int32_t>("scrubber.roi_y"),
+                                                .width = parameter_store.get<int32_t>("scrubber.roi_width"),
+                                                .height = parameter_store.get<int32_t>("scrubber.roi_height")};
+                num_points = event_data->gather_roi_evts(roi, lower_index, lower_index + num_points, points_time_base,
+                                                         gathered_staging, polarity);
+            }
+            else if (polarity >= 0)
+            {
+                num_points = event_data->gather_polarity_evts(static_cast<uint8_t>(polarity), lower_index,
+                                                              lower_index + num_points, points_time_base,
+                                                              gathered_staging);
             }
-
-            lower_depth = evt_vector[lower_index].z;
-            upper_depth = evt_vector[current_index].z;
-            camera_resolution = event_data->get_camera_event_resolution();
 
             // Delete old buffer if it exists
             if (points_buffer)
@@ -337,26 +444,56 @@ class Scrubber
                 points_buffer = nullptr;
             }
 
-            // Calculate the size needed for the buffer
-            points_buffer_size = num_points * sizeof(glm::vec4);
+            // Calculate the size needed for the buffer, events are uploaded in their storage format
+            points_count = num_points;
+            points_packed = event_data->get_evt_format() != EventData::EventFormat::VEC4; // Columnar is gathered
+            points_buffer_size = num_points * event_data->get_evt_element_size();
 
             // Create new buffer
-            SDL_GPUBufferCreateInfo buffer_create_info = {0};
-            buffer_create_info.usage = SDL_GPU_BUFFERUSAGE_VERTEX | SDL_GPU_BUFFERUSAGE_COMPUTE_STORAGE_READ;
-            buffer_create_info.size = points_buffer_size;
-            points_buffer = SDL_CreateGPUBuffer(gpu_device, &buffer_create_info);
+            if (points_buffer_size > 0)
+            {
+                SDL_GPUBufferCreateInfo buffer_create_info = {0};
+                buffer_create_info.usage =
+                    SDL_GPU_BUFFERUSAGE_GRAPHICS_STORAGE_READ | SDL_GPU_BUFFERUSAGE_COMPUTE_STORAGE_READ;
+                buffer_create_info.size = points_buffer_size;
+                points_buffer = SDL_CreateGPUBuffer(gpu_device, &buffer_create_info);
+            }
 
-            // Upload data to the new buffer
-            const glm::vec4 *data_ptr = evt_vector.data() + lower_index;
-            upload_buffer->upload_to_gpu(copy_pass, points_buffer, data_ptr, points_buffer_size);
+            // Upload data to the new buffer, events are copied (or decoded if sealed) straight into the transfer buffer
+            if (gathered)
+            {
+                if (points_buffer_size > 0)
+                {
+                    upload_buffer->upload_to_gpu(copy_pass, points_buffer, gathered_staging.data(), points_buffer_size,
+                                                 0);
+                }
+            }
+            else
+            {
+                std::size_t element_size = event_data->get_evt_element_size();
+                upload_buffer->upload_to_gpu_in_place(
+                    copy_pass, points_buffer, points_buffer_size, [&](void *ptr, size_t offset, size_t num) {
+                        std::size_t first = lower_index + offset / element_size;
+                        event_data->copy_evts(first, first + num / element_size, points_time_base,
+                                              static_cast<std::byte *>(ptr));
+                    });
+            }
 
-            const std::vector<std::pair<cv::Mat, float>> &frame_vector = event_data->get_frame_vector_ref();
+            // Data evicted or cleared while being read may be torn, draw nothing this frame rather than garbage
+            if (!event_data->is_evt_view_current(view))
+            {
+                points_count = 0;
+            }
+
+            // Frame data is still shared under the lock, held only to pick and fetch the frames
+            event_data->lock_data_vectors();
+            EventData::FrameStore &frame_store = event_data->get_frame_store_ref();
 
             // Below is frame texture generation code, skip if user does not want frames
             glm::vec2 current_frame_dimensions = event_data->get_camera_frame_resolution();
 
             // Also sanity check the dimensions of the frame
-            if (!parameter_store.get<bool>("scrubber.show_frame_data") || frame_vector.empty() ||
+            if (!parameter_store.get<bool>("scrubber.show_frame_data") || frame_store.empty() ||
                 (current_frame_dimensions.x < 1.0f || current_frame_dimensions.y < 1.0f))
             {
                 event_data->unlock_data_vectors();
@@ -398,57 +535,59 @@ class Scrubber
             frame_timestamps[0] = -1.0f;
             frame_timestamps[1] = -1.0f;
 
-            // Since frame_vector is sorted by timestamp, use binary search to find frames
+            // Since frame_store is sorted by timestamp, use binary search to find frames
             // that bracket upper_depth (the current time we're interpolating at)
-            std::pair<cv::Mat, float> target_pair{cv::Mat{}, upper_depth};
-            auto lb = std::lower_bound(frame_vector.begin(), frame_vector.end(), target_pair, frame_less_vec4_t);
+            frames_current_time = static_cast<float>(upper_evt_time);
+            const std::size_t first_frame = frame_store.begin_index();
+            const std::size_t end_frame = frame_store.end_index();
+            const std::size_t lb = frame_store.lower_bound(upper_evt_time);
 
-            std::size_t frame_idx_0 = 0;
-            std::size_t frame_idx_1 = 0;
+            std::size_t frame_idx_0 = first_frame;
+            std::size_t frame_idx_1 = first_frame;
             bool found_valid_frames = false;
 
             // Determine which two frames to use for interpolation
-            if (lb == frame_vector.end())
+            if (lb == end_frame)
             {
                 // upper_depth is after all frames - use the last two frames
-                if (frame_vector.size() >= 2)
+                if (frame_store.size() >= 2)
                 {
-                    frame_idx_0 = frame_vector.size() - 2;
-                    frame_idx_1 = frame_vector.size() - 1;
+                    frame_idx_0 = end_frame - 2;
+                    frame_idx_1 = end_frame - 1;
                     found_valid_frames = true;
                 }
-                else if (frame_vector.size() == 1)
+                else if (frame_store.size() == 1)
                 {
-                    frame_idx_0 = 0;
+                    frame_idx_0 = first_frame;
                     found_valid_frames = true;
                 }
             }
-            else if (lb == frame_vector.begin())
+            else if (lb == first_frame)
             {
                 // upper_depth is before all frames - use the first two frames
-                if (frame_vector.size() >= 2)
+                if (frame_store.size() >= 2)
                 {
-                    frame_idx_0 = 0;
-                    frame_idx_1 = 1;
+                    frame_idx_0 = first_frame;
+                    frame_idx_1 = first_frame + 1;
                     found_valid_frames = true;
                 }
-                else if (frame_vector.size() == 1)
+                else if (frame_store.size() == 1)
                 {
-                    frame_idx_0 = 0;
+                    frame_idx_0 = first_frame;
                     found_valid_frames = true;
                 }
             }
             else
             {
                 // upper_depth is between frames - find the frame before and after
-                std::size_t after_idx = std::distance(frame_vector.begin(), lb);
+                std::size_t after_idx = lb;
                 std::size_t before_idx = after_idx - 1;
 
                 // Check if frames are within the time window
-                bool before_in_window =
-                    (frame_vector[before_idx].second >= lower_depth && frame_vector[before_idx].second <= upper_depth);
-                bool after_in_window =
-                    (frame_vector[after_idx].second >= lower_depth && frame_vector[after_idx].second <= upper_depth);
+                bool before_in_window = (frame_store.timestamp(before_idx) >= lower_evt_time &&
+                                         frame_store.timestamp(before_idx) <= upper_evt_time);
+                bool after_in_window = (frame_store.timestamp(after_idx) >= lower_evt_time &&
+                                        frame_store.timestamp(after_idx) <= upper_evt_time);
 
                 if (before_in_window && after_in_window)
                 {
@@ -461,12 +600,14 @@ class Scrubber
                 {
                     // Only before frame is in window
                     frame_idx_0 = before_idx;
+                    frame_idx_1 = before_idx;
                     found_valid_frames = true;
                 }
                 else if (after_in_window)
                 {
                     // Only after frame is in window
                     frame_idx_0 = after_idx;
+                    frame_idx_1 = after_idx;
                     found_valid_frames = true;
                 }
                 else
@@ -478,16 +619,17 @@ class Scrubber
                 }
             }
 
-            // Upload frames and set timestamps
+            // Fetch frames and set timestamps, frames near the cursor are served decoded from the store's cache
+            std::array<std::optional<EventData::FrameStore::FetchedFrame>, 2> fetched_frames{};
             if (found_valid_frames)
             {
-                upload_buffer->upload_cv_mat(copy_pass, frames, frame_vector[frame_idx_0].first, 0);
-                frame_timestamps[0] = frame_vector[frame_idx_0].second;
+                fetched_frames[0] = frame_store.fetch(frame_idx_0);
+                frame_timestamps[0] = static_cast<float>(frame_store.timestamp(frame_idx_0));
 
-                if (frame_idx_1 != frame_idx_0 && frame_idx_1 < frame_vector.size())
+                if (frame_idx_1 != frame_idx_0 && frame_idx_1 < end_frame)
                 {
-                    upload_buffer->upload_cv_mat(copy_pass, frames, frame_vector[frame_idx_1].first, 1);
-                    frame_timestamps[1] = frame_vector[frame_idx_1].second;
+                    fetched_frames[1] = frame_store.fetch(frame_idx_1);
+                    frame_timestamps[1] = static_cast<float>(frame_store.timestamp(frame_idx_1));
                 }
                 else
                 {
@@ -496,6 +638,27 @@ class Scrubber
             }
 
             event_data->unlock_data_vectors();
+
+            // Decode and upload without the lock, then cache what was decoded for the next frames drawn
+            std::array<cv::Mat, 2> decoded_frames{};
+            for (uint32_t layer = 0; layer < fetched_frames.size(); ++layer)
+            {
+                if (fetched_frames[layer].has_value())
+                {
+                    decoded_frames[layer] = EventData::FrameStore::decode(fetched_frames[layer].value());
+                    upload_buffer->upload_cv_mat(copy_pass, frames, decoded_frames[layer], layer);
+                }
+            }
+
+            event_data->lock_data_vectors();
+            for (uint32_t layer = 0; layer < fetched_frames.size(); ++layer)
+            {
+                if (fetched_frames[layer].has_value())
+                {
+                    frame_store.cache(fetched_frames[layer].value(), decoded_frames[layer]);
+                }
+            }
+            event_data->unlock_data_vectors();
         }
 
         /**
@@ -526,6 +689,15 @@ class Scrubber
             return frame_timestamps;
         }
 
+        /**
+         * @brief Get current time frames are interpolated at, on the same scale as get_frames_timestamps.
+         * @return current time frames are interpolated at.
+         */
+        float get_frames_current_time()
+        {
+            return frames_current_time;
+        }
+
         /**
          * @brief Get dimensions of frames being drawn by scrubber.
          * @return std::array containing width and height of frames being drawn by scrubber.
@@ -535,6 +707,30 @@ class Scrubber
             return {frame_width, frame_height};
         }
 
+        /**
+         * @brief Returns the window of every camera's events at the moment shown, when cameras are scrubbed
+         *        together, see MultiSourceEventData::get_source_windows_at.
+         * @return [first, last) event indices of every source, by source id, empty for a single camera.
+         */
+        const std::vector<std::pair<std::size_t, std::size_t>> &get_source_windows()
+        {
+            return source_windows;
+        }
+
+        /**
+         * @brief Returns the event rate over the whole retained recording, see EventData::get_evt_rate_timeline.
+         * @param max_buckets largest number of values wanted.
+         * @return event rate in events per second of each time bucket, oldest first.
+         */
+        std::vector<float> get_evt_rate_timeline(std::size_t max_buckets)
+        {
+            if (!event_data)
+            {
+                return {};
+            }
+            return event_data->get_evt_rate_timeline(max_buckets);
+        }
+
         /**
          * @brief Returns the size of the points buffer,
          *        size of buffer in GPU memory containing event data as points to be drawn.
@@ -542,11 +738,30 @@ class Scrubber
          */
         std::size_t get_points_buffer_size()
         {
-            return points_buffer_size / sizeof(glm::vec4);
+            return points_count;
+        }
+
+        /**
+         * @brief Returns whether the points buffer holds events in the compact packed format
+         *        (EventData::PackedEvent) instead of glm::vec4.
+         * @return true if points buffer holds packed events.
+         */
+        bool get_points_packed()
+        {
+            return points_packed;
+        }
+
+        /**
+         * @brief Returns relative time the uploaded point times and the depths are offsets from.
+         * @return time base of points buffer in microseconds.
+         */
+        int64_t get_points_time_base()
+        {
+            return points_time_base;
         }
 
         /**
-         * @brief Returns lower time bound of scrubber window.
+         * @brief Returns lower time bound of scrubber window, relative to get_points_time_base().
          * @return lower time bound of scrubber window.
          */
         float get_lower_depth()
@@ -555,7 +770,7 @@ class Scrubber
         }
 
         /**
-         * @brief Returns upper time bound of scrubber window.
+         * @brief Returns upper time bound of scrubber window, relative to get_points_time_base().
          * @return upper time bound of scrubber window.
          */
         float get_upper_depth()
@@ -0,0 +1,118 @@
+#pragma once
+#ifndef SPSC_RING_HH
+#define SPSC_RING_HH
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Bounded lock-free ring buffer handing items from one producer thread to one consumer thread. Pushing and
+ *        popping never wait, a full ring refuses the push and an empty ring the pop, so either side decides itself
+ *        whether to drop, retry or do something else. Each side keeps a cached copy of the other side's index and
+ *        only reads the shared one when the cache says the ring is full or empty, so the two threads touch each
+ *        other's cache lines about once per lap instead of once per item.
+ */
+template <typename T> class SpscRing
+{
+    public:
+        /**
+         * @brief Constructor.
+         * @param capacity most items held, rounded up to a power of two.
+         */
+        explicit SpscRing(std::size_t capacity)
+            : slots(std::bit_ceil(std::max(capacity, static_cast<std::size_t>(2)))), mask{slots.size() - 1}
+        {
+        }
+
+        SpscRing(const SpscRing &) = delete;
+        SpscRing &operator=(const SpscRing &) = delete;
+
+        /**
+         * @brief Adds an item at the back. Producer only.
+         * @param item item to add, moved from only if it was added.
+         * @return true if the item was added, false if the ring is full.
+         */
+        bool try_push(T &&item)
+        {
+            const std::size_t tail_index{tail.load(std::memory_order_relaxed)};
+            if (tail_index - cached_head == slots.size())
+            {
+                cached_head = head.load(std::memory_order_acquire);
+                if (tail_index - cached_head == slots.size())
+                {
+                    return false;
+                }
+            }
+            slots[tail_index & mask] = std::move(item);
+            tail.store(tail_index + 1, std::memory_order_release);
+            return true;
+        }
+
+        /**
+         * @brief Removes the item at the front. Consumer only.
+         * @param item set to the removed item.
+         * @return true if an item was removed, false if the ring is empty.
+         */
+        bool try_pop(T &item)
+        {
+            const std::size_t head_index{head.load(std::memory_order_relaxed)};
+            if (head_index == cached_tail)
+            {
+                cached_tail = tail.load(std::memory_order_acquire);
+                if (head_index == cached_tail)
+                {
+                    return false;
+                }
+            }
+            item = std::move(slots[head_index & mask]);
+            head.store(head_index + 1, std::memory_order_release);
+            return true;
+        }
+
+        /**
+         * @brief Gets the number of items held. Any thread, only a snapshot while both sides are running.
+         * @return number of items held.
+         */
+        std::size_t size() const
+        {
+            // Head first, the tail read after it is never behind it
+            const std::size_t head_index{head.load(std::memory_order_acquire)};
+            return tail.load(std::memory_order_acquire) - head_index;
+        }
+
+        /**
+         * @brief Checks if the ring holds no items. Any thread, only a snapshot while both sides are running.
+         * @return true if the ring is empty, false otherwise.
+         */
+        bool empty() const
+        {
+            return size() == 0;
+        }
+
+        /**
+         * @brief Gets the most items the ring holds.
+         * @return capacity of the ring.
+         */
+        std::size_t capacity() const
+        {
+            return slots.size();
+        }
+
+    private:
+        std::vector<T> slots;
+        const std::size_t mask;
+
+        // Consumer side, index of the next item to pop and the last tail it saw
+        alignas(64) std::atomic<std::size_t> head{0};
+        std::size_t cached_tail{0};
+
+        // Producer side, index of the next slot to push to and the last head it saw
+        alignas(64) std::atomic<std::size_t> tail{0};
+        std::size_t cached_head{0};
+};
+
+#endif // SPSC_RING_HH
@@ -42,8 +42,10 @@ class UploadBuffer
          * @param dst Destination of data to be copied to GPU.
          * @param src Source data buffer to be copied.
          * @param nbyte Number of bytes to copy from src to GPU.
+         * @param dst_offset Byte offset into dst to start writing at.
          */
-        void upload_to_gpu(SDL_GPUCopyPass *pass, SDL_GPUBuffer *dst, const void *src, size_t nbyte)
+        void upload_to_gpu(SDL_GPUCopyPass *pass, SDL_GPUBuffer *dst, const void *src, size_t nbyte,
+                           size_t dst_offset = 0)
         {
             size_t offset = 0;
             while (nbyte > 0)
@@ -57,8 +59,46 @@ class UploadBuffer
                 SDL_UnmapGPUTransferBuffer(gpu_device, transfer_buffer);
 
                 SDL_GPUTransferBufferLocation transfer_location = {.transfer_buffer = transfer_buffer};
-                SDL_GPUBufferRegion buffer_region = {
-                    .buffer = dst, .offset = static_cast<Uint32>(offset), .size = static_cast<Uint32>(num)};
+                SDL_GPUBufferRegion buffer_region = {.buffer = dst,
+                                                     .offset = static_cast<Uint32>(dst_offset + offset),
+                                                     .size = static_cast<Uint32>(num)};
+
+                SDL_UploadToGPUBuffer(pass, &transfer_location, &buffer_region, false);
+
+                nbyte -= num;
+                offset += num;
+            }
+        }
+
+        /**
+         * @brief Uploads data to GPU that is written straight into the transfer buffer instead of copied from a
+         *        source buffer, saves a copy when the data is produced anyway, e.g. decoded.
+         * @param pass SDL_GPUCopyPass for copying data to GPU.
+         * @param dst Destination of data to be copied to GPU.
+         * @param nbyte Number of bytes to upload.
+         * @param fill Callable taking (void *ptr, size_t offset, size_t num) that writes bytes [offset, offset + num)
+         *        of the data to ptr. Pieces are a multiple of any power of two element size up to 1 MB.
+         * @param dst_offset Byte offset into dst to start writing at.
+         */
+        template <typename Fill>
+        void upload_to_gpu_in_place(SDL_GPUCopyPass *pass, SDL_GPUBuffer *dst, size_t nbyte, Fill &&fill,
+                                    size_t dst_offset = 0)
+        {
+            size_t offset = 0;
+            while (nbyte > 0)
+            {
+                size_t num = nbyte;
+                if (num > buffer_size)
+                    num = buffer_size;
+
+                void *ptr = SDL_MapGPUTransferBuffer(gpu_device, transfer_buffer, true);
+                fill(ptr, offset, num);
+                SDL_UnmapGPUTransferBuffer(gpu_device, transfer_buffer);
+
+                SDL_GPUTransferBufferLocation transfer_location = {.transfer_buffer = transfer_buffer};
+                SDL_GPUBufferRegion buffer_region = {.buffer = dst,
+                                                     .offset = static_cast<Uint32>(dst_offset + offset),
+                                                     .size = static_cast<Uint32>(num)};
 
                 SDL_UploadToGPUBuffer(pass, &transfer_location, &buffer_region, false);
 
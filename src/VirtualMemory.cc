@@ -0,0 +1,161 @@
+#include "VirtualMemory.hh"
+
+#include <stdexcept>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <unistd.h>
+#endif
+
+namespace virtual_memory
+{
+
+std::size_t page_size()
+{
+#if defined(_WIN32)
+    SYSTEM_INFO system_info{};
+    GetSystemInfo(&system_info);
+    return static_cast<std::size_t>(system_info.dwPageSize);
+#else
+    return static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+#endif
+}
+
+std::byte *map_anonymous(std::size_t size, bool transparent_huge_pages, bool explicit_huge_pages, bool populate)
+{
+#if defined(_WIN32)
+    void *address{nullptr};
+    std::size_t large_page_size{GetLargePageMinimum()};
+    if (explicit_huge_pages && large_page_size > 0 && size % large_page_size == 0)
+    {
+        // Large pages are always mapped up front
+        address = VirtualAlloc(nullptr, size, MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES, PAGE_READWRITE);
+    }
+    if (!address)
+    {
+        address = VirtualAlloc(nullptr, size, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+    }
+    if (!address)
+    {
+        throw std::runtime_error("Failed to allocate memory for EventData buffer.");
+    }
+#else
+    int flags{MAP_PRIVATE | MAP_ANONYMOUS};
+#if defined(MAP_POPULATE)
+    if (populate)
+    {
+        flags |= MAP_POPULATE;
+    }
+#endif
+    void *address{MAP_FAILED};
+#if defined(MAP_HUGETLB)
+    if (explicit_huge_pages)
+    {
+        // Fails unless huge pages were reserved, e.g. through /proc/sys/vm/nr_hugepages
+        address = mmap(nullptr, size, PROT_READ | PROT_WRITE, flags | MAP_HUGETLB, -1, 0);
+    }
+#endif
+    if (address == MAP_FAILED)
+    {
+        address = mmap(nullptr, size, PROT_READ | PROT_WRITE, flags, -1, 0);
+        if (address == MAP_FAILED)
+        {
+            throw std::runtime_error("Failed to map memory for EventData buffer.");
+        }
+#if defined(MADV_HUGEPAGE)
+        if (transparent_huge_pages || explicit_huge_pages)
+        {
+            madvise(address, size, MADV_HUGEPAGE);
+        }
+#endif
+    }
+#endif
+
+#if defined(_WIN32) || !defined(MAP_POPULATE)
+    if (populate)
+    {
+        volatile std::byte *bytes{static_cast<std::byte *>(address)};
+        for (std::size_t offset{0}; offset < size; offset += page_size())
+        {
+            bytes[offset] = std::byte{0};
+        }
+    }
+#endif
+    return static_cast<std::byte *>(address);
+}
+
+void unmap_anonymous(std::byte *address, std::size_t size)
+{
+#if defined(_WIN32)
+    VirtualFree(address, 0, MEM_RELEASE);
+#else
+    munmap(address, size);
+#endif
+}
+
+void prefetch_pages(std::byte *address, std::size_t size)
+{
+#if defined(_WIN32)
+    WIN32_MEMORY_RANGE_ENTRY range{address, size};
+    PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0);
+#else
+    madvise(address, size, MADV_WILLNEED);
+#endif
+}
+
+void release_pages(std::byte *address, std::size_t size, bool private_mapping)
+{
+#if defined(_WIN32)
+    // Unlocking pages that are not locked removes them from the working set, nothing is lost
+    VirtualUnlock(address, size);
+#else
+    if (!private_mapping)
+    {
+        // Pages of shared mappings are backed by the chunk file, dropping them loses nothing
+        madvise(address, size, MADV_DONTNEED);
+    }
+    else
+    {
+#if defined(MADV_COLD)
+        // MADV_DONTNEED would discard written private pages, only mark them for reclaim
+        madvise(address, size, MADV_COLD);
+#endif
+    }
+#endif
+}
+
+uint64_t page_fault_count()
+{
+#if defined(_WIN32)
+    PROCESS_MEMORY_COUNTERS counters{};
+    if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+    {
+        return 0;
+    }
+    return counters.PageFaultCount;
+#else
+#if defined(RUSAGE_THREAD)
+    constexpr int who{RUSAGE_THREAD};
+#else
+    constexpr int who{RUSAGE_SELF};
+#endif
+    rusage usage{};
+    if (getrusage(who, &usage) != 0)
+    {
+        return 0;
+    }
+    return static_cast<uint64_t>(usage.ru_majflt);
+#endif
+}
+
+} // namespace virtual_memory
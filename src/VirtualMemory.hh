@@ -0,0 +1,65 @@
+#pragma once
+#ifndef VIRTUAL_MEMORY_HH
+#define VIRTUAL_MEMORY_HH
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief Thin wrappers around the virtual memory calls of the OS (mmap and madvise, VirtualAlloc and
+ *        PrefetchVirtualMemory). Defined in VirtualMemory.cc, so the platform headers stay out of the headers that
+ *        use them.
+ */
+namespace virtual_memory
+{
+
+/**
+ * @brief Returns the size of a virtual memory page.
+ * @return page size in bytes.
+ */
+std::size_t page_size();
+
+/**
+ * @brief Maps anonymous memory. Throws std::runtime_error if the memory cannot be mapped.
+ * @param size size in bytes, a multiple of the page size.
+ * @param transparent_huge_pages true to ask the OS to back the memory with huge pages when it can.
+ * @param explicit_huge_pages true to map reserved huge pages, falls back to transparent huge pages if none are
+ *                            available.
+ * @param populate true to map every page up front instead of on first touch.
+ * @return address of the memory.
+ */
+std::byte *map_anonymous(std::size_t size, bool transparent_huge_pages, bool explicit_huge_pages, bool populate);
+
+/**
+ * @brief Unmaps memory mapped by map_anonymous.
+ * @param address address of the memory.
+ * @param size size of the memory in bytes.
+ */
+void unmap_anonymous(std::byte *address, std::size_t size);
+
+/**
+ * @brief Asks the OS to read whole mapped pages in the background.
+ * @param address page aligned start of the pages.
+ * @param size size of the pages in bytes.
+ */
+void prefetch_pages(std::byte *address, std::size_t size);
+
+/**
+ * @brief Tells the OS whole mapped pages are not needed soon, so they are reclaimed before others.
+ * @param address page aligned start of the pages.
+ * @param size size of the pages in bytes.
+ * @param private_mapping true if the pages are mapped privately, their written pages must not be discarded.
+ */
+void release_pages(std::byte *address, std::size_t size, bool private_mapping);
+
+/**
+ * @brief Gets the number of page faults so far that had to wait on a read from disk. Counts faults of the calling
+ *        thread where the OS tracks them per thread, of the whole process otherwise. On Windows all faults are
+ *        counted, including those served from memory.
+ * @return number of page faults.
+ */
+uint64_t page_fault_count();
+
+} // namespace virtual_memory
+
+#endif // VIRTUAL_MEMORY_HH
@@ -354,7 +354,7 @@ class Visualizer
                     vs_create_info.stage = SDL_GPU_SHADERSTAGE_VERTEX;
                     vs_create_info.num_samplers = 0;
                     vs_create_info.num_storage_textures = 0;
-                    vs_create_info.num_storage_buffers = 0;
+                    vs_create_info.num_storage_buffers = 1;
                     vs_create_info.num_uniform_buffers = 1;
                     SDL_GPUShader *vs = SDL_CreateGPUShader(gpu_device, &vs_create_info);
 
@@ -371,18 +371,17 @@ class Visualizer
                     SDL_GPUShader *fs = SDL_CreateGPUShader(gpu_device, &fs_create_info);
 
                     // Create graphics pipeline for point rendering
-                    SDL_GPUVertexBufferDescription vertex_buffer_desc = {0, sizeof(glm::vec4),
-                                                                         SDL_GPU_VERTEXINPUTRATE_VERTEX, 0};
-                    SDL_GPUVertexAttribute vertex_attribute = {0, 0, SDL_GPU_VERTEXELEMENTFORMAT_FLOAT4, 0};
+                    // Points are fetched from a storage buffer by vertex index, so they can be either glm::vec4 or
+                    // EventData::PackedEvent, no vertex input state is needed
                     SDL_GPUColorTargetDescription color_target_desc = {SDL_GPU_TEXTUREFORMAT_R8G8B8A8_SNORM};
 
                     SDL_GPUGraphicsPipelineCreateInfo pipeline_info = {
                         .vertex_shader = vs,
                         .fragment_shader = fs,
-                        .vertex_input_state = {.vertex_buffer_descriptions = &vertex_buffer_desc,
-                                               .num_vertex_buffers = 1,
-                                               .vertex_attributes = &vertex_attribute,
-                                               .num_vertex_attributes = 1},
+                        .vertex_input_state = {.vertex_buffer_descriptions = nullptr,
+                                               .num_vertex_buffers = 0,
+                                               .vertex_attributes = nullptr,
+                                               .num_vertex_attributes = 0},
                         .primitive_type = SDL_GPU_PRIMITIVETYPE_POINTLIST,
                         .depth_stencil_state = {.compare_op = SDL_GPU_COMPAREOP_LESS_OR_EQUAL,
                                                 .enable_depth_test = true,
@@ -434,9 +433,9 @@ class Visualizer
                     // Bind the graphics pipeline
                     SDL_BindGPUGraphicsPipeline(render_pass, points_pipeline);
 
-                    // Bind the vertex buffer
-                    SDL_GPUBufferBinding vertex_buffer_binding[] = {scrubber->get_points_buffer(), 0};
-                    SDL_BindGPUVertexBuffers(render_pass, 0, vertex_buffer_binding, 1);
+                    // Bind the points storage buffer
+                    SDL_GPUBuffer *points_buffer = scrubber->get_points_buffer();
+                    SDL_BindGPUVertexStorageBuffers(render_pass, 0, &points_buffer, 1);
 
                     // Create uniform buffer data for points shader
                     struct PointsUniforms
@@ -445,6 +444,7 @@ class Visualizer
                             glm::vec4 negative_color;
                             glm::vec4 positive_color;
                             float point_size;
+                            uint32_t packed_events;
                     } uniforms;
 
                     glm::vec2 camera_resolution = scrubber->get_camera_resolution();
@@ -471,6 +471,7 @@ class Visualizer
                     uniforms.negative_color = glm::vec4(parameter_store.get<glm::vec3>("polarity_neg_color"), 1.0f);
                     uniforms.positive_color = glm::vec4(parameter_store.get<glm::vec3>("polarity_pos_color"), 1.0f);
                     uniforms.point_size = parameter_store.get<float>("particle_scale");
+                    uniforms.packed_events = scrubber->get_points_packed() ? 1 : 0;
 
                     // Push the uniform data
                     SDL_PushGPUVertexUniformData(command_buffer, 0, &uniforms, sizeof(uniforms));
@@ -942,7 +943,7 @@ class Visualizer
                     SDL_BindGPUFragmentSamplers(render_pass, 0, &sampler_binding, 1);
 
                     glm::vec4 frame_data = {scrubber->get_frames_timestamps()[0], scrubber->get_frames_timestamps()[1],
-                                            scrubber->get_upper_depth(), 0.0f};
+                                            scrubber->get_frames_current_time(), 0.0f};
                     SDL_PushGPUFragmentUniformData(command_buffer, 0, &frame_data, sizeof(frame_data));
 
                     SDL_DrawGPUPrimitives(render_pass, 6, 1, 0, 0);
@@ -1166,7 +1167,8 @@ class Visualizer
             // Get z subdivisions from parameter store
             uint32_t z_subdivisions = parameter_store.get<uint32_t>("visualizer.grid.z_subdivisions");
 
-            // Get depth range from scrubber
+            // Get depth range from scrubber, labels add the time base back in double to keep precision
+            double time_base = static_cast<double>(scrubber->get_points_time_base());
             float lower_depth = scrubber->get_lower_depth();
             float upper_depth = scrubber->get_upper_depth();
             float depth_range = upper_depth - lower_depth;
@@ -1184,7 +1186,7 @@ class Visualizer
                 float normalized_z = 2.0f * static_cast<float>(i) / static_cast<float>(z_subdivisions) - 1.0f;
 
                 // Convert normalized Z to actual depth value
-                float timestamp = lower_depth + (normalized_z + 1.0f) * 0.5f * depth_range;
+                double timestamp = time_base + lower_depth + (normalized_z + 1.0f) * 0.5f * depth_range;
 
                 if (!parameter_store.exists("unit_time_conversion_factor"))
                 {
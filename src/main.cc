@@ -10,7 +10,7 @@
 #include "SpinningCube.hh"
 #include "UploadBuffer.hh"
 #include "Visualizer.hh"
-#include "threads.hh" // For data writer and data acquisition threads
+#include "threads.hh" // For data writer, data acquisition and prefetch threads
 
 ParameterStore *g_parameter_store = nullptr;
 
@@ -31,6 +31,7 @@ float g_last_frame_render_time{0.0f};
 EventData g_event_data{};
 DataAcquisition g_data_acq{};
 DataWriter g_data_writer{};
+AcquisitionPipeline g_acquisition_pipeline{};
 
 // Needed to ensure thread joins for program clean up
 std::atomic<bool> g_writer_running{true};
@@ -43,6 +44,81 @@ std::atomic<bool> g_data_acquisition_running{true};
 
 std::thread *g_data_acquisition_thread_ptr = nullptr;
 
+// Needed to ensure thread joins for program clean up
+std::atomic<bool> g_prefetch_running{true};
+
+std::thread *g_prefetch_thread_ptr = nullptr;
+
+// Needed to ensure thread joins for program clean up
+std::atomic<bool> g_convert_running{true};
+
+std::thread *g_convert_thread_ptr = nullptr;
+
+// Needed to ensure thread joins for program clean up
+std::atomic<bool> g_ingest_running{true};
+
+std::thread *g_ingest_thread_ptr = nullptr;
+
+/**
+ * @brief Reads event storage settings from the command line:
+ *        --storage=file|memory|hybrid, --scratch-dir=PATH, --memory-limit-mb=N (hybrid storage),
+ *        --huge-pages=none|transparent|explicit and --populate (memory and hybrid storage).
+ * @param argc number of command line arguments.
+ * @param argv command line arguments.
+ * @return storage settings, defaults for arguments not given.
+ */
+EventData::StorageConfig parse_storage_config(int argc, char *argv[])
+{
+    EventData::StorageConfig storage{};
+    for (int i{1}; i < argc; ++i)
+    {
+        std::string_view arg{argv[i]};
+        std::string_view value{arg.substr(arg.find('=') == std::string_view::npos ? arg.size() : arg.find('=') + 1)};
+        if (arg == "--storage=file")
+        {
+            storage.backend = EventData::StorageBackend::MAPPED_FILE;
+        }
+        else if (arg == "--storage=memory")
+        {
+            storage.backend = EventData::StorageBackend::ANONYMOUS;
+        }
+        else if (arg == "--storage=hybrid")
+        {
+            storage.backend = EventData::StorageBackend::HYBRID;
+        }
+        else if (arg.starts_with("--scratch-dir="))
+        {
+            storage.scratch_directory = std::filesystem::path{value};
+        }
+        else if (arg.starts_with("--memory-limit-mb="))
+        {
+            storage.memory_limit = static_cast<std::size_t>(std::strtoull(std::string{value}.c_str(), nullptr, 10))
+                                   << 20;
+        }
+        else if (arg == "--huge-pages=none")
+        {
+            storage.huge_pages = EventData::HugePageMode::NONE;
+        }
+        else if (arg == "--huge-pages=transparent")
+        {
+            storage.huge_pages = EventData::HugePageMode::TRANSPARENT_HUGE_PAGES;
+        }
+        else if (arg == "--huge-pages=explicit")
+        {
+            storage.huge_pages = EventData::HugePageMode::EXPLICIT_HUGE_PAGES;
+        }
+        else if (arg == "--populate")
+        {
+            storage.populate = true;
+        }
+        else
+        {
+            SDL_Log("Ignoring unknown argument: %s", argv[i]);
+        }
+    }
+    return storage;
+}
+
 /**
  * @brief This function runs once at startup.
  */
@@ -50,6 +126,17 @@ SDL_AppResult SDL_AppInit(void **appstate, int argc, char *argv[])
 {
     g_parameter_store = new ParameterStore();
 
+    // Before any thread writes event data, so all storage is backed as asked
+    try
+    {
+        g_event_data.set_storage_config(parse_storage_config(argc, argv));
+    }
+    catch (const std::exception &e)
+    {
+        SDL_Log("Couldn't set up event storage: %s", e.what());
+        return SDL_APP_FAILURE;
+    }
+
     if (!SDL_Init(SDL_INIT_VIDEO))
     {
         SDL_Log("Couldn't initialize SDL: %s", SDL_GetError());
@@ -98,11 +185,19 @@ SDL_AppResult SDL_AppInit(void **appstate, int argc, char *argv[])
     SDL_SubmitGPUCommandBuffer(command_buffer);
 
     // Initialize threads
-    g_writer_thread_ptr = new std::thread(program_thread::writer_thread, std::ref(g_writer_running),
-                                          std::ref(g_data_writer), std::ref(*g_parameter_store));
+    g_writer_thread_ptr =
+        new std::thread(program_thread::writer_thread, std::ref(g_writer_running), std::ref(g_acquisition_pipeline),
+                        std::ref(g_data_writer), std::ref(*g_parameter_store));
     g_data_acquisition_thread_ptr = new std::thread(
         program_thread::data_acquisition_thread, std::ref(g_data_acquisition_running), std::ref(g_data_acq),
-        std::ref(*g_parameter_store), std::ref(g_event_data), std::ref(g_data_writer));
+        std::ref(*g_parameter_store), std::ref(g_acquisition_pipeline), std::ref(g_event_data),
+        std::ref(g_data_writer));
+    g_convert_thread_ptr = new std::thread(program_thread::convert_thread, std::ref(g_convert_running),
+                                           std::ref(g_acquisition_pipeline), std::ref(g_data_writer));
+    g_ingest_thread_ptr = new std::thread(program_thread::ingest_thread, std::ref(g_ingest_running),
+                                          std::ref(g_acquisition_pipeline), std::ref(g_event_data));
+    g_prefetch_thread_ptr = new std::thread(program_thread::prefetch_thread, std::ref(g_prefetch_running),
+                                            std::ref(*g_parameter_store), std::ref(g_event_data));
 
     return SDL_APP_CONTINUE;
 }
@@ -210,6 +305,16 @@ void SDL_AppQuit(void *appstate, SDL_AppResult result)
     g_data_acquisition_running = false;
     g_data_acquisition_thread_ptr->join();
 
+    // Ensure pipeline threads exit
+    g_convert_running = false;
+    g_convert_thread_ptr->join();
+    g_ingest_running = false;
+    g_ingest_thread_ptr->join();
+
+    // Ensure prefetch thread exits
+    g_prefetch_running = false;
+    g_prefetch_thread_ptr->join();
+
     // Flush file write buffer?
     g_data_writer.clear();
 
@@ -218,6 +323,9 @@ void SDL_AppQuit(void *appstate, SDL_AppResult result)
 
     delete g_writer_thread_ptr;
     delete g_data_acquisition_thread_ptr;
+    delete g_prefetch_thread_ptr;
+    delete g_convert_thread_ptr;
+    delete g_ingest_thread_ptr;
 
     SDL_WaitForGPUIdle(g_gpu_device);
 
@@ -3,6 +3,7 @@
 #define PCH_HH
 
 #include <algorithm>
+#include <cmath>
 #include <cstdlib>
 #include <filesystem>
 #include <fstream>
@@ -2,9 +2,12 @@
 #ifndef THREADS_HH
 #define THREADS_HH
 
+#include "AcquisitionPipeline.hh"
 #include "DataAcquisition.hh"
 #include "DataWriter.hh"
 #include "EventData.hh"
+#include "EventDataCache.hh"
+#include "EventPrefetcher.hh"
 #include "GUI.hh"
 #include "ParameterStore.hh"
 
@@ -12,6 +15,134 @@
 namespace
 {
 
+/**
+ * @brief Sets the storage format and compression of the EventData object from the GUI selection.
+ * @param evt_data EventData object to set storage format of.
+ * @param param_store ParameterStore object that contains global data from GUI.
+ */
+inline void set_evt_format(EventData &evt_data, ParameterStore &param_store)
+{
+    int32_t event_storage_layout{param_store.exists("event_storage_layout")
+                                     ? param_store.get<int32_t>("event_storage_layout")
+                                     : 0};
+    if (event_storage_layout == 1)
+    {
+        evt_data.set_evt_format(EventData::EventFormat::PACKED);
+    }
+    else if (event_storage_layout == 2)
+    {
+        evt_data.set_evt_format(EventData::EventFormat::COLUMNAR);
+    }
+    else
+    {
+        evt_data.set_evt_format(EventData::EventFormat::VEC4);
+    }
+    evt_data.set_evt_compression(param_store.exists("compress_event_history") &&
+                                 param_store.get<bool>("compress_event_history"));
+}
+
+/**
+ * @brief Event data settings last set from the GUI, so they are only set again once they change. Setting them takes
+ *        the event data lock, which the ingest stage takes for every batch.
+ */
+struct EventDataSettings
+{
+        int32_t retention_mode{-1};
+        float retention_limit{-1.0f};
+        int32_t reorder_tolerance{-1};
+        int32_t reset_threshold{-1};
+        int32_t epoch_limit{-1};
+};
+
+/**
+ * @brief Sets the retention mode of the EventData object from the GUI selection, if it changed.
+ * @param evt_data EventData object to set retention mode of.
+ * @param param_store ParameterStore object that contains global data from GUI.
+ * @param applied settings last set, updated.
+ */
+inline void set_evt_retention(EventData &evt_data, ParameterStore &param_store, EventDataSettings &applied)
+{
+    if (!param_store.exists("event_retention_mode") || !param_store.exists("event_retention_limit"))
+    {
+        return;
+    }
+
+    int32_t event_retention_mode{param_store.get<int32_t>("event_retention_mode")};
+    float retention_limit{param_store.get<float>("event_retention_limit")};
+    if (event_retention_mode == applied.retention_mode && retention_limit == applied.retention_limit)
+    {
+        return;
+    }
+    applied.retention_mode = event_retention_mode;
+    applied.retention_limit = retention_limit;
+
+    double event_retention_limit{static_cast<double>(retention_limit)};
+    if (event_retention_mode == 1) // Millions of events
+    {
+        evt_data.set_evt_retention(EventData::RetentionMode::EVENTS, std::llround(event_retention_limit * 1e6));
+    }
+    else if (event_retention_mode == 2) // Seconds, event timestamps are in microseconds
+    {
+        evt_data.set_evt_retention(EventData::RetentionMode::DURATION, std::llround(event_retention_limit * 1e6));
+    }
+    else
+    {
+        evt_data.set_evt_retention(EventData::RetentionMode::UNBOUNDED, 0);
+    }
+}
+
+/**
+ * @brief Sets how out of order event timestamps and camera resets are handled from the GUI settings, if they
+ *        changed.
+ * @param evt_data EventData object to set reorder tolerance of.
+ * @param param_store ParameterStore object that contains global data from GUI.
+ * @param applied settings last set, updated.
+ */
+inline void set_evt_reorder(EventData &evt_data, ParameterStore &param_store, EventDataSettings &applied)
+{
+    if (!param_store.exists("event_reorder_tolerance") || !param_store.exists("event_reset_threshold"))
+    {
+        return;
+    }
+
+    // Both are in microseconds, as event timestamps are
+    int32_t event_reorder_tolerance{param_store.get<int32_t>("event_reorder_tolerance")};
+    int32_t event_reset_threshold{param_store.get<int32_t>("event_reset_threshold")};
+    if (event_reorder_tolerance != applied.reorder_tolerance || event_reset_threshold != applied.reset_threshold)
+    {
+        evt_data.set_evt_reorder(event_reorder_tolerance, event_reset_threshold);
+        applied.reorder_tolerance = event_reorder_tolerance;
+        applied.reset_threshold = event_reset_threshold;
+    }
+
+    // Data from before a camera reset is kept as epochs unless only one epoch is kept
+    if (param_store.exists("event_epoch_limit"))
+    {
+        int32_t event_epoch_limit{std::max(param_store.get<int32_t>("event_epoch_limit"), 0)};
+        if (event_epoch_limit != applied.epoch_limit)
+        {
+            evt_data.set_evt_epoch_limit(static_cast<std::size_t>(event_epoch_limit));
+            applied.epoch_limit = event_epoch_limit;
+        }
+    }
+}
+
+/**
+ * @brief Checks if file data may go through the file cache, which holds every event of a file as it was decoded.
+ *        Not used when events are discarded, evicted or being saved to another file.
+ * @param evt_data EventData object the file is read into.
+ * @param param_store ParameterStore object that contains global data from GUI.
+ * @return true if the file cache may be used, false otherwise.
+ */
+inline bool can_use_file_cache(EventData &evt_data, ParameterStore &param_store)
+{
+    return param_store.exists("use_file_cache") && param_store.get<bool>("use_file_cache") &&
+           param_store.get<float>("event_discard_odds") <= 1.0f &&
+           param_store.get<std::string>("stream_save_file_name") == "" &&
+           evt_data.get_evt_retention_mode() == EventData::RetentionMode::UNBOUNDED &&
+           evt_data.get_evt_begin_index() == 0;
+}
+
 /**
  * @brief Sets up the DataWriter object for writing data to a file.
  * @param data_acq DataAcquisition object that will write data to DataWriter.
@@ -96,32 +227,83 @@ namespace program_thread
 /**
  * @brief Thread for writing data back to persistent storage when streaming.
  * @param running Atomic boolean that determines if thread is running or not.
+ * @param pipeline AcquisitionPipeline object to take data to save from, its write fan-out stage.
  * @param data_writer DataWriter object to write data with.
  * @param param_store ParameterStore object containing global data.
  *
  */
 
-inline void writer_thread(std::atomic<bool> &running, DataWriter &data_writer, ParameterStore &param_store)
+inline void writer_thread(std::atomic<bool> &running, AcquisitionPipeline &pipeline, DataWriter &data_writer,
+                          ParameterStore &param_store)
 {
     // For now let us spin
     while (running)
     {
+        while (pipeline.writer_step(data_writer))
+        {
+        }
         data_writer.write_event_store(param_store);
         data_writer.write_frame_data(param_store);
     }
 }
 
+/**
+ * @brief Thread for converting data read by the data acquisition thread, the convert stage of the pipeline.
+ * @param running Atomic boolean that determines if thread is running or not.
+ * @param pipeline AcquisitionPipeline object to convert data of.
+ * @param data_writer DataWriter object that decides what data is saved.
+ */
+inline void convert_thread(std::atomic<bool> &running, AcquisitionPipeline &pipeline, DataWriter &data_writer)
+{
+    while (running)
+    {
+        if (!pipeline.convert_step(data_writer))
+        {
+            // Nothing read, or the next stages are full
+            std::this_thread::sleep_for(std::chrono::microseconds(200));
+        }
+    }
+}
+
+/**
+ * @brief Thread for storing converted data into event data, the ingest stage of the pipeline.
+ * @param running Atomic boolean that determines if thread is running or not.
+ * @param pipeline AcquisitionPipeline object to store data of.
+ * @param evt_data EventData object to store event/frame data into for drawing.
+ */
+inline void ingest_thread(std::atomic<bool> &running, AcquisitionPipeline &pipeline, EventData &evt_data)
+{
+    while (running)
+    {
+        if (!pipeline.ingest_step(evt_data))
+        {
+            std::this_thread::sleep_for(std::chrono::microseconds(200));
+        }
+    }
+}
+
 /**
  * @brief Thread for data acquisition, storing into event_data
  * @param running Atomic boolean that determines if thread is running or not.
  * @param param_store ParameterStore object to get GUI info from.
+ * @param pipeline AcquisitionPipeline object to hand data read to, the reader is its first stage.
  * @param evt_data EventData object to store event/frame data into for drawing.
  * @param data_writer DataWriter object to store event/frame data into to be saved to persistent storage.
  */
 // Thread for data acquisition, storing into event_data
 inline void data_acquisition_thread(std::atomic<bool> &running, DataAcquisition &data_acq, ParameterStore &param_store,
-                                    EventData &evt_data, DataWriter &data_writer)
+                                    AcquisitionPipeline &pipeline, EventData &evt_data, DataWriter &data_writer)
 {
+    // True while a file is decoded that should be saved to the file cache once fully read
+    bool file_cache_pending{false};
+    // True once events held for reordering were stored after the whole file was
+    bool file_flushed{false};
+
+    // Settings and stats go through the event data lock, which the ingest stage takes for every batch
+    EventDataSettings applied_settings{};
+    constexpr std::chrono::milliseconds STATS_INTERVAL{100}; // The GUI shows stats once per frame at most
+    std::chrono::steady_clock::time_point last_stats_time{};
+
     while (running)
     {
         // These always run
@@ -132,6 +314,22 @@ inline void data_acquisition_thread(std::atomic<bool> &running, DataAcquisition
             param_store.add("start_camera_scan", false);
         }
 
+        // Retention can change while streaming, it applies as new events come in
+        set_evt_retention(evt_data, param_store, applied_settings);
+        set_evt_reorder(evt_data, param_store, applied_settings);
+        const auto now = std::chrono::steady_clock::now();
+        if (now - last_stats_time >= STATS_INTERVAL)
+        {
+            param_store.add("event_reorder_stats", evt_data.get_reorder_stats());
+            param_store.add("sealed_event_usage", evt_data.get_sealed_evt_usage());
+            param_store.add("event_rate", evt_data.get_latest_evt_rate(1000000)); // Over the last second
+            param_store.add("acquisition_stage_stats", pipeline.get_stage_stats());
+            last_stats_time = now;
+        }
+
+        // Waits before the next pass when nothing was read, as the next stages do
+        bool data_read{false};
+
         // DATA ACQUISITION CODE
         if (param_store.exists("program_state"))
         {
@@ -150,8 +348,22 @@ inline void data_acquisition_thread(std::atomic<bool> &running, DataAcquisition
                     {
                         data_acq.clear_reader();
                         std::string stream_file_name{param_store.get<std::string>("stream_file_name")};
-                        evt_data.clear();
-                        bool init_success{data_acq.init_file_reader(stream_file_name, param_store)};
+                        pipeline.invalidate(evt_data); // Batches of the previous source still in flight are dropped
+                        set_evt_format(evt_data, param_store);
+
+                        // Several files or a directory are read as one session, as is a file decoded on demand
+                        std::vector<std::string> session_paths{
+                            param_store.exists("stream_session_paths")
+                                ? param_store.get<std::vector<std::string>>("stream_session_paths")
+                                : std::vector<std::string>{}};
+                        if (session_paths.empty() && param_store.exists("stream_decode_on_demand") &&
+                            param_store.get<bool>("stream_decode_on_demand"))
+                        {
+                            session_paths.push_back(stream_file_name);
+                        }
+                        bool init_success{session_paths.empty()
+                                              ? data_acq.init_file_reader(stream_file_name, param_store)
+                                              : data_acq.init_session_reader(session_paths, param_store)};
                         if (init_success)
                         {
                             data_acq.get_camera_event_resolution(evt_data);
@@ -159,6 +371,27 @@ inline void data_acquisition_thread(std::atomic<bool> &running, DataAcquisition
                             param_store.add("stream_file_changed", false);
                             param_store.add("resolution_initialized", true); // Need to communicate with DCE
                         }
+                        param_store.add("stream_session_duration", data_acq.get_session_duration());
+                        if (init_success && !session_paths.empty())
+                        {
+                            // Chunks are decoded as the time window reaches them, which only moves in time scrubbing
+                            param_store.add("scrubber.type", Scrubber::ScrubberType::TIME);
+                        }
+
+                        // Map a previously decoded copy of the file instead of decoding it again
+                        file_cache_pending = false;
+                        file_flushed = false;
+                        if (init_success && session_paths.empty() && can_use_file_cache(evt_data, param_store))
+                        {
+                            if (EventDataCache::load(stream_file_name, evt_data))
+                            {
+                                data_acq.clear_reader(); // Nothing left to read
+                            }
+                            else
+                            {
+                                file_cache_pending = true;
+                            }
+                        }
 
                         data_writer.clear();
                         // Set for nothing saved for now, setup_writer will update it
@@ -172,14 +405,43 @@ inline void data_acquisition_thread(std::atomic<bool> &running, DataAcquisition
                         }
                     }
 
-                    // Check if stream is paused
+                    // Chunks of a session are decoded when the scrubber window reaches them, whether paused or not
                     bool stream_paused{param_store.get<bool>("stream_paused")};
-                    if (!stream_paused)
+                    bool session_open{data_acq.is_session_open()};
+                    if (session_open && param_store.exists("scrubber.current_time") &&
+                        param_store.exists("scrubber.time_window"))
+                    {
+                        int64_t current_time{param_store.get<int64_t>("scrubber.current_time")};
+                        int64_t time_window{param_store.get<int64_t>("scrubber.time_window")};
+                        data_read = data_acq.decode_session_chunk(pipeline, evt_data, param_store,
+                                                                  current_time - time_window, current_time,
+                                                                  param_store.get<float>("event_discard_odds"));
+                    }
+                    // Check if stream is paused
+                    else if (!session_open && !stream_paused)
+                    {
+                        // Read data in batches, the pipeline converts and stores them
+                        data_read =
+                            data_acq.read_batch(pipeline, param_store, param_store.get<float>("event_discard_odds"));
+                    }
+
+                    // Nothing can arrive after the end of the file to reorder held events with, once it is stored
+                    bool file_stored{data_acq.is_reader_finished() && pipeline.is_drained()};
+                    if (file_stored && !file_flushed)
+                    {
+                        evt_data.flush_evt_data();
+                        file_flushed = true;
+                    }
+
+                    // Settings may change while the file is read, only a complete copy of the file is cached
+                    if (file_cache_pending && !can_use_file_cache(evt_data, param_store))
+                    {
+                        file_cache_pending = false;
+                    }
+                    if (file_cache_pending && file_stored)
                     {
-                        // Get event/frame data in batches every frame
-                        data_acq.get_batch_evt_data(evt_data, param_store, data_writer,
-                                                    param_store.get<float>("event_discard_odds"));
-                        data_acq.get_batch_frame_data(evt_data, param_store, data_writer);
+                        EventDataCache::save(param_store.get<std::string>("stream_file_name"), evt_data);
+                        file_cache_pending = false;
                     }
                 }
                 break;
@@ -194,7 +456,9 @@ inline void data_acquisition_thread(std::atomic<bool> &running, DataAcquisition
                     if (param_store.get<bool>("camera_changed"))
                     {
                         data_acq.clear_reader();
-                        evt_data.clear();
+                        pipeline.invalidate(evt_data);
+                        set_evt_format(evt_data, param_store);
+                        param_store.add("stream_session_duration", static_cast<int64_t>(-1));
 
                         bool init_success{
                             data_acq.init_camera_reader(param_store.get<int32_t>("camera_index"), param_store)};
@@ -222,10 +486,9 @@ inline void data_acquisition_thread(std::atomic<bool> &running, DataAcquisition
                     bool camera_stream_paused{param_store.get<bool>("camera_stream_paused")};
                     if (!camera_stream_paused)
                     {
-                        // Get event/frame data in batches every frame
-                        data_acq.get_batch_evt_data(evt_data, param_store, data_writer,
-                                                    param_store.get<float>("event_discard_odds"));
-                        data_acq.get_batch_frame_data(evt_data, param_store, data_writer);
+                        // Read data in batches, the pipeline converts and stores them
+                        data_read =
+                            data_acq.read_batch(pipeline, param_store, param_store.get<float>("event_discard_odds"));
                     }
                 }
                 break;
@@ -237,9 +500,43 @@ inline void data_acquisition_thread(std::atomic<bool> &running, DataAcquisition
 
                 // Clear data acq
                 data_acq.clear_reader();
+                param_store.add("stream_session_duration", static_cast<int64_t>(-1));
+                file_cache_pending = false;
+                file_flushed = false;
                 break;
             }
         }
+
+        if (!data_read)
+        {
+            // Nothing read, or the pipeline is full
+            std::this_thread::sleep_for(std::chrono::microseconds(200));
+        }
+    }
+}
+
+/**
+ * @brief Thread for reading event data ahead of the scrubber, so the render thread does not wait on disk.
+ * @param running Atomic boolean that determines if thread is running or not.
+ * @param param_store ParameterStore object to get the scrubber window from.
+ * @param evt_data EventData object to prefetch event data of.
+ */
+inline void prefetch_thread(std::atomic<bool> &running, ParameterStore &param_store, EventData &evt_data)
+{
+    EventPrefetcher prefetcher{evt_data};
+    while (running)
+    {
+        if (param_store.exists("scrubber.current_index") && param_store.exists("scrubber.index_window"))
+        {
+            std::size_t current_index{param_store.get<std::size_t>("scrubber.current_index")};
+            std::size_t index_window{param_store.get<std::size_t>("scrubber.index_window")};
+            prefetcher.update(current_index - std::min(index_window, current_index), current_index,
+                              std::chrono::steady_clock::now());
+            param_store.add("prefetch_velocity", prefetcher.get_velocity());
+        }
+
+        // About twice per displayed frame, the scrubber moves once per frame
+        std::this_thread::sleep_for(std::chrono::milliseconds(8));
     }
 }
 } // namespace program_thread
@@ -1,3 +1,4 @@
+#include "../src/AcquisitionPipeline.hh"
 #include "../src/DataAcquisition.hh"
 #include "../src/DataWriter.hh"
 #include "../src/EventData.hh"
@@ -10,12 +11,11 @@
 int32_t check_order_events(EventData &evt_data)
 {
     evt_data.lock_data_vectors();
-    const auto &evt_vector{evt_data.get_evt_vector_ref()};
 
-    for (int32_t i{1}; i < evt_vector.size(); ++i)
+    for (int32_t i{1}; i < evt_data.get_evt_count(); ++i)
     {
         // Out of order timestamps detected in event data
-        if (evt_vector[i - 1].z > evt_vector[i].z)
+        if (evt_data.get_evt_relative_time(i - 1) > evt_data.get_evt_relative_time(i))
         {
             return i;
         }
@@ -30,12 +30,12 @@ int32_t check_order_frames(EventData &evt_data)
 {
     evt_data.lock_data_vectors();
 
-    const auto &frame_vector{evt_data.get_frame_vector_ref()};
+    const auto &frame_store{evt_data.get_frame_store_ref()};
 
-    for (int32_t i{1}; i < frame_vector.size(); ++i)
+    for (int32_t i{1}; i < frame_store.size(); ++i)
     {
         // Out of order timestamps detected in event data
-        if (frame_vector[i - 1].second > frame_vector[i].second)
+        if (frame_store.timestamp(i - 1) > frame_store.timestamp(i))
         {
             return i;
         }
@@ -51,12 +51,11 @@ int32_t check_event_data_equality(EventData &evt_data1, EventData &evt_data2)
 {
     evt_data1.lock_data_vectors();
     evt_data2.lock_data_vectors();
-    const auto &evt_vector1{evt_data1.get_evt_vector_ref()};
-    const auto &evt_vector2{evt_data2.get_evt_vector_ref()};
 
-    for (int32_t i{0}; i < evt_vector1.size(); ++i)
+    for (int32_t i{0}; i < evt_data1.get_evt_count(); ++i)
     {
-        if (evt_vector1[i] != evt_vector2[i])
+        if (evt_data1.get_evt(i) != evt_data2.get_evt(i) ||
+            evt_data1.get_evt_relative_time(i) != evt_data2.get_evt_relative_time(i))
         {
             return i;
         }
@@ -72,20 +71,22 @@ int32_t check_frame_data_equality(EventData &evt_data1, EventData &evt_data2)
 {
     evt_data1.lock_data_vectors();
     evt_data2.lock_data_vectors();
-    const auto &frame_vector1{evt_data1.get_frame_vector_ref()};
-    const auto &frame_vector2{evt_data2.get_frame_vector_ref()};
+    auto &frame_store1{evt_data1.get_frame_store_ref()};
+    auto &frame_store2{evt_data2.get_frame_store_ref()};
 
-    for (int32_t i{0}; i < frame_vector1.size(); ++i)
+    for (int32_t i{0}; i < frame_store1.size(); ++i)
     {
         // Check equality of cv matrices
-        auto rows{(frame_vector1[i].first).rows};
-        auto cols{(frame_vector1[i].first).cols};
+        cv::Mat frame1{frame_store1.frame(i)};
+        cv::Mat frame2{frame_store2.frame(i)};
+        auto rows{frame1.rows};
+        auto cols{frame1.cols};
         bool unequal{false};
         for (int32_t row{0}; row < rows; ++row)
         {
             for (int32_t col{0}; col < cols; ++col)
             {
-                if (frame_vector1[i].first.at<char>(row, col) != frame_vector2[i].first.at<char>(row, col))
+                if (frame1.at<char>(row, col) != frame2.at<char>(row, col))
                 {
                     unequal = true;
                     break;
@@ -98,7 +99,7 @@ int32_t check_frame_data_equality(EventData &evt_data1, EventData &evt_data2)
         }
 
         // Unequal condition met
-        if (unequal || frame_vector1[i].second != frame_vector2[i].second)
+        if (unequal || frame_store1.timestamp(i) != frame_store2.timestamp(i))
         {
             return i;
         }
@@ -108,9 +109,35 @@ int32_t check_frame_data_equality(EventData &evt_data1, EventData &evt_data2)
     return -1;
 }
 
+// Function to read everything the reader provides, running every stage of the pipeline on this thread.
+// Returns true if any data was read.
+bool read_all(DataAcquisition &data_acq, AcquisitionPipeline &pipeline, ParameterStore &param_store,
+              EventData &evt_data, DataWriter &data_writer)
+{
+    bool data_read{false};
+    while (true)
+    {
+        bool batch_read{data_acq.read_batch(pipeline, param_store, 1.0f)};
+        data_read = data_read || batch_read;
+        while (pipeline.convert_step(data_writer) || pipeline.ingest_step(evt_data) ||
+               pipeline.writer_step(data_writer))
+        {
+        }
+        if (!batch_read && pipeline.is_drained())
+        {
+            break;
+        }
+    }
+
+    // Nothing comes after the end of the file, events held for reordering are stored
+    evt_data.flush_evt_data();
+    return data_read;
+}
+
 TEST(DataAcquisition, reading)
 {
     DataAcquisition data_acq{};
+    AcquisitionPipeline pipeline{};
     ParameterStore param_store{};
     EventData evt_data{};
     DataWriter data_writer{};
@@ -123,9 +150,7 @@ TEST(DataAcquisition, reading)
     ASSERT_EQ(param_store.get<std::string>("pop_up_err_str"),
               "Something went wrong while initializing file for reading!")
         << "Wrong error message for non-existent file";
-    ASSERT_EQ(data_acq.get_batch_evt_data(evt_data, param_store, data_writer, 1.0f) ||
-                  data_acq.get_batch_frame_data(evt_data, param_store, data_writer),
-              false)
+    ASSERT_EQ(read_all(data_acq, pipeline, param_store, evt_data, data_writer), false)
         << "Somehow read data from non-existent file";
 
     // Ensure non-aedat file case is handled
@@ -133,18 +158,13 @@ TEST(DataAcquisition, reading)
         << "Non-aedat4 file successfully initialized";
     ASSERT_EQ(param_store.get<std::string>("pop_up_err_str"), "File extension is not .aedat4!")
         << "Wrong error message for non-aedat4 file";
-    ASSERT_EQ(data_acq.get_batch_evt_data(evt_data, param_store, data_writer, 1.0f) ||
-                  data_acq.get_batch_frame_data(evt_data, param_store, data_writer),
-              false)
+    ASSERT_EQ(read_all(data_acq, pipeline, param_store, evt_data, data_writer), false)
         << "Somehow read data from non-aedat4 file";
 
     ASSERT_EQ(data_acq.init_file_reader("../testing/test_data.aedat4", param_store), true)
         << "Failed to initialize file for reading: " << param_store.get<std::string>("pop_up_err_str");
 
-    while (data_acq.get_batch_evt_data(evt_data, param_store, data_writer, 1.0f) ||
-           data_acq.get_batch_frame_data(evt_data, param_store, data_writer))
-    {
-    }
+    ASSERT_EQ(read_all(data_acq, pipeline, param_store, evt_data, data_writer), true) << "Read no data from file";
 
     // Check order of timestamps, by aedat standard, should be ordered.
     int32_t evt_ordered{check_order_events(evt_data)};
@@ -156,6 +176,7 @@ TEST(DataAcquisition, reading)
 TEST(DataWriter, writing)
 {
     DataAcquisition data_acq{};
+    AcquisitionPipeline pipeline{};
     ParameterStore param_store{};
     EventData evt_data{};
     DataWriter data_writer{};
@@ -174,10 +195,7 @@ TEST(DataWriter, writing)
         << "Failed to initialize data writer: " << param_store.get<std::string>("pop_up_err_str");
 
     // Will get data and write it at the same time
-    while (data_acq.get_batch_evt_data(evt_data, param_store, data_writer, 1.0f) ||
-           data_acq.get_batch_frame_data(evt_data, param_store, data_writer))
-    {
-    }
+    ASSERT_EQ(read_all(data_acq, pipeline, param_store, evt_data, data_writer), true) << "Read no data from file";
 
     // Check order of timestamps, by aedat standard, should be ordered.
     int32_t evt_ordered{check_order_events(evt_data)};
@@ -194,6 +212,7 @@ TEST(DataWriter, writing)
 
     // Check that newly written file's data matches original file
     DataAcquisition data_acq_out{};
+    AcquisitionPipeline pipeline_out{};
     EventData evt_data_out{};
 
     // Initialize output file for reading
@@ -201,10 +220,8 @@ TEST(DataWriter, writing)
         << "Failed to initialize file output for reading: " << param_store.get<std::string>("pop_up_err_str");
 
     // Will get data and write it at the same time
-    while (data_acq_out.get_batch_evt_data(evt_data_out, param_store, data_writer, 1.0f) ||
-           data_acq_out.get_batch_frame_data(evt_data_out, param_store, data_writer))
-    {
-    }
+    ASSERT_EQ(read_all(data_acq_out, pipeline_out, param_store, evt_data_out, data_writer), true)
+        << "Read no data from output file";
 
     // Check order of timestamps, by aedat standard, should be ordered.
     int32_t evt_ordered_out{check_order_events(evt_data_out)};
@@ -217,4 +234,85 @@ TEST(DataWriter, writing)
     EXPECT_EQ(evt_equality, -1) << "Unequal events at: " << evt_equality;
     int32_t frame_equality{check_frame_data_equality(evt_data, evt_data_out)};
     EXPECT_EQ(frame_equality, -1) << "Unequal frames at: " << frame_equality;
+}
+
+// Test a session cuts the packet table into chunks covering the file, and decodes and evicts chunks as the window
+// moves
+TEST(RecordingSession, chunking)
+{
+    DataAcquisition data_acq{};
+    AcquisitionPipeline pipeline{};
+    ParameterStore param_store{};
+    EventData evt_data{};
+    DataWriter data_writer{};
+
+    param_store.add("pop_up_err_str", "");
+
+    // Events of the file read as a whole
+    ASSERT_EQ(data_acq.init_file_reader("../testing/test_data.aedat4", param_store), true)
+        << "Failed to initialize file for reading: " << param_store.get<std::string>("pop_up_err_str");
+    ASSERT_EQ(read_all(data_acq, pipeline, param_store, evt_data, data_writer), true) << "Read no data from file";
+    const int64_t file_evt_count{static_cast<int64_t>(evt_data.get_evt_count())};
+
+    // One packet per chunk, every chunk before the window is evicted
+    RecordingSession session{1, 1};
+    ASSERT_EQ(session.open({"non-existent-file.aedat4"}), false) << "Non-existent file opened as a session";
+    ASSERT_EQ(session.open({"../testing/test_data.aedat4"}), true) << "Failed to open file as a session";
+    const std::vector<RecordingSession::Chunk> &chunks{session.get_chunks()};
+    ASSERT_GT(chunks.size(), 2) << "Test data not cut into chunks by its packet table";
+
+    int64_t chunk_evt_count{0};
+    for (std::size_t i{0}; i < chunks.size(); ++i)
+    {
+        EXPECT_LT(chunks[i].start_time, chunks[i].end_time) << "Empty chunk at: " << i;
+        EXPECT_GT(chunks[i].evt_count, 0) << "Chunk without events at: " << i;
+        if (i + 1 < chunks.size())
+        {
+            EXPECT_EQ(chunks[i].end_time, chunks[i + 1].start_time) << "Chunks not contiguous at: " << i;
+        }
+        chunk_evt_count += chunks[i].evt_count;
+    }
+    EXPECT_EQ(chunk_evt_count, file_evt_count) << "Chunk event counts do not add up to the file";
+    EXPECT_EQ(session.get_duration(), chunks.back().end_time - chunks.front().start_time);
+
+    EventData session_data{};
+    const int64_t base{session.get_start_time()};
+    const int64_t second_start{chunks[1].start_time - base};
+
+    // First window starts over at its first chunk
+    std::size_t chunk{session.next_chunk(session_data, 0, 0)};
+    EXPECT_EQ(chunk, 0) << "First window not decoded from its first chunk";
+    session.finish_chunk(session_data, chunk);
+    EXPECT_EQ(session.next_chunk(session_data, 0, 0), RecordingSession::NO_CHUNK) << "Decoded window decoded again";
+    EXPECT_EQ(session.get_resident_chunks(), (std::pair<std::size_t, std::size_t>{0, 1}));
+
+    // Window past the decoded chunks continues after them and evicts the chunk before it
+    chunk = session.next_chunk(session_data, second_start, second_start);
+    EXPECT_EQ(chunk, 1) << "Next window not continued after the decoded chunks";
+    EXPECT_EQ(session.get_resident_chunks(), (std::pair<std::size_t, std::size_t>{1, 1}))
+        << "Chunk before the window not evicted";
+    session.finish_chunk(session_data, chunk);
+    EXPECT_EQ(session.get_resident_chunks(), (std::pair<std::size_t, std::size_t>{1, 2}));
+
+    // Window before the decoded chunks starts over
+    chunk = session.next_chunk(session_data, 0, 0);
+    EXPECT_EQ(chunk, 0) << "Seek back not started over at the window";
+    EXPECT_EQ(session.get_resident_chunks(), (std::pair<std::size_t, std::size_t>{0, 0}));
+
+    // Whole session decoded through the reader holds every event of the file
+    ASSERT_EQ(data_acq.init_session_reader({"../testing/test_data.aedat4"}, param_store), true)
+        << "Failed to open session: " << param_store.get<std::string>("pop_up_err_str");
+    const int64_t duration{data_acq.get_session_duration()};
+    EventData decoded_data{};
+    while (data_acq.decode_session_chunk(pipeline, decoded_data, param_store, 0, duration, 1.0f))
+    {
+        while (pipeline.convert_step(data_writer) || pipeline.ingest_step(decoded_data) ||
+               pipeline.writer_step(data_writer))
+        {
+        }
+    }
+    EXPECT_EQ(static_cast<int64_t>(decoded_data.get_evt_count()), file_evt_count)
+        << "Decoded session does not hold every event";
+    int32_t evt_ordered{check_order_events(decoded_data)};
+    EXPECT_EQ(evt_ordered, -1) << "Events are out of order at: " << evt_ordered;
 }
\ No newline at end of file
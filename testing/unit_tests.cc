@@ -1,7 +1,13 @@
 #include "../src/EventData.hh"
+#include "../src/EventDataCache.hh"
+#include "../src/EventPrefetcher.hh"
+#include "../src/MultiSourceEventData.hh"
 #include "../src/ParameterStore.hh"
+#include "../src/SpscRing.hh"
+#include <atomic>
 #include <gtest/gtest.h>
 #include <iostream>
+#include <thread>
 
 // Test settings and getting camera resolutions
 TEST(EventData, CameraResolution)
@@ -113,7 +119,7 @@ TEST(EventData, write_frame_data)
     test_ed.write_frame_data(frame_datum);
     {
         test_ed.lock_data_vectors();
-        const auto &frame_data_vec{test_ed.get_frame_vector_ref()};
+        const auto &frame_data_vec{test_ed.get_frame_store_ref()};
         ASSERT_EQ(frame_data_vec.size(), 0) << "Frame data written even though no event data to be relative to.";
         test_ed.unlock_data_vectors();
     }
@@ -131,11 +137,11 @@ TEST(EventData, write_frame_data)
     // Test event data is written in order
     {
         test_ed.lock_data_vectors();
-        const auto &frame_data_vec{test_ed.get_frame_vector_ref()};
+        const auto &frame_data_vec{test_ed.get_frame_store_ref()};
         ASSERT_EQ(frame_data_vec.size(), NUM_ELEMENTS) << "Internal frame data size mismatch.";
         for (int32_t i{0}; i < NUM_ELEMENTS; ++i)
         {
-            auto curr_timestamp{frame_data_vec[i].second};
+            auto curr_timestamp{frame_data_vec.timestamp(i)};
             EXPECT_EQ(curr_timestamp, i) << "Out of order writing of frame data at " << i;
         }
 
@@ -153,12 +159,12 @@ TEST(EventData, write_frame_data)
     }
     {
         test_ed.lock_data_vectors();
-        const auto &frame_data_vec{test_ed.get_frame_vector_ref()};
+        const auto &frame_data_vec{test_ed.get_frame_store_ref()};
         ASSERT_EQ(frame_data_vec.size(), NUM_ELEMENTS)
             << "Internal frame data size mismatch when testing relative timestamps.";
         for (int32_t i{0}; i < NUM_ELEMENTS; ++i)
         {
-            auto curr_timestamp{frame_data_vec[i].second};
+            auto curr_timestamp{frame_data_vec.timestamp(i)};
             EXPECT_EQ(curr_timestamp, i) << "Out of order writing of frame data at " << i
                                          << " when testing relative timestamps.";
         }
@@ -174,7 +180,7 @@ TEST(EventData, write_frame_data)
         out_of_order_datum); // Write again so write succeeds with timestamps relative to event data
     {
         test_ed.lock_data_vectors();
-        const auto &frame_data_vec{test_ed.get_frame_vector_ref()};
+        const auto &frame_data_vec{test_ed.get_frame_store_ref()};
         EXPECT_EQ(frame_data_vec.size(), 1)
             << "Out of order writing of event data did not clear vector"; // Should have cleared vector before inserting
         test_ed.unlock_data_vectors();
@@ -189,11 +195,11 @@ TEST(EventData, write_frame_data)
     // Test event data is written in order
     {
         test_ed.lock_data_vectors();
-        const auto &frame_data_vec{test_ed.get_frame_vector_ref()};
+        const auto &frame_data_vec{test_ed.get_frame_store_ref()};
         ASSERT_EQ(frame_data_vec.size(), NUM_ELEMENTS) << "Internal frame data size mismatch after reset.";
         for (int32_t i{0}; i < NUM_ELEMENTS; ++i)
         {
-            auto curr_timestamp{frame_data_vec[i].second};
+            auto curr_timestamp{frame_data_vec.timestamp(i)};
             EXPECT_EQ(curr_timestamp, i) << "Out of order writing of frame data at " << i << " after reset.";
         }
 
@@ -268,6 +274,1400 @@ TEST(EventData, get_event_index_from_timestamp)
     }
 }
 
+// Test chunked event storage across chunk boundaries
+TEST(EventData, MappedEventBufferChunks)
+{
+    EventData::MappedEventBuffer<glm::vec4> buffer{};
+    constexpr std::size_t CHUNK{EventData::MappedEventBuffer<glm::vec4>::kChunkCapacity};
+    constexpr std::size_t NUM_ELEMENTS{CHUNK + CHUNK / 2};
+
+    buffer.push_back(glm::vec4(0, 0, 0, 0));
+    const glm::vec4 *first_address{&buffer[0]};
+
+    for (std::size_t i{1}; i < NUM_ELEMENTS; ++i)
+    {
+        buffer.push_back(glm::vec4(0, 0, static_cast<float>(i), 0));
+    }
+
+    ASSERT_EQ(buffer.size(), NUM_ELEMENTS) << "Chunked buffer size mismatch.";
+    EXPECT_EQ(buffer.chunk_count(), 2) << "Chunked buffer should span two chunks.";
+    EXPECT_EQ(&buffer[0], first_address) << "Element address changed after growth.";
+    EXPECT_EQ(buffer.chunk_span(0).size(), CHUNK) << "First chunk should be full.";
+    EXPECT_EQ(buffer.chunk_span(1).size(), CHUNK / 2) << "Second chunk should be half full.";
+    EXPECT_EQ(buffer.back().z, static_cast<float>(NUM_ELEMENTS - 1)) << "Last element mismatch.";
+
+    // Spans covering a range that straddles the chunk boundary
+    std::vector<std::size_t> span_sizes{};
+    std::size_t expected_index{CHUNK - 10};
+    buffer.for_each_span(CHUNK - 10, CHUNK + 10, [&](std::span<const glm::vec4> span) {
+        span_sizes.push_back(span.size());
+        for (const glm::vec4 &evt : span)
+        {
+            EXPECT_EQ(evt.z, static_cast<float>(expected_index)) << "Span element mismatch at " << expected_index;
+            ++expected_index;
+        }
+    });
+    EXPECT_EQ(span_sizes, (std::vector<std::size_t>{10, 10})) << "Range should be split at chunk boundary.";
+
+    // Binary search through the chunked iterators
+    auto lb = std::lower_bound(buffer.begin(), buffer.end(), glm::vec4(0, 0, static_cast<float>(CHUNK + 3), 0),
+                               event_less_vec4_t);
+    EXPECT_EQ(std::distance(buffer.begin(), lb), CHUNK + 3) << "lower_bound across chunks mismatch.";
+}
+
+// Test compact packed event storage
+TEST(EventData, PackedEventFormat)
+{
+    EXPECT_EQ(sizeof(EventData::PackedEvent), 8) << "Packed event should be 8 bytes.";
+
+    EventData test_ed{};
+    test_ed.write_evt_data(EventData::EventDatum{.x = 1, .y = 1, .timestamp = 10, .polarity = 1});
+    test_ed.set_evt_format(EventData::EventFormat::PACKED);
+    EXPECT_EQ(test_ed.get_evt_format(), EventData::EventFormat::PACKED) << "Event format not set.";
+    EXPECT_EQ(test_ed.get_earliest_evt_timestamp(), -1) << "Changing event format should clear data.";
+
+    constexpr int32_t NUM_ELEMENTS{5};
+    for (int32_t i{0}; i < NUM_ELEMENTS; ++i)
+    {
+        EventData::EventDatum evt_datum{.x = 640 + i, .y = 480 + i, .timestamp = 100 + 2 * i,
+                                        .polarity = static_cast<uint8_t>(i % 2)};
+        test_ed.write_evt_data(evt_datum);
+    }
+
+    {
+        test_ed.lock_data_vectors();
+        ASSERT_EQ(test_ed.get_evt_count(), NUM_ELEMENTS) << "Packed event data size mismatch.";
+        EXPECT_TRUE(test_ed.get_evt_vector_ref().empty()) << "vec4 buffer should be unused in packed format.";
+        EXPECT_EQ(test_ed.get_evt_element_size(), sizeof(EventData::PackedEvent)) << "Element size mismatch.";
+        for (int32_t i{0}; i < NUM_ELEMENTS; ++i)
+        {
+            EXPECT_EQ(test_ed.get_evt(i), glm::vec4(640 + i, 480 + i, 2 * i, i % 2))
+                << "Packed event decode mismatch at " << i;
+        }
+
+        std::size_t num_bytes{0};
+        test_ed.for_each_evt_span(0, NUM_ELEMENTS, 0,
+                                  [&](std::span<const std::byte> span) { num_bytes += span.size_bytes(); });
+        EXPECT_EQ(num_bytes, NUM_ELEMENTS * sizeof(EventData::PackedEvent)) << "Packed span byte size mismatch.";
+        test_ed.unlock_data_vectors();
+    }
+
+    EXPECT_EQ(test_ed.get_event_index_from_relative_timestamp(3), 2) << "Packed timestamp search mismatch.";
+    EXPECT_EQ(test_ed.get_event_index_from_relative_timestamp(9), -1) << "Expected -1 past last packed timestamp.";
+
+    // Relative time beyond 31 bits starts a new time segment instead of overflowing
+    test_ed.write_evt_data(EventData::EventDatum{.x = 0, .y = 0, .timestamp = 100 + (int64_t{1} << 31), .polarity = 0});
+    EXPECT_EQ(test_ed.get_earliest_evt_timestamp(), 100) << "Packed time overflow should not reset.";
+    test_ed.lock_data_vectors();
+    EXPECT_EQ(test_ed.get_evt_relative_time(NUM_ELEMENTS), int64_t{1} << 31) << "Packed time overflow mismatch.";
+    test_ed.unlock_data_vectors();
+}
+
+// Test timestamps stay exact on recordings longer than a float can resolve to the microsecond
+TEST(EventData, LongRecordingPrecision)
+{
+    EventData test_ed{};
+
+    // Two hours of events, one every 3 seconds plus one microsecond
+    constexpr int64_t BASE_TIMESTAMP{1'000'000'000'000};
+    constexpr int64_t EVENT_PERIOD{3'000'001};
+    constexpr int32_t NUM_ELEMENTS{2400};
+    for (int32_t i{0}; i < NUM_ELEMENTS; ++i)
+    {
+        EventData::EventDatum evt_datum{.x = i % 640, .y = i % 480, .timestamp = BASE_TIMESTAMP + i * EVENT_PERIOD,
+                                        .polarity = 1};
+        test_ed.write_evt_data(evt_datum);
+    }
+
+    test_ed.lock_data_vectors();
+    ASSERT_EQ(test_ed.get_evt_count(), NUM_ELEMENTS) << "Event data size mismatch.";
+    EXPECT_GT(test_ed.get_evt_time_segments_ref().size(), 1) << "Long recording should span several time segments.";
+    for (int32_t i{0}; i < NUM_ELEMENTS; ++i)
+    {
+        ASSERT_EQ(test_ed.get_evt_relative_time(i), i * EVENT_PERIOD) << "Relative timestamp not exact at " << i;
+    }
+
+    // Rebased spans across segment boundaries give offsets from the requested time base
+    constexpr std::size_t FIRST{1000};
+    constexpr std::size_t LAST{1100};
+    const int64_t time_base{test_ed.get_evt_time_base(FIRST)};
+    std::vector<glm::vec4> uploaded{};
+    test_ed.for_each_evt_span(FIRST, LAST, time_base, [&](std::span<const std::byte> span) {
+        const auto *evts{reinterpret_cast<const glm::vec4 *>(span.data())};
+        uploaded.insert(uploaded.end(), evts, evts + span.size_bytes() / sizeof(glm::vec4));
+    });
+    ASSERT_EQ(uploaded.size(), LAST - FIRST) << "Rebased span size mismatch.";
+    for (std::size_t i{FIRST}; i < LAST; ++i)
+    {
+        EXPECT_EQ(uploaded[i - FIRST].z, static_cast<float>(test_ed.get_evt_relative_time(i) - time_base))
+            << "Rebased time mismatch at " << i;
+    }
+    test_ed.unlock_data_vectors();
+
+    // Lookups resolve single microseconds late in the recording
+    const int64_t last_time{(NUM_ELEMENTS - 1) * EVENT_PERIOD};
+    EXPECT_EQ(test_ed.get_event_index_from_relative_timestamp(last_time), NUM_ELEMENTS - 1) << "Exact lookup mismatch.";
+    EXPECT_EQ(test_ed.get_event_index_from_relative_timestamp(last_time - EVENT_PERIOD + 1), NUM_ELEMENTS - 1)
+        << "Lookup one microsecond after an event mismatch.";
+    EXPECT_EQ(test_ed.get_event_index_from_relative_timestamp(last_time + 1), -1)
+        << "Expected -1 one microsecond after last event.";
+}
+
+// Test sparse time index lookups and time range queries
+TEST(EventData, TimeIndexRange)
+{
+    EventData test_ed{};
+
+    // Several events share each timestamp so duplicates straddle index blocks
+    constexpr int32_t NUM_ELEMENTS{10 * static_cast<int32_t>(EventData::kTimeIndexStride) + 7};
+    for (int32_t i{0}; i < NUM_ELEMENTS; ++i)
+    {
+        EventData::EventDatum evt_datum{.x = 0, .y = 0, .timestamp = 50 + (i / 3) * 2, .polarity = 0};
+        test_ed.write_evt_data(evt_datum);
+    }
+
+    // Relative timestamp of event i is (i / 3) * 2, first event at or after t is 3 * ceil(t / 2)
+    for (int64_t timestamp{0}; timestamp <= (NUM_ELEMENTS / 3) * 2; ++timestamp)
+    {
+        int64_t expected{std::min<int64_t>(3 * ((timestamp + 1) / 2), NUM_ELEMENTS)};
+        int64_t index{test_ed.get_event_index_from_relative_timestamp(timestamp)};
+        ASSERT_EQ(index, expected == NUM_ELEMENTS ? -1 : expected) << "Indexed lookup mismatch at " << timestamp;
+    }
+
+    auto [first, last] = test_ed.get_event_index_range_from_relative_timestamps(500, 1000);
+    EXPECT_EQ(first, 750) << "Range start mismatch.";
+    EXPECT_EQ(last, 1500) << "Range end mismatch.";
+
+    auto [empty_first, empty_last] = test_ed.get_event_index_range_from_relative_timestamps(1001, 1002);
+    EXPECT_EQ(empty_first, empty_last) << "Range without events should be empty.";
+
+    auto [past_first, past_last] = test_ed.get_event_index_range_from_relative_timestamps(1'000'000, 2'000'000);
+    EXPECT_EQ(past_first, NUM_ELEMENTS) << "Range past last event should start at end.";
+    EXPECT_EQ(past_last, NUM_ELEMENTS) << "Range past last event should end at end.";
+}
+
+// Test ring retention keeps indices monotonic and storage constant while evicting whole chunks
+TEST(EventData, RingRetention)
+{
+    EventData test_ed{};
+    test_ed.set_evt_format(EventData::EventFormat::PACKED);
+
+    constexpr std::size_t CHUNK{EventData::MappedEventBuffer<EventData::PackedEvent>::kChunkCapacity};
+    constexpr int64_t LIMIT{static_cast<int64_t>(CHUNK) + 1000};
+    constexpr int64_t NUM_ELEMENTS{static_cast<int64_t>(5 * CHUNK) + 123};
+    test_ed.set_evt_retention(EventData::RetentionMode::EVENTS, LIMIT);
+
+    std::size_t max_chunk_count{0};
+    for (int64_t i{0}; i < NUM_ELEMENTS; ++i)
+    {
+        EventData::EventDatum evt_datum{.x = 1, .y = 2, .timestamp = 1000 + i * 3, .polarity = 1};
+        test_ed.write_evt_data(evt_datum);
+        if (i % 4096 == 0)
+        {
+            test_ed.lock_data_vectors();
+            max_chunk_count = std::max(max_chunk_count, test_ed.get_packed_evt_vector_ref().chunk_count());
+            test_ed.unlock_data_vectors();
+        }
+    }
+
+    test_ed.lock_data_vectors();
+    const std::size_t begin{test_ed.get_evt_begin_index()};
+    const std::size_t end{test_ed.get_evt_end_index()};
+    EXPECT_EQ(end, NUM_ELEMENTS) << "End index should count every event written.";
+    EXPECT_EQ(begin % CHUNK, 0) << "Eviction should happen a whole chunk at a time.";
+    EXPECT_GE(test_ed.get_evt_count(), LIMIT) << "Fewer events than the limit retained.";
+    EXPECT_LT(test_ed.get_evt_count(), LIMIT + CHUNK) << "More than a chunk beyond the limit retained.";
+    EXPECT_LE(max_chunk_count, 3) << "Retained storage should stay constant.";
+    EXPECT_EQ(test_ed.get_evt_relative_time(begin), static_cast<int64_t>(begin) * 3) << "First retained time mismatch.";
+    test_ed.unlock_data_vectors();
+
+    // Lookups keep using the same indices as before eviction
+    EXPECT_EQ(test_ed.get_event_index_from_relative_timestamp(0), begin) << "Lookup before retained data mismatch.";
+    EXPECT_EQ(test_ed.get_event_index_from_relative_timestamp(static_cast<int64_t>(begin + 777) * 3), begin + 777)
+        << "Lookup of retained event mismatch.";
+    auto [first, last] = test_ed.get_event_index_range_from_relative_timestamps((NUM_ELEMENTS - 10) * 3,
+                                                                                 NUM_ELEMENTS * 3);
+    EXPECT_EQ(first, NUM_ELEMENTS - 10) << "Range start mismatch.";
+    EXPECT_EQ(last, NUM_ELEMENTS) << "Range end mismatch.";
+}
+
+// Test batched writes store the same data as single event writes, including a camera reset inside a batch
+TEST(EventData, write_evt_data_batch)
+{
+    std::vector<EventData::EventDatum> evt_batch{};
+    for (int32_t i{0}; i < 1000; ++i)
+    {
+        int64_t timestamp{i < 600 ? 100 + i * 5 : (i - 600) * 7}; // Timestamps go back at 600, reset assumed
+        evt_batch.push_back(EventData::EventDatum{.x = i, .y = 2 * i, .timestamp = timestamp, .polarity = 1});
+    }
+
+    for (EventData::EventFormat format : {EventData::EventFormat::VEC4, EventData::EventFormat::PACKED})
+    {
+        EventData single_ed{};
+        EventData batch_ed{};
+        single_ed.set_evt_format(format);
+        batch_ed.set_evt_format(format);
+
+        for (const EventData::EventDatum &evt_datum : evt_batch)
+        {
+            single_ed.write_evt_data(evt_datum);
+        }
+        batch_ed.write_evt_data_batch(std::span<const EventData::EventDatum>{evt_batch}.first(300));
+        batch_ed.write_evt_data_batch(std::span<const EventData::EventDatum>{evt_batch}.subspan(300));
+
+        ASSERT_EQ(batch_ed.get_evt_count(), 400) << "Batch did not reset on decreasing timestamp.";
+        ASSERT_EQ(batch_ed.get_evt_count(), single_ed.get_evt_count()) << "Batch event count mismatch.";
+        EXPECT_EQ(batch_ed.get_earliest_evt_timestamp(), single_ed.get_earliest_evt_timestamp())
+            << "Batch earliest timestamp mismatch.";
+        for (int32_t i{0}; i < batch_ed.get_evt_count(); ++i)
+        {
+            ASSERT_EQ(batch_ed.get_evt(i), single_ed.get_evt(i)) << "Batch event mismatch at " << i;
+            ASSERT_EQ(batch_ed.get_evt_relative_time(i), single_ed.get_evt_relative_time(i))
+                << "Batch timestamp mismatch at " << i;
+        }
+    }
+}
+
+// Test readers see consistent published events without locking while a writer appends and resets
+TEST(EventData, LockFreeReaders)
+{
+    EventData test_ed{};
+    constexpr int32_t NUM_BATCHES{400};
+    constexpr int32_t BATCH_SIZE{4096};
+    std::atomic<bool> writing{true};
+
+    std::thread writer{[&]() {
+        std::vector<EventData::EventDatum> evt_batch(BATCH_SIZE);
+        for (int32_t batch{0}; batch < NUM_BATCHES; ++batch)
+        {
+            int64_t first_time{(batch % 100) * BATCH_SIZE}; // Timestamps go back every 100 batches, reset assumed
+            for (int32_t i{0}; i < BATCH_SIZE; ++i)
+            {
+                evt_batch[i] = EventData::EventDatum{.x = i % 640, .y = i % 480, .timestamp = first_time + i,
+                                                     .polarity = 0};
+            }
+            test_ed.write_evt_data_batch(evt_batch);
+        }
+        writing = false;
+    }};
+
+    // Event i is written at relative time i, any current view must agree
+    std::size_t checked_views{0};
+    while (writing)
+    {
+        EventData::EventView view{test_ed.get_evt_view()};
+        if (view.begin_index == view.end_index)
+        {
+            continue;
+        }
+        int64_t last_time{test_ed.get_evt_relative_time(view.end_index - 1)};
+        int64_t middle_time{test_ed.get_evt_relative_time(view.end_index / 2)};
+        int64_t lookup{test_ed.get_event_index_from_relative_timestamp(static_cast<int64_t>(view.end_index / 2))};
+        if (test_ed.is_evt_view_current(view))
+        {
+            ASSERT_EQ(last_time, static_cast<int64_t>(view.end_index - 1)) << "Last published event mismatch.";
+            ASSERT_EQ(middle_time, static_cast<int64_t>(view.end_index / 2)) << "Published event mismatch.";
+            ASSERT_EQ(lookup, static_cast<int64_t>(view.end_index / 2)) << "Lock free lookup mismatch.";
+            ++checked_views;
+        }
+    }
+    writer.join();
+
+    EXPECT_GT(checked_views, 0) << "No consistent view was read.";
+    EXPECT_EQ(test_ed.get_evt_count(), 100 * BATCH_SIZE) << "Events after last reset mismatch.";
+}
+
+// Test frames round trip through the disk backed frame store with a bounded decoded cache
+TEST(EventData, FrameStore)
+{
+    EventData::FrameStore frame_store{};
+    frame_store.set_cache_capacity(4);
+
+    constexpr std::size_t FRAMES_PER_FILE{EventData::FrameStore::kFramesPerFile};
+    constexpr int32_t NUM_ELEMENTS{static_cast<int32_t>(2 * FRAMES_PER_FILE) + 10};
+    for (int32_t i{0}; i < NUM_ELEMENTS; ++i)
+    {
+        cv::Mat frame(4, 5, CV_8UC3);
+        std::fill(frame.data, frame.data + frame.total() * frame.elemSize(), static_cast<unsigned char>(i));
+        frame_store.push_back(frame, i * 10);
+    }
+    frame_store.push_back(cv::Mat(), NUM_ELEMENTS * 10); // Empty frames are kept as well
+
+    ASSERT_EQ(frame_store.size(), NUM_ELEMENTS + 1) << "Frame store size mismatch.";
+    for (int32_t i : {0, 1, 300, NUM_ELEMENTS - 1, 1, 0})
+    {
+        cv::Mat frame{frame_store.frame(i)};
+        ASSERT_EQ(frame.rows, 4) << "Decoded frame rows mismatch at " << i;
+        ASSERT_EQ(frame.cols, 5) << "Decoded frame cols mismatch at " << i;
+        EXPECT_EQ(frame.at<unsigned char>(3, 4), static_cast<unsigned char>(i)) << "Decoded frame mismatch at " << i;
+        EXPECT_LE(frame_store.cached_count(), 4) << "Decoded frame cache exceeded its capacity.";
+    }
+    EXPECT_TRUE(frame_store.frame(NUM_ELEMENTS).empty()) << "Empty frame did not round trip.";
+
+    // Timestamp lookups
+    EXPECT_EQ(frame_store.lower_bound(-5), 0) << "Lookup before first frame mismatch.";
+    EXPECT_EQ(frame_store.lower_bound(55), 6) << "Lookup between frames mismatch.";
+    EXPECT_EQ(frame_store.lower_bound(NUM_ELEMENTS * 10 + 1), NUM_ELEMENTS + 1) << "Lookup past last frame mismatch.";
+
+    // Eviction keeps indices of retained frames
+    frame_store.evict_before(static_cast<int64_t>(FRAMES_PER_FILE + 3) * 10);
+    EXPECT_EQ(frame_store.begin_index(), FRAMES_PER_FILE + 3) << "Eviction begin index mismatch.";
+    EXPECT_EQ(frame_store.frame(FRAMES_PER_FILE + 3).at<unsigned char>(0, 0),
+              static_cast<unsigned char>(FRAMES_PER_FILE + 3))
+        << "Retained frame mismatch after eviction.";
+
+    // Frames compressed before storing, and fetched to be decoded without the store, round trip the same
+    cv::Mat encoded_frame(4, 5, CV_8UC3);
+    std::fill(encoded_frame.data, encoded_frame.data + encoded_frame.total() * encoded_frame.elemSize(),
+              static_cast<unsigned char>(200));
+    frame_store.push_back(encoded_frame, NUM_ELEMENTS * 10 + 5, EventData::FrameStore::encode(encoded_frame));
+    const std::size_t encoded_index{frame_store.end_index() - 1};
+    EventData::FrameStore::FetchedFrame fetched{frame_store.fetch(encoded_index)};
+    EXPECT_FALSE(fetched.cached) << "Frame never decoded came from the cache.";
+    cv::Mat decoded{EventData::FrameStore::decode(fetched)};
+    EXPECT_EQ(decoded.at<unsigned char>(3, 4), 200) << "Compressed frame mismatch.";
+    frame_store.cache(fetched, decoded);
+    EXPECT_TRUE(frame_store.fetch(encoded_index).cached) << "Decoded frame not cached.";
+
+    frame_store.clear();
+    EXPECT_TRUE(frame_store.empty()) << "Frame store not empty after clear.";
+    frame_store.push_back(cv::Mat(2, 2, CV_8UC3), 7);
+    EXPECT_EQ(frame_store.timestamp(0), 7) << "Indices did not start over after clear.";
+    EXPECT_EQ(frame_store.cached_count(), 0) << "Decoded frame cache not cleared.";
+
+    // A frame decoded from before a clear is not cached for the frame now at its index
+    EventData::FrameStore::FetchedFrame stale{frame_store.fetch(0)};
+    cv::Mat stale_decoded{EventData::FrameStore::decode(stale)};
+    frame_store.clear();
+    frame_store.push_back(cv::Mat(3, 3, CV_8UC3), 8);
+    frame_store.cache(stale, stale_decoded);
+    EXPECT_EQ(frame_store.cached_count(), 0) << "Frame from before a clear was cached.";
+    EXPECT_EQ(frame_store.frame(0).rows, 3) << "Frame from before a clear was served.";
+}
+
+// Test the event rate timeline matches brute force counts per bucket, across a gap without events
+TEST(EventData, EventRateTimeline)
+{
+    EventData test_ed{};
+    EXPECT_TRUE(test_ed.get_evt_rate_timeline(64).empty()) << "Event rate timeline of no events not empty.";
+
+    constexpr int32_t NUM_ELEMENTS{200'000};
+    std::vector<EventData::EventDatum> evts{};
+    for (int32_t i{0}; i < NUM_ELEMENTS; ++i)
+    {
+        int64_t timestamp{i < 150'000 ? 10 + i * 7 : 50'000'000 + i * 3}; // Leaves a gap of empty buckets
+        evts.push_back(EventData::EventDatum{.x = (i * 13) % 64,
+                                             .y = (i * 5) % 32,
+                                             .timestamp = timestamp,
+                                             .polarity = static_cast<uint8_t>(i % 3 == 0)});
+    }
+    test_ed.write_evt_data_batch(evts);
+
+    constexpr std::size_t MAX_BUCKETS{64};
+    const int64_t last_time{evts.back().timestamp - 10 + 1};
+    const int64_t duration{EventData::rate_bucket_duration(0, last_time, MAX_BUCKETS)};
+    std::vector<float> timeline{test_ed.get_evt_rate_timeline(MAX_BUCKETS)};
+    ASSERT_EQ(timeline.size(), static_cast<std::size_t>((last_time + duration - 1) / duration))
+        << "Event rate timeline bucket count mismatch.";
+    EXPECT_LE(timeline.size(), MAX_BUCKETS) << "Event rate timeline too long.";
+
+    std::vector<double> expected(timeline.size(), 0.0);
+    for (const EventData::EventDatum &evt : evts)
+    {
+        expected[static_cast<std::size_t>((evt.timestamp - 10) / duration)] += 1e6 / static_cast<double>(duration);
+    }
+    for (std::size_t bucket{0}; bucket < timeline.size(); ++bucket)
+    {
+        EXPECT_FLOAT_EQ(timeline[bucket], static_cast<float>(expected[bucket])) << "Rate mismatch at " << bucket;
+    }
+}
+
+// Test region of interest queries through the tile index match a full scan, across finished and open blocks
+TEST(EventData, RegionOfInterest)
+{
+    constexpr std::size_t BLOCK{EventData::EventTileIndex::kBlockEvents};
+    constexpr int32_t NUM_ELEMENTS{static_cast<int32_t>(3 * BLOCK) + 4321};
+    std::vector<EventData::EventDatum> evts{};
+    for (int32_t i{0}; i < NUM_ELEMENTS; ++i)
+    {
+        evts.push_back(EventData::EventDatum{.x = (i * 37) % 346,
+                                             .y = (i * 11 + i / 7) % 260,
+                                             .timestamp = static_cast<int64_t>(i) * 2,
+                                             .polarity = static_cast<uint8_t>(i % 2)});
+    }
+
+    for (EventData::EventFormat format : {EventData::EventFormat::VEC4, EventData::EventFormat::PACKED})
+    {
+        EventData test_ed{};
+        test_ed.set_evt_format(format);
+        test_ed.set_camera_event_resolution(346, 260);
+        test_ed.write_evt_data_batch(evts);
+
+        const EventData::RegionOfInterest roi{.x = 100, .y = 50, .width = 13, .height = 21};
+        for (auto [first, last] : {std::pair<std::size_t, std::size_t>{0, NUM_ELEMENTS},
+                                   std::pair<std::size_t, std::size_t>{BLOCK - 100, 2 * BLOCK + 7},
+                                   std::pair<std::size_t, std::size_t>{3 * BLOCK + 5, NUM_ELEMENTS + 100}})
+        {
+            std::vector<std::size_t> expected{};
+            for (std::size_t i{first}; i < std::min<std::size_t>(last, NUM_ELEMENTS); ++i)
+            {
+                if (evts[i].x >= roi.x && evts[i].x < roi.x + roi.width && evts[i].y >= roi.y &&
+                    evts[i].y < roi.y + roi.height)
+                {
+                    expected.push_back(i);
+                }
+            }
+            ASSERT_FALSE(expected.empty()) << "Test region holds no events.";
+            EXPECT_EQ(test_ed.get_roi_evt_indices(roi, first, last), expected)
+                << "Region of interest indices mismatch in [" << first << ", " << last << ").";
+        }
+
+        // Gathered events carry times relative to the requested base
+        std::vector<std::byte> gathered{};
+        std::size_t count{test_ed.gather_roi_evts(roi, 0, NUM_ELEMENTS, 0, gathered)};
+        EXPECT_EQ(count, test_ed.get_roi_evt_indices(roi, 0, NUM_ELEMENTS).size()) << "Gathered count mismatch.";
+        EXPECT_EQ(gathered.size(), count * test_ed.get_evt_element_size()) << "Gathered size mismatch.";
+    }
+
+    // Queries read the finished blocks without locking while a writer appends, any current view must agree
+    const EventData::RegionOfInterest roi{.x = 100, .y = 50, .width = 13, .height = 21};
+    std::vector<std::size_t> expected{};
+    for (std::size_t i{0}; i < evts.size(); ++i)
+    {
+        if (evts[i].x >= roi.x && evts[i].x < roi.x + roi.width && evts[i].y >= roi.y &&
+            evts[i].y < roi.y + roi.height)
+        {
+            expected.push_back(i);
+        }
+    }
+    EventData live_ed{};
+    live_ed.set_camera_event_resolution(346, 260);
+    std::atomic<bool> writing{true};
+    std::thread writer{[&]() {
+        constexpr std::size_t BATCH_SIZE{1000};
+        for (std::size_t first{0}; first < evts.size(); first += BATCH_SIZE)
+        {
+            std::vector<EventData::EventDatum> evt_batch(
+                evts.begin() + first, evts.begin() + std::min(first + BATCH_SIZE, evts.size()));
+            live_ed.write_evt_data_batch(evt_batch);
+        }
+        writing = false;
+    }};
+    std::size_t checked_views{0};
+    do
+    {
+        EventData::EventView view{live_ed.get_evt_view()};
+        std::vector<std::size_t> indices{live_ed.get_roi_evt_indices(roi, 0, view.end_index)};
+        if (live_ed.is_evt_view_current(view))
+        {
+            auto expected_last = std::lower_bound(expected.begin(), expected.end(), view.end_index);
+            ASSERT_EQ(indices, std::vector<std::size_t>(expected.begin(), expected_last))
+                << "Lock free region of interest mismatch up to " << view.end_index;
+            ++checked_views;
+        }
+    } while (writing);
+    writer.join();
+    EXPECT_GT(checked_views, 0) << "No consistent view was read.";
+}
+
+// Test a file cache restores events, frames and indices, and is ignored once its source file changes
+TEST(EventData, FileCache)
+{
+    std::filesystem::path source{std::filesystem::temp_directory_path() / "nova_file_cache_test.aedat4"};
+    {
+        std::ofstream source_file{source, std::ios::binary | std::ios::trunc};
+        source_file << "not really a recording";
+    }
+
+    constexpr int32_t NUM_ELEMENTS{(1 << 20) + 12345}; // Spans more than one buffer chunk
+    std::vector<EventData::EventDatum> evts{};
+    for (int32_t i{0}; i < NUM_ELEMENTS; ++i)
+    {
+        evts.push_back(EventData::EventDatum{.x = (i * 37) % 346,
+                                             .y = (i * 11) % 260,
+                                             .timestamp = 5000 + static_cast<int64_t>(i) * 3,
+                                             .polarity = static_cast<uint8_t>(i % 2)});
+    }
+
+    for (EventData::EventFormat format :
+         {EventData::EventFormat::VEC4, EventData::EventFormat::PACKED, EventData::EventFormat::COLUMNAR})
+    {
+        EventData saved_ed{};
+        saved_ed.set_evt_format(format);
+        saved_ed.set_camera_event_resolution(346, 260);
+        saved_ed.write_evt_data_batch(evts);
+        for (int32_t i{0}; i < 3; ++i)
+        {
+            cv::Mat frame(4, 5, CV_8UC1);
+            std::fill(frame.data, frame.data + frame.total(), static_cast<unsigned char>(i + 1));
+            saved_ed.write_frame_data(EventData::FrameDatum{.frameData = frame, .timestamp = 5000 + i * 100});
+        }
+        ASSERT_TRUE(EventDataCache::save(source.string(), saved_ed)) << "Cache save failed.";
+
+        EventData loaded_ed{};
+        loaded_ed.set_evt_format(format);
+        loaded_ed.set_camera_event_resolution(346, 260);
+        ASSERT_TRUE(EventDataCache::load(source.string(), loaded_ed)) << "Cache load failed.";
+
+        loaded_ed.lock_data_vectors();
+        ASSERT_EQ(loaded_ed.get_evt_count(), NUM_ELEMENTS) << "Loaded event count mismatch.";
+        for (int32_t i{0}; i < NUM_ELEMENTS; i += 997)
+        {
+            ASSERT_EQ(loaded_ed.get_evt(i), saved_ed.get_evt(i)) << "Loaded event mismatch at " << i;
+            ASSERT_EQ(loaded_ed.get_evt_relative_time(i), saved_ed.get_evt_relative_time(i))
+                << "Loaded event time mismatch at " << i;
+        }
+        const EventData::FrameStore &frame_store{loaded_ed.get_frame_store_ref()};
+        ASSERT_EQ(frame_store.size(), 3) << "Loaded frame count mismatch.";
+        EXPECT_EQ(frame_store.timestamp(2), 200) << "Loaded frame time mismatch.";
+        loaded_ed.unlock_data_vectors();
+        EXPECT_EQ(loaded_ed.get_frame_store_ref().frame(2).at<unsigned char>(3, 4), 3) << "Loaded frame mismatch.";
+
+        EXPECT_EQ(loaded_ed.get_event_index_from_relative_timestamp(3000),
+                  saved_ed.get_event_index_from_relative_timestamp(3000))
+            << "Loaded time index mismatch.";
+        EXPECT_EQ(loaded_ed.get_evt_rate_timeline(64), saved_ed.get_evt_rate_timeline(64))
+            << "Loaded event rate timeline mismatch.";
+        const EventData::RegionOfInterest roi{.x = 100, .y = 50, .width = 13, .height = 21};
+        EXPECT_EQ(loaded_ed.get_roi_evt_indices(roi, 0, NUM_ELEMENTS),
+                  saved_ed.get_roi_evt_indices(roi, 0, NUM_ELEMENTS))
+            << "Loaded tile index mismatch.";
+
+        // Loaded data keeps growing like decoded data
+        EventData::EventDatum next_evt{evts.back()};
+        next_evt.timestamp += 3;
+        loaded_ed.write_evt_data(next_evt);
+        saved_ed.write_evt_data(next_evt);
+        loaded_ed.lock_data_vectors();
+        ASSERT_EQ(loaded_ed.get_evt_count(), NUM_ELEMENTS + 1) << "Append after load failed.";
+        EXPECT_EQ(loaded_ed.get_evt_relative_time(NUM_ELEMENTS), saved_ed.get_evt_relative_time(NUM_ELEMENTS))
+            << "Appended event time mismatch.";
+        loaded_ed.unlock_data_vectors();
+
+        // The cache only matches the storage format it was saved with
+        EventData other_format_ed{};
+        other_format_ed.set_evt_format(format == EventData::EventFormat::VEC4 ? EventData::EventFormat::PACKED
+                                                                              : EventData::EventFormat::VEC4);
+        EXPECT_FALSE(EventDataCache::load(source.string(), other_format_ed)) << "Cache loaded for other format.";
+    }
+
+    // A changed source file invalidates the cache
+    {
+        std::ofstream source_file{source, std::ios::binary | std::ios::app};
+        source_file << "more";
+    }
+    EventData stale_ed{};
+    stale_ed.set_evt_format(EventData::EventFormat::PACKED);
+    EXPECT_FALSE(EventDataCache::load(source.string(), stale_ed)) << "Stale cache was loaded.";
+
+    std::filesystem::remove_all(source.string() + ".nova-cache");
+    std::filesystem::remove(source);
+}
+
+// Test the prefetcher keeps the range ahead of the scrubber hot in the direction of playback, and dropping cold
+// events from memory keeps their contents
+TEST(EventData, Prefetcher)
+{
+    constexpr int32_t NUM_ELEMENTS{(1 << 21) + 777}; // Spans several buffer chunks
+    EventData test_ed{};
+    std::vector<EventData::EventDatum> evts{};
+    for (int32_t i{0}; i < NUM_ELEMENTS; ++i)
+    {
+        evts.push_back(EventData::EventDatum{
+            .x = i % 640, .y = i % 480, .timestamp = static_cast<int64_t>(i), .polarity = static_cast<uint8_t>(i % 2)});
+    }
+    test_ed.write_evt_data_batch(evts);
+
+    EventPrefetcher prefetcher{test_ed};
+    constexpr std::size_t WINDOW{10000};
+    constexpr std::size_t STEP{20000};
+    std::chrono::steady_clock::time_point now{};
+
+    // Playing forward
+    std::size_t current_index{WINDOW};
+    for (int32_t frame{0}; frame < 40; ++frame, current_index += STEP, now += std::chrono::milliseconds(10))
+    {
+        prefetcher.update(current_index - WINDOW, current_index, now);
+    }
+    current_index -= STEP;
+    EXPECT_NEAR(prefetcher.get_velocity(), STEP * 100.0, STEP * 10.0) << "Forward speed estimate mismatch.";
+    auto [first, last] = prefetcher.get_hot_range();
+    EXPECT_EQ(first, current_index - WINDOW - EventPrefetcher::kMinMargin) << "Hot range behind window mismatch.";
+    EXPECT_GT(last, current_index + STEP * 40) << "Hot range does not reach ahead of forward playback.";
+
+    // Playing backward
+    for (int32_t frame{0}; frame < 20; ++frame, current_index -= STEP, now += std::chrono::milliseconds(10))
+    {
+        prefetcher.update(current_index - WINDOW, current_index, now);
+    }
+    current_index += STEP;
+    EXPECT_LT(prefetcher.get_velocity(), 0.0) << "Backward speed estimate not negative.";
+    std::tie(first, last) = prefetcher.get_hot_range();
+    EXPECT_EQ(last, current_index + 1 + EventPrefetcher::kMinMargin) << "Hot range behind backward playback mismatch.";
+    EXPECT_LT(first + STEP * 10, current_index - WINDOW) << "Hot range does not reach ahead of backward playback.";
+
+    test_ed.advise_evts(0, NUM_ELEMENTS, EventData::AccessAdvice::DONT_NEED);
+    test_ed.lock_data_vectors();
+    for (int32_t i{0}; i < NUM_ELEMENTS; i += 4099)
+    {
+        ASSERT_EQ(test_ed.get_evt_relative_time(i), i) << "Event changed after dropping it from memory at " << i;
+    }
+    test_ed.unlock_data_vectors();
+}
+
+// Test events of several sources are merged in time order on the common clock, and sources reset independently
+TEST(EventData, MultiSource)
+{
+    MultiSourceEventData test_msed{};
+    std::size_t left{test_msed.add_source(640, 480)};
+    std::size_t right{test_msed.add_source(346, 260, 1000)}; // Clock runs 1 ms behind the left camera
+
+    // Bursts of one camera between events of the other, and events at the same time on the common clock
+    constexpr int32_t NUM_ELEMENTS{20000};
+    std::vector<EventData::EventDatum> left_evts{};
+    std::vector<EventData::EventDatum> right_evts{};
+    std::vector<std::pair<int64_t, std::size_t>> expected{};
+    for (int32_t i{0}; i < NUM_ELEMENTS; ++i)
+    {
+        int64_t left_time{10000 + static_cast<int64_t>(i) * 3 + (i / 500) * 700};
+        int64_t right_time{9000 + static_cast<int64_t>(i) * 4};
+        left_evts.push_back(EventData::EventDatum{.x = i % 640, .y = i % 480, .timestamp = left_time, .polarity = 0});
+        right_evts.push_back(EventData::EventDatum{.x = i % 346, .y = i % 260, .timestamp = right_time, .polarity = 1});
+        expected.push_back({left_time, left});
+        expected.push_back({right_time + 1000, right});
+    }
+    test_msed.write_evt_data_batch(left, left_evts);
+    test_msed.write_evt_data_batch(right, right_evts);
+    std::sort(expected.begin(), expected.end());
+
+    auto [first_time, last_time] = test_msed.get_time_range();
+    EXPECT_EQ(first_time, expected.front().first) << "Earliest common time mismatch.";
+    EXPECT_EQ(last_time, expected.back().first) << "Latest common time mismatch.";
+
+    const int64_t start_time{20000};
+    const int64_t end_time{60001};
+    std::vector<std::pair<int64_t, std::size_t>> merged{};
+    bool current{test_msed.for_each_merged_evt(start_time, end_time, [&](const MultiSourceEventData::SourceEvent &evt) {
+        EXPECT_EQ(test_msed.get_evt_time(evt.source, evt.index), evt.timestamp) << "Merged event time mismatch.";
+        merged.push_back({evt.timestamp, evt.source});
+    })};
+    EXPECT_TRUE(current) << "Merged view not current.";
+    std::vector<std::pair<int64_t, std::size_t>> expected_window{};
+    std::copy_if(expected.begin(), expected.end(), std::back_inserter(expected_window),
+                 [&](const auto &evt) { return evt.first >= start_time && evt.first < end_time; });
+    EXPECT_EQ(merged, expected_window) << "Merged events out of time order.";
+
+    // Per source windows cover the same events
+    auto windows{test_msed.get_source_windows(start_time, end_time)};
+    ASSERT_EQ(windows.size(), 2) << "Source window count mismatch.";
+    std::size_t window_events{(windows[left].second - windows[left].first) +
+                              (windows[right].second - windows[right].first)};
+    EXPECT_EQ(window_events, expected_window.size()) << "Source windows mismatch merged view.";
+
+    // Window of one source, as a Scrubber shows it, gives the other source's events at the same moment
+    std::size_t first_left{windows[left].first + 10};
+    std::size_t last_left{windows[left].second - 10};
+    auto moment_windows{test_msed.get_source_windows_at(left, first_left, last_left)};
+    ASSERT_EQ(moment_windows.size(), 2) << "Source window count mismatch.";
+    EXPECT_EQ(moment_windows[left], (std::pair<std::size_t, std::size_t>{first_left, last_left + 1}))
+        << "Scrubbed source window changed.";
+    auto [right_first, right_last] = moment_windows[right];
+    for (std::size_t i{right_first}; i < right_last; ++i)
+    {
+        int64_t time{test_msed.get_evt_time(right, i)};
+        EXPECT_GE(time, test_msed.get_evt_time(left, first_left)) << "Other source event before window at: " << i;
+        EXPECT_LE(time, test_msed.get_evt_time(left, last_left)) << "Other source event after window at: " << i;
+    }
+    EXPECT_GT(right_last, right_first) << "Other source window empty.";
+    if (right_first > 0)
+    {
+        EXPECT_LT(test_msed.get_evt_time(right, right_first - 1), test_msed.get_evt_time(left, first_left))
+            << "Other source window starts late.";
+    }
+    EXPECT_EQ(test_msed.get_source_windows_at(left, last_left, first_left),
+              (std::vector<std::pair<std::size_t, std::size_t>>(2, {0, 0})))
+        << "Reversed window not empty.";
+
+    // A camera reset clears only that camera
+    test_msed.write_evt_data_batch(right, std::vector<EventData::EventDatum>{
+                                              EventData::EventDatum{.x = 0, .y = 0, .timestamp = 5, .polarity = 0}});
+    EXPECT_EQ(test_msed.get_source(right).get_evt_view().end_index, 1) << "Reset source not cleared.";
+    EXPECT_EQ(test_msed.get_source(left).get_evt_view().end_index, NUM_ELEMENTS) << "Other source cleared on reset.";
+
+    test_msed.clear();
+    EXPECT_EQ(test_msed.get_time_range().second, -1) << "Sources not cleared.";
+    EXPECT_EQ(test_msed.get_source(right).get_camera_event_resolution(), glm::vec2(346, 260))
+        << "Source resolution lost on clear.";
+}
+
+// Test every storage backend holds the same events, anonymous memory is accounted for and files go to the scratch
+// directory
+TEST(EventData, StorageBackends)
+{
+    constexpr int32_t NUM_ELEMENTS{(1 << 20) + 4321}; // Spans two buffer chunks
+    constexpr std::size_t CHUNK_BYTES{EventData::MappedEventBuffer<>::kChunkCapacity * sizeof(glm::vec4)};
+    std::vector<EventData::EventDatum> evts{};
+    for (int32_t i{0}; i < NUM_ELEMENTS; ++i)
+    {
+        evts.push_back(EventData::EventDatum{.x = i % 640,
+                                             .y = i % 480,
+                                             .timestamp = static_cast<int64_t>(i) * 2,
+                                             .polarity = static_cast<uint8_t>(i % 2)});
+    }
+
+    const std::filesystem::path scratch{std::filesystem::temp_directory_path() / "nova_storage_test"};
+    std::filesystem::remove_all(scratch);
+    std::filesystem::create_directories(scratch);
+    const std::size_t anonymous_before{EventData::get_anonymous_storage_bytes()};
+
+    for (EventData::StorageBackend backend : {EventData::StorageBackend::MAPPED_FILE,
+                                              EventData::StorageBackend::ANONYMOUS, EventData::StorageBackend::HYBRID})
+    {
+        {
+            EventData test_ed{};
+            test_ed.set_storage_config(
+                EventData::StorageConfig{.backend = backend,
+                                         .scratch_directory = scratch,
+                                         .memory_limit = anonymous_before + CHUNK_BYTES,
+                                         .huge_pages = EventData::HugePageMode::TRANSPARENT_HUGE_PAGES,
+                                         .populate = true});
+            test_ed.write_evt_data_batch(evts);
+
+            test_ed.lock_data_vectors();
+            ASSERT_EQ(test_ed.get_evt_count(), NUM_ELEMENTS) << "Event count mismatch.";
+            for (int32_t i{0}; i < NUM_ELEMENTS; i += 1009)
+            {
+                ASSERT_EQ(test_ed.get_evt(i).x, static_cast<float>(i % 640)) << "Event mismatch at " << i;
+                ASSERT_EQ(test_ed.get_evt_relative_time(i), static_cast<int64_t>(i) * 2) << "Time mismatch at " << i;
+            }
+            test_ed.unlock_data_vectors();
+
+            // Both event chunks in memory, only the first one within the hybrid limit, none for files
+            std::size_t anonymous{EventData::get_anonymous_storage_bytes() - anonymous_before};
+            if (backend == EventData::StorageBackend::ANONYMOUS)
+            {
+                EXPECT_GE(anonymous, 2 * CHUNK_BYTES) << "Anonymous storage not accounted for.";
+            }
+            else if (backend == EventData::StorageBackend::HYBRID)
+            {
+                EXPECT_LE(anonymous, CHUNK_BYTES) << "Hybrid storage exceeded its memory limit.";
+                EXPECT_FALSE(std::filesystem::is_empty(scratch)) << "Hybrid storage did not spill to files.";
+            }
+            else
+            {
+                EXPECT_EQ(anonymous, 0) << "File storage used anonymous memory.";
+                EXPECT_FALSE(std::filesystem::is_empty(scratch)) << "No backing files in scratch directory.";
+            }
+        }
+        EXPECT_EQ(EventData::get_anonymous_storage_bytes(), anonymous_before) << "Anonymous storage not released.";
+        EXPECT_TRUE(std::filesystem::is_empty(scratch)) << "Backing files left in scratch directory.";
+    }
+    std::filesystem::remove_all(scratch);
+}
+
+// Test slightly out of order events are sorted instead of resetting, and only large backward jumps reset
+TEST(EventData, ReorderBuffer)
+{
+    EventData test_ed{};
+    test_ed.set_camera_event_resolution(640, 480);
+    test_ed.set_evt_reorder(100, 10000);
+
+    // Pairs of events swapped, at most 10 us apart
+    constexpr int32_t NUM_ELEMENTS{1000};
+    std::vector<EventData::EventDatum> evts{};
+    for (int32_t i{0}; i < NUM_ELEMENTS; ++i)
+    {
+        int32_t swapped{i % 2 == 0 ? i + 1 : i - 1};
+        evts.push_back(EventData::EventDatum{.x = swapped % 640,
+                                             .y = 0,
+                                             .timestamp = 1000 + static_cast<int64_t>(swapped) * 10,
+                                             .polarity = 1});
+    }
+    test_ed.write_evt_data_batch(std::span<const EventData::EventDatum>{evts.data(), 500});
+    test_ed.write_evt_data_batch(std::span<const EventData::EventDatum>{evts.data() + 500, 500});
+
+    EventData::ReorderStats stats{test_ed.get_reorder_stats()};
+    EXPECT_EQ(stats.resets, 0) << "Small disorder taken as a reset.";
+    EXPECT_EQ(stats.reordered_evts, NUM_ELEMENTS / 2) << "Reordered event count mismatch.";
+    EXPECT_EQ(stats.max_disorder, 10) << "Max disorder mismatch.";
+    EXPECT_GT(stats.held_evts, 0) << "Events within the tolerance of the latest were not held.";
+    EXPECT_EQ(test_ed.get_evt_count() + stats.held_evts, NUM_ELEMENTS) << "Events lost while held.";
+
+    test_ed.flush_evt_data();
+    ASSERT_EQ(test_ed.get_evt_count(), NUM_ELEMENTS) << "Held events not stored on flush.";
+    test_ed.lock_data_vectors();
+    for (int32_t i{0}; i < NUM_ELEMENTS; ++i)
+    {
+        ASSERT_EQ(test_ed.get_evt_relative_time(i), static_cast<int64_t>(i) * 10) << "Events not sorted at " << i;
+        ASSERT_EQ(test_ed.get_evt(i).x, static_cast<float>(i % 640)) << "Event mismatch at " << i;
+    }
+    test_ed.unlock_data_vectors();
+
+    // Behind stored events but within the reset threshold, dropped
+    EventData::EventDatum late{.x = 0, .y = 0, .timestamp = 5000, .polarity = 0};
+    test_ed.write_evt_data(late);
+    test_ed.flush_evt_data();
+    EXPECT_EQ(test_ed.get_reorder_stats().dropped_evts, 1) << "Late event not dropped.";
+    EXPECT_EQ(test_ed.get_evt_count(), NUM_ELEMENTS) << "Late event stored.";
+
+    // Going back by more than the reset threshold is a camera reset
+    EventData::EventDatum reset{.x = 0, .y = 0, .timestamp = 0, .polarity = 0};
+    test_ed.write_evt_data(reset);
+    test_ed.flush_evt_data();
+    EXPECT_EQ(test_ed.get_reorder_stats().resets, 1) << "Camera reset not detected.";
+    EXPECT_EQ(test_ed.get_evt_count(), 1) << "Data not cleared on camera reset.";
+
+    // A camera reset seen in frames stores the held events first, in the epoch they belong to
+    test_ed.set_evt_epoch_limit(0);
+    std::vector<EventData::EventDatum> before_reset{};
+    for (int64_t i{0}; i < 50; ++i)
+    {
+        before_reset.push_back(EventData::EventDatum{.x = 1, .y = 1, .timestamp = 20000 + i, .polarity = 1});
+    }
+    test_ed.write_evt_data_batch(before_reset);
+    ASSERT_EQ(test_ed.get_reorder_stats().held_evts, 50) << "Events within the tolerance of the latest not held.";
+    test_ed.write_frame_data(EventData::FrameDatum{.frameData = cv::Mat(), .timestamp = 20000});
+    test_ed.write_frame_data(EventData::FrameDatum{.frameData = cv::Mat(), .timestamp = 0});
+    EXPECT_EQ(test_ed.get_reorder_stats().resets, 2) << "Camera reset in frames not detected.";
+    EXPECT_EQ(test_ed.get_reorder_stats().held_evts, 0) << "Events still held after a reset.";
+    EXPECT_EQ(test_ed.get_evt_count(), 51) << "Held events lost on a camera reset seen in frames.";
+}
+
+// Test sealed events decode to the same bytes as uncompressed storage, in both formats
+TEST(EventData, SealedEvents)
+{
+    constexpr std::size_t CHUNK{EventData::MappedEventBuffer<>::kChunkCapacity};
+    constexpr int32_t NUM_ELEMENTS{static_cast<int32_t>(CHUNK * 2) + 12345};
+    std::vector<EventData::EventDatum> evts{};
+    int64_t timestamp{100};
+    for (int32_t i{0}; i < NUM_ELEMENTS; ++i)
+    {
+        timestamp += (static_cast<int64_t>(i) * 7919) % 13; // Includes equal timestamps
+        evts.push_back(EventData::EventDatum{.x = (i * 31) % 640,
+                                             .y = (i * 17) % 480,
+                                             .timestamp = timestamp,
+                                             .polarity = static_cast<uint8_t>((i / 3) % 2)});
+    }
+
+    for (EventData::EventFormat format :
+         {EventData::EventFormat::VEC4, EventData::EventFormat::PACKED, EventData::EventFormat::COLUMNAR})
+    {
+        EventData plain_ed{};
+        EventData sealed_ed{};
+        plain_ed.set_evt_format(format);
+        sealed_ed.set_evt_format(format);
+        sealed_ed.set_evt_compression(true);
+        plain_ed.write_evt_data_batch(evts);
+        sealed_ed.write_evt_data_batch(evts);
+
+        auto [sealed_count, sealed_bytes] = sealed_ed.get_sealed_evt_usage();
+        ASSERT_EQ(sealed_count, CHUNK * 2) << "Full chunks not sealed.";
+        EXPECT_LT(sealed_bytes, sealed_count * 4) << "Sealed events not compressed."; // 24 bits of data per event
+        EXPECT_EQ(plain_ed.get_sealed_evt_usage().first, 0) << "Events sealed without compression.";
+
+        // Windows crossing block, chunk and sealed boundaries, rebased to an earlier time
+        for (auto [first, last] : std::vector<std::pair<std::size_t, std::size_t>>{
+                 {0, 10}, {4000, 9000}, {CHUNK - 100, CHUNK + 100}, {5, NUM_ELEMENTS}})
+        {
+            int64_t time_base{plain_ed.get_evt_time_base(first)};
+            std::vector<std::byte> expected{};
+            plain_ed.for_each_evt_span(first, last, time_base, [&](std::span<const std::byte> span) {
+                expected.insert(expected.end(), span.begin(), span.end());
+            });
+            std::vector<std::byte> spans{};
+            sealed_ed.for_each_evt_span(first, last, time_base, [&](std::span<const std::byte> span) {
+                spans.insert(spans.end(), span.begin(), span.end());
+            });
+            std::vector<glm::vec4> copied((last - first) * sealed_ed.get_evt_element_size() / sizeof(glm::vec4) + 1);
+            sealed_ed.copy_evts(first, last, time_base, reinterpret_cast<std::byte *>(copied.data()));
+
+            ASSERT_EQ(expected.size(), (last - first) * plain_ed.get_evt_element_size());
+            EXPECT_TRUE(spans == expected) << "Sealed spans mismatch in [" << first << ", " << last << ").";
+            EXPECT_EQ(std::memcmp(copied.data(), expected.data(), expected.size()), 0)
+                << "Copied events mismatch in [" << first << ", " << last << ").";
+        }
+    }
+}
+
+// Test columnar storage matches packed storage in reads, uploads and scans, across chunks and time segments
+TEST(EventData, ColumnarFormat)
+{
+    constexpr std::size_t CHUNK{EventData::ColumnarEventBuffer::kChunkCapacity};
+    constexpr int32_t NUM_ELEMENTS{static_cast<int32_t>(CHUNK) + 4321};
+    std::vector<EventData::EventDatum> evts{};
+    int64_t timestamp{50};
+    for (int32_t i{0}; i < NUM_ELEMENTS; ++i)
+    {
+        timestamp += i % 5;
+        if (i == NUM_ELEMENTS - 100)
+        {
+            timestamp += int64_t{1} << 31; // Starts a new time segment
+        }
+        evts.push_back(EventData::EventDatum{.x = (i * 37) % 346,
+                                             .y = (i * 11) % 260,
+                                             .timestamp = timestamp,
+                                             .polarity = static_cast<uint8_t>((i / 7) % 2)});
+    }
+
+    EventData packed_ed{};
+    EventData columnar_ed{};
+    packed_ed.set_evt_format(EventData::EventFormat::PACKED);
+    columnar_ed.set_evt_format(EventData::EventFormat::COLUMNAR);
+    packed_ed.write_evt_data_batch(evts);
+    columnar_ed.write_evt_data_batch(evts);
+
+    ASSERT_EQ(columnar_ed.get_evt_count(), NUM_ELEMENTS) << "Columnar event data size mismatch.";
+    EXPECT_TRUE(columnar_ed.get_packed_evt_vector_ref().empty()) << "Packed buffer should be unused.";
+    EXPECT_EQ(columnar_ed.get_evt_element_size(), sizeof(EventData::PackedEvent)) << "Uploads should be packed.";
+    for (std::size_t i : {std::size_t{0}, std::size_t{1}, CHUNK - 1, CHUNK, static_cast<std::size_t>(NUM_ELEMENTS) - 1})
+    {
+        EXPECT_EQ(columnar_ed.get_evt(i), packed_ed.get_evt(i)) << "Columnar event mismatch at " << i;
+        EXPECT_EQ(columnar_ed.get_evt_relative_time(i), packed_ed.get_evt_relative_time(i))
+            << "Columnar time mismatch at " << i;
+    }
+    for (int64_t time : {int64_t{0}, int64_t{7}, int64_t{1234567}, evts.back().timestamp - 50})
+    {
+        EXPECT_EQ(columnar_ed.get_event_index_from_relative_timestamp(time),
+                  packed_ed.get_event_index_from_relative_timestamp(time))
+            << "Columnar timestamp search mismatch at " << time;
+    }
+
+    // Gathered uploads match the packed layout, across chunks and time segments
+    for (auto [first, last] : std::vector<std::pair<std::size_t, std::size_t>>{
+             {0, 10}, {CHUNK - 100, CHUNK + 100}, {5, NUM_ELEMENTS}})
+    {
+        int64_t time_base{packed_ed.get_evt_time_base(first)};
+        std::vector<std::byte> expected{};
+        packed_ed.for_each_evt_span(first, last, time_base, [&](std::span<const std::byte> span) {
+            expected.insert(expected.end(), span.begin(), span.end());
+        });
+        std::vector<std::byte> spans{};
+        columnar_ed.for_each_evt_span(first, last, time_base, [&](std::span<const std::byte> span) {
+            spans.insert(spans.end(), span.begin(), span.end());
+        });
+        std::vector<EventData::PackedEvent> copied(last - first);
+        columnar_ed.copy_evts(first, last, time_base, reinterpret_cast<std::byte *>(copied.data()));
+
+        EXPECT_TRUE(spans == expected) << "Columnar spans mismatch in [" << first << ", " << last << ").";
+        EXPECT_EQ(std::memcmp(copied.data(), expected.data(), expected.size()), 0)
+            << "Columnar copy mismatch in [" << first << ", " << last << ").";
+    }
+
+    // Scans match a brute force filter in every format
+    EventData::EventFilter filter{.roi = {.x = 100, .y = 40, .width = 80, .height = 120}, .polarity = 1};
+    std::vector<std::size_t> expected{};
+    for (std::size_t i{10}; i < CHUNK + 500; ++i)
+    {
+        const EventData::EventDatum &evt{evts[i]};
+        if (evt.x >= 100 && evt.x < 180 && evt.y >= 40 && evt.y < 160 && evt.polarity == 1)
+        {
+            expected.push_back(i);
+        }
+    }
+    ASSERT_FALSE(expected.empty());
+    EventData vec4_ed{};
+    vec4_ed.write_evt_data_batch(std::span<const EventData::EventDatum>{evts}.first(CHUNK + 500));
+    for (const EventData *evt_data : {&vec4_ed, &packed_ed, &columnar_ed})
+    {
+        std::vector<std::size_t> matches{};
+        evt_data->for_each_matching_evt(filter, 10, CHUNK + 500, [&](std::size_t index) { matches.push_back(index); });
+        EXPECT_EQ(matches, expected) << "Scan mismatch in format " << static_cast<int>(evt_data->get_evt_format());
+    }
+    filter.polarity = -1;
+    std::size_t both_polarities{0};
+    columnar_ed.for_each_matching_evt(filter, 10, CHUNK + 500, [&](std::size_t) { ++both_polarities; });
+    EXPECT_GT(both_polarities, expected.size()) << "Negative polarity should match both polarities.";
+}
+
+// Test polarity counts over time ranges match brute force counts in every format, also after eviction
+TEST(EventData, PolarityCounts)
+{
+    constexpr int32_t NUM_ELEMENTS{100000};
+    std::vector<EventData::EventDatum> evts{};
+    for (int32_t i{0}; i < NUM_ELEMENTS; ++i)
+    {
+        evts.push_back(EventData::EventDatum{.x = i % 640,
+                                             .y = i % 480,
+                                             .timestamp = 10 + i * 2 + (i / 1000) * 50, // 2 us apart, gaps
+                                             .polarity = static_cast<uint8_t>((i * 7919) % 3 == 0)});
+    }
+    auto brute_force = [&](int64_t start, int64_t end) {
+        EventData::PolarityCounts counts{0, 0};
+        for (const EventData::EventDatum &evt : evts)
+        {
+            int64_t relative{evt.timestamp - evts.front().timestamp};
+            if (relative >= start && relative < end)
+            {
+                ++counts[evt.polarity];
+            }
+        }
+        return counts;
+    };
+
+    for (EventData::EventFormat format :
+         {EventData::EventFormat::VEC4, EventData::EventFormat::PACKED, EventData::EventFormat::COLUMNAR})
+    {
+        EventData test_ed{};
+        test_ed.set_evt_format(format);
+        EXPECT_EQ(test_ed.get_evt_polarity_counts(0, 1000), (EventData::PolarityCounts{0, 0}))
+            << "Counts of no events should be 0.";
+        test_ed.write_evt_data_batch(evts);
+
+        // Ranges within one index stride, across strides, at the ends and past them
+        for (auto [start, end] : std::vector<std::pair<int64_t, int64_t>>{
+                 {0, 1}, {0, 10}, {100, 600}, {511, 513}, {12345, 98765}, {0, 300000}, {-50, 1000000}, {20, 20}})
+        {
+            EXPECT_EQ(test_ed.get_evt_polarity_counts(start, end), brute_force(start, end))
+                << "Polarity counts mismatch in [" << start << ", " << end << ").";
+        }
+
+        // About a third of the events are positive, 500000 events per second with gaps
+        std::array<double, 2> rate{test_ed.get_latest_evt_rate(100000)};
+        EXPECT_NEAR(rate[0] + rate[1], 1e6 / 2.05, 1e4) << "Latest event rate mismatch.";
+        EXPECT_NEAR(rate[1] / (rate[0] + rate[1]), 1.0 / 3.0, 0.05) << "Latest positive share mismatch.";
+    }
+
+    // Counts stay exact once old events are evicted
+    constexpr std::size_t CHUNK{EventData::MappedEventBuffer<>::kChunkCapacity};
+    EventData ring_ed{};
+    ring_ed.set_evt_format(EventData::EventFormat::PACKED);
+    ring_ed.set_evt_retention(EventData::RetentionMode::EVENTS, static_cast<int64_t>(CHUNK));
+    std::vector<EventData::EventDatum> ring_evts{};
+    uint64_t positive_kept{0};
+    for (std::size_t i{0}; i < CHUNK * 3 + 777; ++i)
+    {
+        ring_evts.push_back(EventData::EventDatum{.x = 1, .y = 1, .timestamp = static_cast<int64_t>(i),
+                                                  .polarity = static_cast<uint8_t>((i * 7) % 5 == 0)});
+    }
+    ring_ed.write_evt_data_batch(ring_evts);
+    EventData::EventView view{ring_ed.get_evt_view()};
+    ASSERT_GT(view.begin_index, 0) << "Expected eviction.";
+    for (std::size_t i{view.begin_index}; i < view.end_index; ++i)
+    {
+        positive_kept += ring_evts[i].polarity;
+    }
+    EventData::PolarityCounts ring_counts{ring_ed.get_evt_polarity_counts(0, 1 << 30)};
+    EXPECT_EQ(ring_counts[1], positive_kept) << "Positive count mismatch after eviction.";
+    EXPECT_EQ(ring_counts[0] + ring_counts[1], view.end_index - view.begin_index) << "Count mismatch after eviction.";
+}
+
+// Test camera resets keep earlier data as epochs on one increasing relative timeline, and the epoch limit evicts them
+TEST(EventData, Epochs)
+{
+    EventData test_ed{};
+    test_ed.set_evt_epoch_limit(0);
+    std::vector<EventData::EventDatum> evts{};
+    for (int32_t epoch{0}; epoch < 3; ++epoch)
+    {
+        for (int32_t i{0}; i < 1000; ++i)
+        {
+            evts.push_back(EventData::EventDatum{.x = i % 640, .y = epoch, .timestamp = 5000 + i * 10, .polarity = 1});
+        }
+    }
+    test_ed.write_evt_data_batch(evts);
+    EventData::FrameDatum frame_datum{.frameData = cv::Mat{}, .timestamp = 5100};
+    test_ed.write_frame_data(frame_datum);
+
+    ASSERT_EQ(test_ed.get_evt_count(), 3000) << "Data cleared on reset with epochs kept.";
+    EXPECT_EQ(test_ed.get_reorder_stats().resets, 2) << "Camera resets not counted.";
+    std::vector<EventData::EpochRange> epochs{test_ed.get_evt_epochs()};
+    ASSERT_EQ(epochs.size(), 3) << "Epoch count mismatch.";
+    for (std::size_t epoch{0}; epoch < epochs.size(); ++epoch)
+    {
+        EXPECT_EQ(epochs[epoch].id, epoch);
+        EXPECT_EQ(epochs[epoch].first_index, epoch * 1000) << "Epoch start mismatch.";
+        EXPECT_EQ(epochs[epoch].last_index, (epoch + 1) * 1000) << "Epoch end mismatch.";
+        EXPECT_EQ(test_ed.get_evt_relative_time(epochs[epoch].first_index) + epochs[epoch].time_origin, 5000)
+            << "Camera timestamp of epoch start mismatch.";
+    }
+
+    // Relative times keep increasing across epochs, so time searches span all of them
+    EXPECT_EQ(test_ed.get_evt_relative_time(999), 9990);
+    EXPECT_EQ(test_ed.get_evt_relative_time(1000), 9991) << "Epoch should start right after the previous one.";
+    EXPECT_EQ(test_ed.get_event_index_from_relative_timestamp(9991 + 9990 + 1), 2000);
+    EXPECT_EQ(test_ed.get_earliest_evt_timestamp(), 5000 - 2 * 9991) << "Time origin of the current epoch mismatch.";
+    test_ed.lock_data_vectors();
+    EXPECT_EQ(test_ed.get_frame_store_ref().size(), 1) << "Frame of the current epoch not stored.";
+    EXPECT_EQ(test_ed.get_frame_store_ref().timestamp(0), 2 * 9991 + 100) << "Frame time mismatch.";
+    test_ed.unlock_data_vectors();
+
+    // Only the latest epochs are kept, older ones are evicted a storage chunk at a time
+    constexpr std::size_t CHUNK{EventData::MappedEventBuffer<>::kChunkCapacity};
+    EventData limited_ed{};
+    limited_ed.set_evt_epoch_limit(2);
+    for (int32_t epoch{0}; epoch < 4; ++epoch)
+    {
+        std::vector<EventData::EventDatum> epoch_evts{};
+        for (std::size_t i{0}; i < CHUNK + 10; ++i)
+        {
+            epoch_evts.push_back(
+                EventData::EventDatum{.x = 1, .y = 1, .timestamp = static_cast<int64_t>(i), .polarity = 0});
+        }
+        limited_ed.write_evt_data_batch(epoch_evts);
+    }
+    std::vector<EventData::EpochRange> kept{limited_ed.get_evt_epochs()};
+    ASSERT_FALSE(kept.empty());
+    EXPECT_LE(kept.size(), 3) << "Epochs beyond the limit not evicted.";
+    EXPECT_EQ(kept.back().id, 3) << "Current epoch evicted.";
+    EXPECT_EQ(kept.back().last_index - kept.back().first_index, CHUNK + 10) << "Current epoch incomplete.";
+    EXPECT_GT(limited_ed.get_evt_begin_index(), CHUNK) << "Old epochs not evicted.";
+
+    // The default limit of 1 clears data on a reset
+    EventData clearing_ed{};
+    clearing_ed.write_evt_data_batch(evts);
+    EXPECT_EQ(clearing_ed.get_evt_count(), 1000) << "Data not cleared on reset with one epoch kept.";
+    EXPECT_EQ(clearing_ed.get_evt_epochs().size(), 1) << "Cleared epochs still listed.";
+}
+
+// Test snapshot handles stay readable and unchanged across eviction and clears while events keep being appended
+TEST(EventData, Snapshots)
+{
+    constexpr std::size_t CHUNK{EventData::MappedEventBuffer<glm::vec4>::kChunkCapacity};
+    auto make_evts = [](std::size_t first, std::size_t count, int32_t x) {
+        std::vector<EventData::EventDatum> evts{};
+        for (std::size_t i{first}; i < first + count; ++i)
+        {
+            evts.push_back(EventData::EventDatum{.x = x, .y = static_cast<int32_t>(i % 480),
+                                                 .timestamp = 1000 + static_cast<int64_t>(i) * 2,
+                                                 .polarity = static_cast<uint8_t>(i % 2)});
+        }
+        return evts;
+    };
+
+    for (EventData::EventFormat format :
+         {EventData::EventFormat::VEC4, EventData::EventFormat::PACKED, EventData::EventFormat::COLUMNAR})
+    {
+        EventData test_ed{};
+        test_ed.set_evt_format(format);
+        test_ed.set_evt_retention(EventData::RetentionMode::EVENTS, static_cast<int64_t>(CHUNK));
+        test_ed.write_evt_data_batch(make_evts(0, CHUNK + 100, 1));
+
+        EventData::EventSnapshot snapshot{test_ed.get_evt_snapshot()};
+        ASSERT_EQ(snapshot.get_begin_index(), 0) << "Snapshot start mismatch.";
+        ASSERT_EQ(snapshot.get_end_index(), CHUNK + 100) << "Snapshot end mismatch.";
+        EXPECT_EQ(snapshot.get_earliest_evt_timestamp(), 1000) << "Snapshot earliest timestamp mismatch.";
+
+        // Evict the chunks the snapshot reads, then clear and refill storage with other events
+        test_ed.write_evt_data_batch(make_evts(CHUNK + 100, 2 * CHUNK, 1));
+        EXPECT_GT(test_ed.get_evt_begin_index(), 0) << "Expected eviction.";
+        test_ed.clear();
+        test_ed.write_evt_data_batch(make_evts(0, 2 * CHUNK, 7));
+
+        EventData::EventSnapshot copy{snapshot};
+        snapshot = EventData::EventSnapshot{};
+        EXPECT_EQ(snapshot.get_evt_count(), 0) << "Default snapshot not empty.";
+
+        std::size_t visited{0};
+        bool matches{true};
+        copy.for_each_evt(0, CHUNK + 100, [&](std::size_t index, const EventData::EventDatum &evt) {
+            matches = matches && index == visited && evt.x == 1 && evt.y == static_cast<int32_t>(index % 480) &&
+                      evt.timestamp == static_cast<int64_t>(index) * 2 && evt.polarity == index % 2;
+            ++visited;
+        });
+        EXPECT_EQ(visited, CHUNK + 100) << "Snapshot visited wrong number of events.";
+        EXPECT_TRUE(matches) << "Snapshot events changed after eviction and clear.";
+        EXPECT_EQ(copy.get_evt(CHUNK + 5).x, 1.0f) << "Snapshot event changed.";
+        EXPECT_EQ(copy.get_evt_relative_time(CHUNK + 99), static_cast<int64_t>(CHUNK + 99) * 2)
+            << "Snapshot time mismatch.";
+        EXPECT_EQ(copy.get_event_index_from_relative_timestamp(2001), 1001) << "Snapshot lookup mismatch.";
+        EXPECT_EQ(test_ed.get_evt(CHUNK + 5).x, 7.0f) << "Data written after the clear mismatch.";
+    }
+}
+
+// Test IMU samples and triggers are placed on the event timeline, queried by time and interpolated
+TEST(EventData, ImuAndTriggers)
+{
+    EventData test_ed{};
+    std::vector<EventData::ImuDatum> imu_evts{};
+    for (int64_t i{0}; i < 100; ++i)
+    {
+        float value{static_cast<float>(i)};
+        imu_evts.push_back(EventData::ImuDatum{.timestamp = 5000 + i * 1000,
+                                               .sample = {.accelerometer = glm::vec3{value, 0.0f, 1.0f},
+                                                          .gyroscope = glm::vec3{0.0f, 2.0f * value, 0.0f},
+                                                          .temperature = 30.0f}});
+    }
+
+    // Nothing to align samples to before the first event
+    test_ed.write_imu_data_batch(imu_evts);
+    EXPECT_TRUE(test_ed.get_imu_store_ref().empty()) << "Samples stored before any event.";
+    EXPECT_FALSE(test_ed.get_imu_at_relative_timestamp(0).has_value()) << "Interpolated without samples.";
+
+    test_ed.write_evt_data(EventData::EventDatum{.x = 1, .y = 1, .timestamp = 5000, .polarity = 1});
+    test_ed.write_imu_data_batch(imu_evts);
+    ASSERT_EQ(test_ed.get_imu_store_ref().size(), 100) << "IMU sample count mismatch.";
+    EXPECT_EQ(test_ed.get_imu_store_ref().time(10), 10000) << "IMU sample not on the event timeline.";
+
+    auto [first, last] = test_ed.get_imu_index_range_from_relative_timestamps(10000, 20000);
+    EXPECT_EQ(first, 10) << "IMU range start mismatch.";
+    EXPECT_EQ(last, 20) << "IMU range end mismatch.";
+
+    std::optional<EventData::ImuSample> sample{test_ed.get_imu_at_relative_timestamp(42250)};
+    ASSERT_TRUE(sample.has_value()) << "No interpolated sample.";
+    EXPECT_FLOAT_EQ(sample->accelerometer.x, 42.25f) << "Accelerometer not interpolated.";
+    EXPECT_FLOAT_EQ(sample->gyroscope.y, 84.5f) << "Gyroscope not interpolated.";
+    EXPECT_FLOAT_EQ(sample->temperature, 30.0f) << "Temperature mismatch.";
+    EXPECT_FLOAT_EQ(test_ed.get_imu_at_relative_timestamp(-100)->accelerometer.x, 0.0f) << "Not clamped to first.";
+    EXPECT_FLOAT_EQ(test_ed.get_imu_at_relative_timestamp(1 << 30)->accelerometer.x, 99.0f) << "Not clamped to last.";
+
+    // Triggers older than the newest stored one are dropped
+    std::vector<EventData::TriggerDatum> triggers{{.timestamp = 6000, .type = 2},
+                                                  {.timestamp = 9000, .type = 3},
+                                                  {.timestamp = 8000, .type = 2},
+                                                  {.timestamp = 9000, .type = 4}};
+    test_ed.write_trigger_data_batch(triggers);
+    const EventData::SampleStore<uint8_t> &trigger_store{test_ed.get_trigger_store_ref()};
+    ASSERT_EQ(trigger_store.size(), 3) << "Out of order trigger stored.";
+    EXPECT_EQ(trigger_store[2], 4) << "Trigger type mismatch.";
+    auto [trigger_first, trigger_last] = test_ed.get_trigger_index_range_from_relative_timestamps(4000, 4001);
+    EXPECT_EQ(trigger_first, 1) << "Trigger range start mismatch.";
+    EXPECT_EQ(trigger_last, 3) << "Trigger range end mismatch.";
+
+    test_ed.clear();
+    EXPECT_TRUE(test_ed.get_imu_store_ref().empty()) << "IMU samples not cleared.";
+    EXPECT_TRUE(test_ed.get_trigger_store_ref().empty()) << "Triggers not cleared.";
+}
+
+// Test the polarity index streams visit exactly the events of one polarity, also after eviction
+TEST(EventData, PolarityIndex)
+{
+    constexpr std::size_t CHUNK{EventData::MappedEventBuffer<EventData::PackedEvent>::kChunkCapacity};
+    std::vector<EventData::EventDatum> evts{};
+    for (std::size_t i{0}; i < CHUNK * 3 + 500; ++i)
+    {
+        evts.push_back(EventData::EventDatum{.x = static_cast<int32_t>(i % 640), .y = 1,
+                                             .timestamp = static_cast<int64_t>(i),
+                                             .polarity = static_cast<uint8_t>((i * 7) % 3 == 0)});
+    }
+
+    EventData test_ed{};
+    test_ed.set_evt_format(EventData::EventFormat::PACKED);
+    test_ed.set_evt_retention(EventData::RetentionMode::EVENTS, static_cast<int64_t>(CHUNK));
+    test_ed.write_evt_data_batch(evts);
+    EventData::EventView view{test_ed.get_evt_view()};
+    ASSERT_GT(view.begin_index, 0) << "Expected eviction.";
+
+    for (auto [first, last] : {std::pair<std::size_t, std::size_t>{0, CHUNK * 4},
+                               std::pair<std::size_t, std::size_t>{view.begin_index + 1000, view.begin_index + 1257},
+                               std::pair<std::size_t, std::size_t>{view.end_index - 3, view.end_index}})
+    {
+        for (uint8_t polarity : {uint8_t{0}, uint8_t{1}})
+        {
+            std::vector<std::size_t> expected{};
+            for (std::size_t i{std::max(first, view.begin_index)}; i < std::min(last, view.end_index); ++i)
+            {
+                if (evts[i].polarity == polarity)
+                {
+                    expected.push_back(i);
+                }
+            }
+            std::vector<std::size_t> visited{};
+            test_ed.for_each_polarity_evt(polarity, first, last, [&](std::size_t index) { visited.push_back(index); });
+            EXPECT_EQ(visited, expected) << "Polarity " << static_cast<int>(polarity) << " indices mismatch.";
+        }
+    }
+
+    std::vector<std::byte> gathered{};
+    const std::size_t first{view.begin_index + 10};
+    std::size_t count{test_ed.gather_polarity_evts(1, first, first + 30, test_ed.get_evt_time_base(first), gathered)};
+    EXPECT_EQ(count, 10) << "Gathered positive event count mismatch.";
+    EventData::PackedEvent packed{};
+    std::memcpy(&packed, gathered.data(), sizeof(packed));
+    EXPECT_NE(packed.time_polarity & EventData::kPackedPolarityBit, 0) << "Gathered a negative event.";
+}
+
+// Test a fixed time origin keeping relative timestamps across clears, and evicting decoded data by time
+TEST(EventData, TimeOriginAndEviction)
+{
+    constexpr std::size_t CHUNK{EventData::MappedEventBuffer<EventData::PackedEvent>::kChunkCapacity};
+    std::vector<EventData::EventDatum> evts{};
+    for (std::size_t i{0}; i < CHUNK * 3; ++i)
+    {
+        evts.push_back(EventData::EventDatum{.x = 1, .y = 1, .timestamp = 5000 + static_cast<int64_t>(i),
+                                             .polarity = 1});
+    }
+
+    EventData test_ed{};
+    test_ed.set_evt_format(EventData::EventFormat::PACKED);
+    test_ed.set_evt_time_origin(1000);
+    test_ed.write_evt_data_batch(evts);
+    EXPECT_EQ(test_ed.get_earliest_evt_timestamp(), 1000) << "Relative timestamps do not count from the origin.";
+    EXPECT_EQ(test_ed.get_evt_relative_time(0), 4000) << "Relative timestamp of first event mismatch.";
+
+    // Nothing older than the second chunk, only the first chunk goes
+    test_ed.evict_evts_before(4000 + static_cast<int64_t>(CHUNK) + 10);
+    EXPECT_EQ(test_ed.get_evt_begin_index(), CHUNK) << "Expected exactly one evicted chunk.";
+    EXPECT_EQ(test_ed.get_evt_relative_time(CHUNK), 4000 + static_cast<int64_t>(CHUNK))
+        << "Relative timestamps changed on eviction.";
+    test_ed.evict_evts_before(std::numeric_limits<int64_t>::max());
+    EXPECT_EQ(test_ed.get_evt_begin_index(), CHUNK * 2) << "The chunk being written was evicted.";
+
+    // Decoding a later piece again after a clear lands on the same relative timestamps
+    test_ed.clear();
+    EXPECT_EQ(test_ed.get_evt_time_origin(), -1) << "Clear did not reset the time origin.";
+    test_ed.set_evt_time_origin(1000);
+    test_ed.write_evt_data_batch(std::span<const EventData::EventDatum>{evts}.subspan(CHUNK));
+    EXPECT_EQ(test_ed.get_evt_relative_time(0), 4000 + static_cast<int64_t>(CHUNK))
+        << "Relative timestamps changed across a clear.";
+
+    // Decoding from an hour into a session counts events from there
+    constexpr int64_t HOUR{3'600'000'000};
+    for (EventData::EventDatum &evt : evts)
+    {
+        evt.timestamp += HOUR;
+    }
+    test_ed.clear();
+    test_ed.set_evt_time_origin(5000);
+    test_ed.write_evt_data_batch(evts);
+    ASSERT_EQ(test_ed.get_evt_relative_time(0), HOUR) << "Relative timestamp of first event mismatch.";
+    EXPECT_EQ(test_ed.get_evt_polarity_counts(HOUR, HOUR + static_cast<int64_t>(CHUNK * 3)),
+              (EventData::PolarityCounts{0, CHUNK * 3}))
+        << "Polarity counts mismatch after decoding from late in the session.";
+}
+
+// Test a ring handing items from one thread to another in order, refusing pushes when full and pops when empty
+TEST(SpscRing, OrderAcrossThreads)
+{
+    SpscRing<std::size_t> ring{5};
+    EXPECT_EQ(ring.capacity(), 8) << "Capacity not rounded up to a power of two.";
+    std::size_t item{0};
+    EXPECT_FALSE(ring.try_pop(item)) << "Popped from an empty ring.";
+    for (std::size_t i{0}; i < ring.capacity(); ++i)
+    {
+        EXPECT_TRUE(ring.try_push(std::size_t{i})) << "Push refused before the ring was full.";
+    }
+    EXPECT_FALSE(ring.try_push(std::size_t{0})) << "Pushed to a full ring.";
+    EXPECT_EQ(ring.size(), ring.capacity()) << "Size of a full ring mismatch.";
+    while (ring.try_pop(item))
+    {
+    }
+    EXPECT_TRUE(ring.empty()) << "Ring not empty after popping everything.";
+
+    constexpr std::size_t NUM_ITEMS{1 << 18};
+    std::thread producer{[&ring] {
+        for (std::size_t i{0}; i < NUM_ITEMS; ++i)
+        {
+            while (!ring.try_push(std::size_t{i}))
+            {
+                std::this_thread::yield();
+            }
+        }
+    }};
+    std::size_t expected{0};
+    bool in_order{true};
+    while (expected < NUM_ITEMS)
+    {
+        if (ring.try_pop(item))
+        {
+            in_order = in_order && item == expected;
+            ++expected;
+        }
+    }
+    producer.join();
+    EXPECT_TRUE(in_order) << "Items popped out of order.";
+    EXPECT_TRUE(ring.empty()) << "Ring not empty after popping everything.";
+}
+
 // Testing methods of ParameterStore
 TEST(ParameterStore, add_get_exists)
 {